@@ -51,6 +51,11 @@ CMD_ID_GET_DIAG_DATA		= 0x002D
 CMD_ID_GET_DEVICE_INT_SN	= 0x0038
 CMD_ID_SET_DEVICE_INT_SN	= 0x003A
 CMD_ID_PREPARE_SN_FLASH		= 0x003D
+CMD_ID_BUNDLE_WRITE_STREAM	= 0x0043
+CMD_ID_START_BUNDLE_DELTA	= 0x0044
+CMD_ID_GET_BUNDLE_BLK_CRCS	= 0x0045
+CMD_ID_ERASE_BUNDLE_BLOCK	= 0x0046
+CMD_ID_GET_FILE_STREAM		= 0x0047
 
 # New Debug Command IDs
 CMD_DBG_MESSAGE					= 0x8000
@@ -70,6 +75,22 @@ HID_CMD_ID_GET_BATTERY_STATUS   = 0x800D
 HID_CMD_ID_FLASH_AUX_AND_MAIN   = 0x800E
 HID_CMD_ID_GET_PLAT_TIME        = 0x800F
 CMD_DBG_FLASH_PLAT_UNIQUE_DATA	= 0x8010
+CMD_DBG_DATAFLASH_WRITE_STREAM	= 0x8013
+
+# Bundle streaming
+BUNDLE_STREAM_FLAG_ACK_REQ		= 0x0001
+BUNDLE_STREAM_WINDOW_SIZE		= 16
+BUNDLE_STREAM_MAX_TIMEOUTS		= 10
+
+# Delta bundle update
+BUNDLE_BLOCK_SIZE				= 65536
+BUNDLE_NB_BLOCKS_PER_CRC_REQ	= 8
+
+# File streaming export
+FILE_STREAM_REQ_FLAG_NOTE		= 0x0001
+FILE_STREAM_FLAG_LAST			= 0x0001
+FILE_STREAM_FLAG_ERROR			= 0x0002
+FILE_STREAM_BURST_LENGTH		= 8
 
 # OLD Command IDs
 CMD_EXPORT_FLASH_START  = 0x8A
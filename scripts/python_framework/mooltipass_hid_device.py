@@ -8,6 +8,7 @@ from pprint import pprint
 from array import array
 from PIL import Image
 import struct
+import zlib
 import random
 import time
 import glob
@@ -197,8 +198,158 @@ class mooltipass_hid_device:
 				# No modifications, sleep
 				time.sleep(0.2)
 				
+	# Stream a bundle file to the device as sequence numbered 256B chunks
+	def streamBundleFile(self, bundlefile, command):
+		start_time = time.time()
+		bundle_data = bundlefile.read()
+		if not self.streamBundleData(bundle_data, command, 0, len(bundle_data)):
+			return False
+		elapsed_time = max(time.time() - start_time, 0.001)
+		print(str(len(bundle_data)) + " bytes sent in " + str(int(elapsed_time*1000)) + "ms, " + str(int(len(bundle_data)/elapsed_time)) + " bytes per second")
+		return True
+		
+	# Stream bundle_data[start_address:end_address] as sequence numbered 256B chunks, chunk N being written at N*256
+	# Up to BUNDLE_STREAM_WINDOW_SIZE chunks are in flight, the device acknowledges cumulatively (next expected sequence number)
+	# On a reported sequence gap or an acknowledgement timeout, we resend from the last acknowledged chunk
+	def streamBundleData(self, bundle_data, command, start_address, end_address):
+		first_seq = int(start_address / 256)
+		end_seq = int((end_address + 255) / 256)
+		nb_chunks = end_seq - first_seq
+		
+		# Stream state
+		next_seq_to_send = first_seq
+		acked_seq = first_seq
+		nb_timeouts = 0
+		last_pct = 0
+		
+		while acked_seq < end_seq:
+			# Fill the window
+			window_end = min(acked_seq + BUNDLE_STREAM_WINDOW_SIZE, end_seq)
+			while next_seq_to_send < window_end:
+				flags = 0
+				if next_seq_to_send == window_end - 1:
+					flags |= BUNDLE_STREAM_FLAG_ACK_REQ
+				packet_to_send = self.getPacketForCommand(command, None)
+				packet_to_send["data"].frombytes(struct.pack('HH', next_seq_to_send, flags))
+				packet_to_send["data"].frombytes(bundle_data[next_seq_to_send*256:min(next_seq_to_send*256+256, end_address)])
+				packet_to_send["len"] = array('B')
+				packet_to_send["len"].frombytes(struct.pack('H', len(packet_to_send["data"])))
+				self.device.sendHidMessage(packet_to_send)
+				if self.device.ack_flag_in_comms:
+					self.device.receiveHidPacket(True)
+				next_seq_to_send += 1
+				
+			# Wait for an acknowledgement
+			answer = self.device.receiveHidMessage(False)
+			if answer is None or answer is True:
+				# Timeout or please retry: go back to the last acknowledged chunk
+				nb_timeouts += 1
+				if nb_timeouts > BUNDLE_STREAM_MAX_TIMEOUTS:
+					print("Device stopped acknowledging bundle chunks")
+					return False
+				if answer is True:
+					time.sleep(1)
+				next_seq_to_send = acked_seq
+				continue
+			if answer["cmd"] != command:
+				# Status messages and the likes
+				continue
+			if answer["len"] == 1:
+				print("Device refused bundle chunk")
+				return False
+				
+			# Cumulative acknowledgement
+			nb_timeouts = 0
+			next_expected_seq, gap_detected = struct.unpack('HH', answer["data"][0:4])
+			acked_seq = max(acked_seq, next_expected_seq)
+			if gap_detected != 0:
+				print("Sequence gap reported, resending from chunk " + str(acked_seq))
+				next_seq_to_send = acked_seq
+				
+			# Progress
+			pct = int((acked_seq - first_seq) * 100 / nb_chunks)
+			if pct >= last_pct + 25:
+				last_pct = pct - (pct % 25)
+				print(str(last_pct) + "%")
+		
+		return True
+		
+	# Delta bundle update: only erase and rewrite the 64KB blocks whose crc32 differs from the device's
+	# The bootloader still checks the complete bundle crc32 & signature before accepting it
+	def streamBundleDelta(self, bundlefile):
+		start_time = time.time()
+		bundle_data = bundlefile.read()
+		nb_blocks = int((len(bundle_data) + BUNDLE_BLOCK_SIZE - 1) / BUNDLE_BLOCK_SIZE)
+		
+		# Fetch the device block crc32s
+		device_crcs = []
+		while len(device_crcs) < nb_blocks:
+			nb_blocks_to_request = min(BUNDLE_NB_BLOCKS_PER_CRC_REQ, nb_blocks - len(device_crcs))
+			answer = self.device.sendHidMessageWaitForAck(self.getPacketForCommand(CMD_ID_GET_BUNDLE_BLK_CRCS, struct.pack('HH', len(device_crcs), nb_blocks_to_request)))
+			if answer["len"] == 1:
+				print("Couldn't fetch block crc32s")
+				return False
+			device_crcs.extend(struct.unpack('I'*nb_blocks_to_request, answer["data"][4:4+4*nb_blocks_to_request]))
+			
+		# Compare with ours: flash is erased to 0xFF after the bundle end
+		blocks_to_update = []
+		for block_id in range(0, nb_blocks):
+			block_data = bundle_data[block_id*BUNDLE_BLOCK_SIZE:(block_id+1)*BUNDLE_BLOCK_SIZE]
+			block_data += b'\xff' * (BUNDLE_BLOCK_SIZE - len(block_data))
+			if zlib.crc32(block_data) & 0xFFFFFFFF != device_crcs[block_id]:
+				blocks_to_update.append(block_id)
+		print(str(len(blocks_to_update)) + " block(s) out of " + str(nb_blocks) + " to update")
+		
+		# Erase and rewrite the differing blocks
+		for block_id in blocks_to_update:
+			if self.device.sendHidMessageWaitForAck(self.getPacketForCommand(CMD_ID_ERASE_BUNDLE_BLOCK, struct.pack('H', block_id)))["data"][0] != CMD_HID_ACK:
+				print("Couldn't erase block " + str(block_id))
+				return False
+			if not self.streamBundleData(bundle_data, CMD_ID_BUNDLE_WRITE_STREAM, block_id*BUNDLE_BLOCK_SIZE, min((block_id+1)*BUNDLE_BLOCK_SIZE, len(bundle_data))):
+				return False
+				
+		print("Delta update done in " + str(int((time.time()-start_time)*1000)) + "ms")
+		return True
+	
+	# Export a file (or a note) using the streaming export: the device sends bursts of full chunks
+	# Each request acknowledges all the chunks received so far and asks for the next burst
+	def exportFileStream(self, service, is_note=False):
+		start_time = time.time()
+		flags = FILE_STREAM_REQ_FLAG_NOTE if is_note else 0
+		packet_to_send = self.getPacketForCommand(CMD_ID_GET_FILE_STREAM, struct.pack('HH', 0, flags) + service.encode('utf-16le') + b'\x00\x00')
+		file_data = b''
+		next_seq = 0
+		
+		while True:
+			self.device.sendHidMessage(packet_to_send)
+			if self.device.ack_flag_in_comms:
+				self.device.receiveHidPacket(True)
+				
+			# Receive the burst (or less chunks if the device had to stop)
+			burst_end_seq = next_seq + FILE_STREAM_BURST_LENGTH
+			while next_seq < burst_end_seq:
+				answer = self.device.receiveHidMessage(False)
+				if answer is None or answer is True:
+					break
+				if answer["cmd"] != CMD_ID_GET_FILE_STREAM:
+					# Status messages and the likes
+					continue
+				seq, chunk_flags = struct.unpack('HH', answer["data"][0:4])
+				if chunk_flags & FILE_STREAM_FLAG_ERROR or seq != next_seq:
+					print("Export aborted by the device")
+					return None
+				file_data += answer["data"][4:answer["len"]].tobytes()
+				next_seq += 1
+				if chunk_flags & FILE_STREAM_FLAG_LAST:
+					elapsed_time = max(time.time() - start_time, 0.001)
+					print(str(len(file_data)) + " bytes received in " + str(int(elapsed_time*1000)) + "ms")
+					return file_data
+					
+			# Acknowledge and request the next burst
+			packet_to_send = self.getPacketForCommand(CMD_ID_GET_FILE_STREAM, struct.pack('HH', next_seq, 0))
+			
 	# Send and update platform
-	def uploadAndUpgradePlatform(self, filename, password):
+	def uploadAndUpgradePlatform(self, filename, password, delta_update=False):
 		# Check for file
 		if not isfile(filename):
 			print("File \"" + filename + "\" does not exist")
@@ -216,62 +367,23 @@ class mooltipass_hid_device:
 		# Send erase dataflash command to usb
 		start_time = time.time()
 		print("Sending start upload command..")
-		if self.device.sendHidMessageWaitForAck(self.getPacketForCommand(CMD_ID_START_BUNDLE_UL, password))["data"][0] == CMD_HID_ACK:
+		start_command = CMD_ID_START_BUNDLE_UL
+		if delta_update:
+			start_command = CMD_ID_START_BUNDLE_DELTA
+		if self.device.sendHidMessageWaitForAck(self.getPacketForCommand(start_command, password))["data"][0] == CMD_HID_ACK:
 			print("Password accepted, starting upload...")
 		else:
 			print("Incorrect password")
 			return False
 		
-		# First 4 bytes: address for writing, start reading bytes
-		byte = bundlefile.read(1)
-		current_ts = int(time.time())
-		number_of_packets_last_second = 0
-		current_address = 0
-		bytecounter = 4
-		
-		# Prepare first packet to send
-		packet_to_send = self.getPacketForCommand(CMD_ID_WRITE_BUNDLE_256B, None)
-		packet_to_send["data"].frombytes(struct.pack('I', current_address))
-		
-		# While we haven't finished looping through the bytes
-		while len(byte) != 0:
-			# Add byte to current packet
-			packet_to_send["data"].append(struct.unpack('B', byte)[0])
-			# Increment byte counter
-			bytecounter = bytecounter + 1
-			# Read new byte
-			byte = bundlefile.read(1)
-			# If packet full, send it
-			if bytecounter == 256+4:
-				# Set correct payload size and send packet
-				packet_to_send["len"] = array('B')
-				packet_to_send["len"].frombytes(struct.pack('H', bytecounter))
-				self.device.sendHidMessageWaitForAck(packet_to_send)
-				number_of_packets_last_second += 1
-				# Reset byte counter, increment address
-				current_address += 256
-				bytecounter = 4
-				# Prepare new packet to send
-				packet_to_send = self.getPacketForCommand(CMD_ID_WRITE_BUNDLE_256B, None)
-				packet_to_send["data"].frombytes(struct.pack('I', current_address))
-				# Progress counter
-				if current_address == 262144:
-					print("25%")
-				elif current_address == 262144*2:
-					print("50%")
-				elif current_address == 262144*3:
-					print("75%")
-			# Upload stats
-			if int(time.time()) != current_ts:
-				print(str(number_of_packets_last_second*256) + " bytes per second")
-				number_of_packets_last_second = 0
-				current_ts = int(time.time())
-					
-		# Send the remaining bytes if needed
-		if bytecounter != 4 + 0:
-			packet_to_send["len"] = array('B')
-			packet_to_send["len"].frombytes(struct.pack('H', bytecounter))
-			self.device.sendHidMessageWaitForAck(packet_to_send)
+		# Stream bundle contents, or only the blocks that changed
+		if delta_update:
+			upload_result = self.streamBundleDelta(bundlefile)
+		else:
+			upload_result = self.streamBundleFile(bundlefile, CMD_ID_BUNDLE_WRITE_STREAM)
+		if not upload_result:
+			bundlefile.close()
+			return False
 		
 		# Let the device know we're done
 		print("Bundle upload done!")
@@ -324,43 +436,10 @@ class mooltipass_hid_device:
 		print("Erase done in " + str(int((time.time()-start_time)*1000)) + "ms")
 		print("Sending bundle data...")
 		
-		# First 4 bytes: address for writing, start reading bytes
-		byte = bundlefile.read(1)
-		current_address = 0
-		bytecounter = 4
-		
-		# Prepare first packet to send
-		packet_to_send = self.getPacketForCommand(CMD_DBG_DATAFLASH_WRITE_256B, None)
-		packet_to_send["data"].frombytes(struct.pack('I', current_address))
-		
-		# While we haven't finished looping through the bytes
-		while byte != b'':
-			# Add byte to current packet
-			packet_to_send["data"].append(struct.unpack('B', byte)[0])
-			# Increment byte counter
-			bytecounter = bytecounter + 1
-			# Read new byte
-			byte = bundlefile.read(1)
-			# If packet full, send it
-			if bytecounter == 256+4:
-				# Set correct payload size and send packet
-				packet_to_send["len"] = array('B')
-				packet_to_send["len"].frombytes(struct.pack('H', bytecounter))
-				self.device.sendHidMessageWaitForAck(packet_to_send)
-				# Reset byte counter, increment address
-				current_address += 256
-				bytecounter = 4
-				# Prepare new packet to send
-				packet_to_send = self.getPacketForCommand(CMD_DBG_DATAFLASH_WRITE_256B, None)
-				packet_to_send["data"].frombytes(struct.pack('I', current_address))
-				# Leave enough time for flash to burn bytes
-				time.sleep(0.002)
-					
-		# Send the remaining bytes
-		if bytecounter != 4:
-			packet_to_send["len"] = array('B')
-			packet_to_send["len"].frombytes(struct.pack('H', bytecounter))
-			self.device.sendHidMessageWaitForAck(packet_to_send)
+		# Stream bundle contents
+		if not self.streamBundleFile(bundlefile, CMD_DBG_DATAFLASH_WRITE_STREAM):
+			bundlefile.close()
+			return
 		
 		# Let the device know to reindex bundle
 		print("Letting the device know to reindex bundle...")
@@ -270,50 +270,10 @@ void comms_main_mcu_deal_with_non_usb_non_ble_message(aux_mcu_message_t* message
         /* This command may take a while... let's use our other buffer to prevent corruptions */
         memcpy((void*)&comms_main_mcu_message_for_main_replies, message, sizeof(comms_main_mcu_message_for_main_replies));
         
-        /* Iterate over symbols */
-        uint16_t counter = 0;
-        while(comms_main_mcu_message_for_main_replies.keyboard_type_message.keyboard_symbols[counter] != 0)
+        /* Type all symbols */
+        if (logic_keyboard_type_symbols((hid_interface_te)comms_main_mcu_message_for_main_replies.keyboard_type_message.interface_identifier, comms_main_mcu_message_for_main_replies.keyboard_type_message.keyboard_symbols, MEMBER_ARRAY_SIZE(keyboard_type_message_t, keyboard_symbols), comms_main_mcu_message_for_main_replies.keyboard_type_message.delay_between_types) != RETURN_OK)
         {
-            uint16_t symbol = comms_main_mcu_message_for_main_replies.keyboard_type_message.keyboard_symbols[counter];
-            
-            if (symbol == 0xFFFF)
-            {
-                /* Original unicode point can't be typed */
-            }            
-            else if ((symbol & 0x7F00) == 0)
-            {
-                BOOL is_dead_key = FALSE;
-                
-                /* Check for dead key */
-                if ((symbol & 0x8000) != 0)
-                {
-                    is_dead_key = TRUE;
-                }                    
-                
-                /* One key to be typed */
-                if (logic_keyboard_type_symbol((hid_interface_te)comms_main_mcu_message_for_main_replies.keyboard_type_message.interface_identifier, (uint8_t)symbol, is_dead_key, comms_main_mcu_message_for_main_replies.keyboard_type_message.delay_between_types) != RETURN_OK)
-                {
-                    typing_success_bool = FALSE;
-                    break;
-                }
-            }
-            else
-            {
-                /* Two keys to be typed */
-                if (logic_keyboard_type_symbol((hid_interface_te)comms_main_mcu_message_for_main_replies.keyboard_type_message.interface_identifier, (uint8_t)(symbol >> 8), FALSE, comms_main_mcu_message_for_main_replies.keyboard_type_message.delay_between_types) != RETURN_OK)
-                {
-                    typing_success_bool = FALSE;
-                    break;
-                }
-                if (logic_keyboard_type_symbol((hid_interface_te)comms_main_mcu_message_for_main_replies.keyboard_type_message.interface_identifier, (uint8_t)symbol, FALSE, comms_main_mcu_message_for_main_replies.keyboard_type_message.delay_between_types) != RETURN_OK)
-                {
-                    typing_success_bool = FALSE;
-                    break;
-                }
-            }
-            
-            /* Move on to the next symbol */
-            counter++;
+            typing_success_bool = FALSE;
         }
             
         /* Send success status */
@@ -776,20 +736,38 @@ ret_type_te comms_main_mcu_routine(BOOL wait_for_blectrl_fido2_rng, uint16_t exp
         /* Set bool and do necessary action: no point in setting the bool after the function call as the dma receiver will overwrite the packet anyways */
         dma_main_mcu_usb_msg_received = FALSE;
         
+        /* Fetch flag before the buffer gets overwritten by the next message */
+        BOOL main_mcu_wants_sent_notif = (dma_main_mcu_usb_rcv_message.tx_sent_notif_req_flag != 0)?TRUE:FALSE;
+        
         if (comms_main_mcu_usb_msg_answered_using_first_bytes == FALSE)
         {
             comms_raw_hid_send_hid_message(USB_INTERFACE, (aux_mcu_message_t*)&dma_main_mcu_usb_rcv_message);
         }
+        
+        /* Main MCU wants to know when it can send its next message */
+        if (main_mcu_wants_sent_notif != FALSE)
+        {
+            comms_main_mcu_send_simple_event(AUX_MCU_EVENT_HID_MSG_SENT);
+        }
     }
     if (dma_main_mcu_ble_msg_received != FALSE)
     {
         /* Set bool and do necessary action: no point in setting the bool after the function call as the dma receiver will overwrite the packet anyways */
         dma_main_mcu_ble_msg_received = FALSE;
         
+        /* Fetch flag before the buffer gets overwritten by the next message */
+        BOOL main_mcu_wants_sent_notif = (dma_main_mcu_ble_rcv_message.tx_sent_notif_req_flag != 0)?TRUE:FALSE;
+        
         if (comms_main_mcu_ble_msg_answered_using_first_bytes == FALSE)
         {
             comms_raw_hid_send_hid_message(BLE_INTERFACE, (aux_mcu_message_t*)&dma_main_mcu_ble_rcv_message);
         }
+        
+        /* Main MCU wants to know when it can send its next message */
+        if (main_mcu_wants_sent_notif != FALSE)
+        {
+            comms_main_mcu_send_simple_event(AUX_MCU_EVENT_HID_MSG_SENT);
+        }
     }
     if (dma_main_mcu_fido_blectrl_rng_msg_received != FALSE)
     {
@@ -19,7 +19,7 @@
 
 /* USB comms buffers */
 static hid_packet_t raw_hid_recv_buffer[NB_HID_INTERFACES];
-static hid_packet_t raw_hid_send_buffer[NB_HID_INTERFACES];
+static raw_hid_tx_ring_t raw_hid_tx_rings[NB_HID_INTERFACES];
 /* Future message to be sent to MCU */
 aux_mcu_message_t comms_raw_hid_temp_mcu_message_to_send[NB_HID_INTERFACES];
 /* Packet number we're expecting to receive */
@@ -127,16 +127,6 @@ uint8_t* comms_raw_hid_get_recv_buffer(hid_interface_te hid_interface)
     return (uint8_t*)&(raw_hid_recv_buffer[hid_interface]);
 }
 
-/*! \fn     comms_raw_hid_get_send_buffer(hid_interface_te hid_interface)
-*   \brief  Get the pointer to a send buffer
-*   \param  hid_interface   HID interface
-*   \return Pointer to the send buffer
-*/
-hid_packet_t* comms_raw_hid_get_send_buffer(hid_interface_te hid_interface)
-{
-    return &(raw_hid_send_buffer[hid_interface]);
-}
-
 /*! \fn     comms_raw_hid_recv_callback(hid_interface_te hid_interface, uint16_t recv_bytes)
 *   \brief  Function called when a HID packet is received
 *   \param  hid_interface   interface from which we received the packet
@@ -151,16 +141,6 @@ void comms_raw_hid_recv_callback(hid_interface_te hid_interface, uint16_t recv_b
     comms_raw_hid_packet_received[hid_interface] = TRUE;
 }
 
-/*! \fn     comms_raw_hid_send_callback(hid_interface_te hid_interface)
-*   \brief  Function called when a HID packet is sent
-*   \param  hid_interface   interface from which we received the packet
-*/
-void comms_raw_hid_send_callback(hid_interface_te hid_interface)
-{
-    /* Set flag */
-    comms_raw_hid_packet_being_sent[hid_interface] = FALSE;
-}
-
 /*! \fn     comms_raw_hid_arm_packet_receive(hid_interface_te hid_interface)
 *   \brief  Arm packet receive
 */
@@ -179,55 +159,135 @@ void comms_raw_hid_arm_packet_receive(hid_interface_te hid_interface)
     }
 }
 
-/*! \fn     comms_raw_hid_send_packet(hid_interface_te hid_interface, hid_packet_t* packet, BOOL wait_send, uint16_t payload_size)
-*   \brief  send raw hid packet
-*   \param  hid_interface   HID interface on which to send the packet
-*   \param  packet          Packet to send (must be 4 bytes aligned!)
-*   \param  wait_send       Set to wait for end of packet transmission
-*   \param  payload_size    Payload size
+/*! \fn     comms_raw_hid_start_tx_ring_packet_send(hid_interface_te hid_interface)
+*   \brief  Start sending the packet at the head of the TX ring if the interface is idle
+*   \param  hid_interface   HID interface
+*   \note   Called from the main loop & from the USB send complete interrupt
 */
-void comms_raw_hid_send_packet(hid_interface_te hid_interface, hid_packet_t* packet, BOOL wait_send, uint16_t payload_size)
+static void comms_raw_hid_start_tx_ring_packet_send(hid_interface_te hid_interface)
 {
-    /* Wait for possible previous packet to be sent */
+    raw_hid_tx_ring_t* tx_ring_pt = &raw_hid_tx_rings[hid_interface];
+    BOOL should_send_packet = FALSE;
+    
+    /* BLE: wait for possible unrelated notification to be sent, before claiming the interface as the wait processes BLE events */
+    if ((hid_interface == BLE_INTERFACE) && (comms_raw_hid_packet_being_sent[hid_interface] == FALSE) && (tx_ring_pt->nb_packets != 0))
+    {
+        logic_bluetooth_check_and_wait_for_notif_sent();
+    }
+    
+    /* Interface is ours if it is idle and we have something to send */
+    cpu_irq_enter_critical();
+    if ((comms_raw_hid_packet_being_sent[hid_interface] == FALSE) && (tx_ring_pt->nb_packets != 0))
+    {
+        comms_raw_hid_packet_being_sent[hid_interface] = TRUE;
+        should_send_packet = TRUE;
+    }
+    cpu_irq_leave_critical();
+    
+    if (should_send_packet == FALSE)
+    {
+        return;
+    }
+    
+    /* Send packet */
+    hid_packet_t* packet_pt = &tx_ring_pt->packets[tx_ring_pt->read_index];
+    uint16_t payload_size = tx_ring_pt->packet_sizes[tx_ring_pt->read_index];
     if (hid_interface == USB_INTERFACE)
     {
-        timer_start_timer(TIMER_USB_SEND_TIMEOUT, 500);
+        usb_send(USB_RAWHID_RX_ENDPOINT, (uint8_t*)packet_pt, payload_size);
     }
     else if (hid_interface == CTAP_INTERFACE)
     {
-        timer_start_timer(TIMER_USB_SEND_TIMEOUT, 100);
+        usb_send(USB_CTAP_RX_ENDPOINT, (uint8_t*)packet_pt, payload_size);
+    }
+    else
+    {
+        /* Will call comms_raw_hid_send_callback directly if not connected */
+        logic_bluetooth_raw_send((uint8_t*)packet_pt, payload_size);
     }
+}
+
+/*! \fn     comms_raw_hid_flush_tx_ring(hid_interface_te hid_interface)
+*   \brief  Drop all the packets queued for a given interface
+*   \param  hid_interface   HID interface
+*/
+static void comms_raw_hid_flush_tx_ring(hid_interface_te hid_interface)
+{
+    cpu_irq_enter_critical();
+    raw_hid_tx_rings[hid_interface].read_index = raw_hid_tx_rings[hid_interface].write_index;
+    raw_hid_tx_rings[hid_interface].nb_packets = 0;
+    comms_raw_hid_packet_being_sent[hid_interface] = FALSE;
+    cpu_irq_leave_critical();
+}
+
+/*! \fn     comms_raw_hid_wait_for_tx_ring_level(hid_interface_te hid_interface, uint8_t max_nb_packets, uint16_t usb_timeout_ms)
+*   \brief  Wait for the number of packets queued for an interface to go down to a given level
+*   \param  hid_interface   HID interface
+*   \param  max_nb_packets  Maximum number of queued packets we want
+*   \param  usb_timeout_ms  Timeout for USB interfaces
+*   \return RETURN_OK, or RETURN_NOK if the queued packets were dropped (timeout, disconnection)
+*/
+static ret_type_te comms_raw_hid_wait_for_tx_ring_level(hid_interface_te hid_interface, uint8_t max_nb_packets, uint16_t usb_timeout_ms)
+{
+    timer_start_timer(TIMER_USB_SEND_TIMEOUT, usb_timeout_ms);
     timer_start_timer(TIMER_BT_TYPING_TIMEOUT, 3000);
-    while(comms_raw_hid_packet_being_sent[hid_interface] == TRUE)
+    
+    while (raw_hid_tx_rings[hid_interface].nb_packets > max_nb_packets)
     {
         if (hid_interface == BLE_INTERFACE)
         {
+            /* Bluetooth busy sending previous packet, BLE send completion doesn't refill the interface */
             ble_event_task();
+            comms_raw_hid_start_tx_ring_packet_send(hid_interface);
+            
+            /* Check for BLE timeout */
+            if (timer_has_timer_expired(TIMER_BT_TYPING_TIMEOUT, FALSE) == TIMER_EXPIRED)
+            {
+                comms_raw_hid_flush_tx_ring(hid_interface);
+                return RETURN_NOK;
+            }
         }
-        
-        /* Check for BLE timeout */
-        if ((hid_interface == BLE_INTERFACE) && (timer_has_timer_expired(TIMER_BT_TYPING_TIMEOUT, FALSE) == TIMER_EXPIRED))
-        {
-            comms_raw_hid_packet_being_sent[hid_interface] = FALSE;
-            return;
-        }
-        
-        /* Check for usb disconnection, or in some cases a timeout due to the computer not wanting to read the OUT endpoint (wtf...) */
-        if (((hid_interface == USB_INTERFACE) || (hid_interface == CTAP_INTERFACE)) && ((usb_get_config() == 0) || (udc_get_nb_ms_before_last_usb_activity() > 100) || (timer_has_timer_expired(TIMER_USB_SEND_TIMEOUT, TRUE) == TIMER_EXPIRED)))
+        else
         {
-            comms_raw_hid_packet_being_sent[hid_interface] = FALSE;
-            return;
+            /* Check for usb disconnection, or in some cases a timeout due to the computer not wanting to read the OUT endpoint (wtf...) */
+            if ((usb_get_config() == 0) || (udc_get_nb_ms_before_last_usb_activity() > 100) || (timer_has_timer_expired(TIMER_USB_SEND_TIMEOUT, TRUE) == TIMER_EXPIRED))
+            {
+                comms_raw_hid_flush_tx_ring(hid_interface);
+                return RETURN_NOK;
+            }
         }
     }
     
-    /* Wait for possible unrelated notification to be sent */
-    if (hid_interface == BLE_INTERFACE)
+    return RETURN_OK;
+}
+
+/*! \fn     comms_raw_hid_get_free_tx_ring_packet(hid_interface_te hid_interface, uint16_t usb_timeout_ms)
+*   \brief  Get a free packet buffer in an interface TX ring, waiting for one to be sent if needed
+*   \param  hid_interface   HID interface
+*   \param  usb_timeout_ms  Timeout for USB interfaces
+*   \return Pointer to the packet to fill, or 0 if the previous packets couldn't be sent
+*   \note   The packet is sent once committed with comms_raw_hid_commit_tx_ring_packet
+*/
+static hid_packet_t* comms_raw_hid_get_free_tx_ring_packet(hid_interface_te hid_interface, uint16_t usb_timeout_ms)
+{
+    raw_hid_tx_ring_t* tx_ring_pt = &raw_hid_tx_rings[hid_interface];
+    
+    if (comms_raw_hid_wait_for_tx_ring_level(hid_interface, RAW_HID_TX_RING_NB_PACKETS-1, usb_timeout_ms) != RETURN_OK)
     {
-        logic_bluetooth_check_and_wait_for_notif_sent();
+        return 0;
     }
     
-    /* Reset flag */
-    comms_raw_hid_packet_being_sent[hid_interface] = TRUE;
+    return &tx_ring_pt->packets[tx_ring_pt->write_index];
+}
+
+/*! \fn     comms_raw_hid_commit_tx_ring_packet(hid_interface_te hid_interface, uint16_t payload_size)
+*   \brief  Queue the packet returned by comms_raw_hid_get_free_tx_ring_packet and start sending it if the interface is idle
+*   \param  hid_interface   HID interface
+*   \param  payload_size    Payload size
+*/
+static void comms_raw_hid_commit_tx_ring_packet(hid_interface_te hid_interface, uint16_t payload_size)
+{
+    raw_hid_tx_ring_t* tx_ring_pt = &raw_hid_tx_rings[hid_interface];
     
     /* Check payload size parameter */
     if (payload_size > sizeof(hid_packet_t))
@@ -235,66 +295,92 @@ void comms_raw_hid_send_packet(hid_interface_te hid_interface, hid_packet_t* pac
         payload_size = sizeof(hid_packet_t);
     }
     
-    /* Send packet */
-    if (hid_interface == USB_INTERFACE)
+    /* Store packet size, then make the packet visible to the send complete interrupt */
+    tx_ring_pt->packet_sizes[tx_ring_pt->write_index] = payload_size;
+    cpu_irq_enter_critical();
+    tx_ring_pt->write_index = (tx_ring_pt->write_index + 1) % RAW_HID_TX_RING_NB_PACKETS;
+    tx_ring_pt->nb_packets++;
+    cpu_irq_leave_critical();
+    
+    comms_raw_hid_start_tx_ring_packet_send(hid_interface);
+}
+
+/*! \fn     comms_raw_hid_send_callback(hid_interface_te hid_interface)
+*   \brief  Function called when a HID packet is sent
+*   \param  hid_interface   interface from which we received the packet
+*/
+void comms_raw_hid_send_callback(hid_interface_te hid_interface)
+{
+    raw_hid_tx_ring_t* tx_ring_pt = &raw_hid_tx_rings[hid_interface];
+    
+    /* Packet at the head of our TX ring was sent: free its slot */
+    if ((comms_raw_hid_packet_being_sent[hid_interface] != FALSE) && (tx_ring_pt->nb_packets != 0))
     {
-        usb_send(USB_RAWHID_RX_ENDPOINT, (uint8_t*)packet, payload_size);
+        tx_ring_pt->read_index = (tx_ring_pt->read_index + 1) % RAW_HID_TX_RING_NB_PACKETS;
+        tx_ring_pt->nb_packets--;
     }
-    else if (hid_interface == CTAP_INTERFACE)
+    
+    /* Set flag */
+    comms_raw_hid_packet_being_sent[hid_interface] = FALSE;
+    
+    /* USB: directly refill the endpoint. BLE: this is called from BLE event handling, next packet is sent from the main loop */
+    if (hid_interface != BLE_INTERFACE)
     {
-        //comms_usb_debug_printf("Send CTAP response: IF: %d size: %d\n", CTAP_INTERFACE, payload_size);
-        usb_send(USB_CTAP_RX_ENDPOINT, (uint8_t*)packet, payload_size);
+        comms_raw_hid_start_tx_ring_packet_send(hid_interface);
     }
-    else
+}
+
+/*! \fn     comms_raw_hid_send_queued_packets(void)
+*   \brief  Keep sending packets queued for interfaces whose send completion doesn't refill the interface (BLE)
+*   \note   To be called from the main loop
+*/
+void comms_raw_hid_send_queued_packets(void)
+{
+    comms_raw_hid_start_tx_ring_packet_send(BLE_INTERFACE);
+}
+
+/*! \fn     comms_raw_hid_send_packet(hid_interface_te hid_interface, hid_packet_t* packet, BOOL wait_send, uint16_t payload_size)
+*   \brief  send raw hid packet
+*   \param  hid_interface   HID interface on which to send the packet
+*   \param  packet          Packet to send, copied in the interface TX ring
+*   \param  wait_send       Set to wait for end of transmission of all queued packets
+*   \param  payload_size    Payload size
+*/
+void comms_raw_hid_send_packet(hid_interface_te hid_interface, hid_packet_t* packet, BOOL wait_send, uint16_t payload_size)
+{
+    uint16_t usb_timeout_ms = (hid_interface == CTAP_INTERFACE)? 100 : 500;
+    
+    /* Get a free slot in our TX ring */
+    hid_packet_t* ring_packet_pt = comms_raw_hid_get_free_tx_ring_packet(hid_interface, usb_timeout_ms);
+    if (ring_packet_pt == 0)
     {
-        logic_bluetooth_raw_send((uint8_t*)packet, payload_size);
+        return;
     }
     
+    /* Copy packet & queue it */
+    if (payload_size > sizeof(hid_packet_t))
+    {
+        payload_size = sizeof(hid_packet_t);
+    }
+    memcpy((void*)ring_packet_pt, (void*)packet, payload_size);
+    comms_raw_hid_commit_tx_ring_packet(hid_interface, payload_size);
+    
     /* If asked, wait */
     if (wait_send != FALSE)
     {
-        if (hid_interface == USB_INTERFACE)
-        {
-            timer_start_timer(TIMER_USB_SEND_TIMEOUT, 500);
-        }
-        else if (hid_interface == CTAP_INTERFACE)
-        {
-            timer_start_timer(TIMER_USB_SEND_TIMEOUT, 100);
-        }        
-        timer_start_timer(TIMER_BT_TYPING_TIMEOUT, 3000);    
-            
-        while(comms_raw_hid_packet_being_sent[hid_interface] == TRUE)
-        {
-            if (hid_interface == BLE_INTERFACE)
-            {
-                ble_event_task();
-            }
-            
-            /* Check for BLE timeout */
-            if ((hid_interface == BLE_INTERFACE) && (timer_has_timer_expired(TIMER_BT_TYPING_TIMEOUT, FALSE) == TIMER_EXPIRED))
-            {
-                comms_raw_hid_packet_being_sent[hid_interface] = FALSE;
-                return;
-            }
-            
-            /* Check for usb disconnection, or in some cases a timeout due to the computer not wanting to read the OUT endpoint (wtf...) */
-            if (((hid_interface == USB_INTERFACE) || (hid_interface == CTAP_INTERFACE)) && ((usb_get_config() == 0) || (udc_get_nb_ms_before_last_usb_activity() > 100) || (timer_has_timer_expired(TIMER_USB_SEND_TIMEOUT, TRUE) == TIMER_EXPIRED)))
-            {
-                comms_raw_hid_packet_being_sent[hid_interface] = FALSE;
-                return;
-            }
-        }
-    }    
+        comms_raw_hid_wait_for_tx_ring_level(hid_interface, 0, usb_timeout_ms);
+    }
 }
 
 /*! \fn     comms_raw_hid_send_hid_message(hid_interface_te hid_interface, aux_mcu_message_t* message)
 *   \brief  send HID message to PC
 *   \param  hid_interface   interface from which we received the packet
 *   \param  message     Message to send
+*   \note   Packets are generated in the interface TX ring while the previous ones are sent: only waits when the ring is full
 */
 void comms_raw_hid_send_hid_message(hid_interface_te hid_interface, aux_mcu_message_t* message)
 {
-    uint8_t total_number_of_packets = ((message->payload_length1 + sizeof(raw_hid_send_buffer[0].mtc_hid_packet.payload) - 1)/sizeof(raw_hid_send_buffer[0].mtc_hid_packet.payload))-1;
+    uint8_t total_number_of_packets = ((message->payload_length1 + sizeof(raw_hid_tx_rings[0].packets[0].mtc_hid_packet.payload) - 1)/sizeof(raw_hid_tx_rings[0].packets[0].mtc_hid_packet.payload))-1;
     uint16_t remaining_payload_to_send = message->payload_length1;
     uint16_t payload_offset = 0;
     uint8_t packet_id = 0;
@@ -302,57 +388,38 @@ void comms_raw_hid_send_hid_message(hid_interface_te hid_interface, aux_mcu_mess
     /* Generate and send packets */
     while(remaining_payload_to_send > 0)
     {
-        timer_start_timer(TIMER_USB_SEND_TIMEOUT, 1000);
-        /* Wait for a possible previous packet to be sent as we do buffer re-use */
-        while(comms_raw_hid_packet_being_sent[hid_interface] == TRUE)
+        /* Get a free packet in our TX ring */
+        hid_packet_t* packet_pt = comms_raw_hid_get_free_tx_ring_packet(hid_interface, 1000);
+        if (packet_pt == 0)
         {
-            /* Bluetooth busy sending previous packet... */
-            if (hid_interface == BLE_INTERFACE)
-            {
-                ble_event_task();
-            }
-            
-            /* Check for usb disconnection, or in some cases a timeout due to the computer not wanting to read the OUT endpoint (wtf...) */
-            if (((hid_interface == USB_INTERFACE) || (hid_interface == CTAP_INTERFACE)) && ((usb_get_config() == 0) || (udc_get_nb_ms_before_last_usb_activity() > 100) || (timer_has_timer_expired(TIMER_USB_SEND_TIMEOUT, TRUE) == TIMER_EXPIRED)))
-            {
-                comms_raw_hid_packet_being_sent[hid_interface] = FALSE;
-                return;
-            }
+            return;
         }
         
         /* Generate packet */
-        memset((void*)&raw_hid_send_buffer[hid_interface], 0, sizeof(raw_hid_send_buffer[0]));
-        raw_hid_send_buffer[hid_interface].mtc_hid_packet.byte1.total_packets = total_number_of_packets;
-        raw_hid_send_buffer[hid_interface].mtc_hid_packet.byte1.packet_id = packet_id;
+        memset((void*)packet_pt, 0, sizeof(hid_packet_t));
+        packet_pt->mtc_hid_packet.byte1.total_packets = total_number_of_packets;
+        packet_pt->mtc_hid_packet.byte1.packet_id = packet_id;
         
         /* We do not care about the flip bit */
-        if (remaining_payload_to_send > sizeof(raw_hid_send_buffer[0].mtc_hid_packet.payload))
+        if (remaining_payload_to_send > sizeof(packet_pt->mtc_hid_packet.payload))
         {
-            raw_hid_send_buffer[hid_interface].mtc_hid_packet.byte0.payload_len = sizeof(raw_hid_send_buffer[0].mtc_hid_packet.payload);
+            packet_pt->mtc_hid_packet.byte0.payload_len = sizeof(packet_pt->mtc_hid_packet.payload);
         }
         else
         {
-            raw_hid_send_buffer[hid_interface].mtc_hid_packet.byte0.payload_len = remaining_payload_to_send;            
+            packet_pt->mtc_hid_packet.byte0.payload_len = remaining_payload_to_send;            
         }
         
-        /* Copy payload */
-        memcpy(raw_hid_send_buffer[hid_interface].mtc_hid_packet.payload, &(message->payload[payload_offset]), raw_hid_send_buffer[hid_interface].mtc_hid_packet.byte0.payload_len);
-        
-        /* 0-fill padding */
-        uint16_t padding_length = sizeof(raw_hid_send_buffer[0].mtc_hid_packet.payload) - raw_hid_send_buffer[hid_interface].mtc_hid_packet.byte0.payload_len;
-        if (padding_length != 0)
-        {
-            memset((void*)(&raw_hid_send_buffer[hid_interface].mtc_hid_packet.payload[raw_hid_send_buffer[hid_interface].mtc_hid_packet.byte0.payload_len]), 0x00, padding_length);
-        }
+        /* Copy payload, padding was 0-filled by the memset above */
+        memcpy(packet_pt->mtc_hid_packet.payload, &(message->payload[payload_offset]), packet_pt->mtc_hid_packet.byte0.payload_len);
         
         /* update local vars */
-        remaining_payload_to_send -= raw_hid_send_buffer[hid_interface].mtc_hid_packet.byte0.payload_len;
-        payload_offset += raw_hid_send_buffer[hid_interface].mtc_hid_packet.byte0.payload_len;
+        remaining_payload_to_send -= packet_pt->mtc_hid_packet.byte0.payload_len;
+        payload_offset += packet_pt->mtc_hid_packet.byte0.payload_len;
         packet_id += 1;
         
         /* Send packet: always send 64B due to some strange windows receive trigger thingy */
-        //comms_raw_hid_send_packet(&raw_hid_send_buffer, TRUE, sizeof(raw_hid_send_buffer.byte0) + sizeof(raw_hid_send_buffer.byte1) + raw_hid_send_buffer.byte0.payload_len);
-        comms_raw_hid_send_packet(hid_interface, &raw_hid_send_buffer[hid_interface], TRUE, USB_RAWHID_RX_SIZE);
+        comms_raw_hid_commit_tx_ring_packet(hid_interface, USB_RAWHID_RX_SIZE);
     }
 }
 
@@ -395,7 +462,7 @@ void comms_raw_hid_connection_set_callback(hid_interface_te hid_interface)
     comms_raw_hid_expect_flip_bit_state_set[hid_interface] = FALSE;
     comms_raw_hid_temp_mcu_message_fill_index[hid_interface] = 0;
     comms_raw_hid_expected_packet_number[hid_interface] = 0;
-    comms_raw_hid_packet_being_sent[hid_interface] = FALSE;
+    comms_raw_hid_flush_tx_ring(hid_interface);
 } 
 
 /*! \fn     comms_usb_communication_routine(void)
@@ -549,8 +616,7 @@ comms_usb_ret_te comms_usb_communication_routine(void)
                 if (raw_hid_recv_buffer[hid_interface].mtc_hid_packet.byte0.ack_flag_or_req != 0)
                 {
                     /* Send the same message */
-                    memcpy((void*)&raw_hid_send_buffer[hid_interface], (void*)&raw_hid_recv_buffer[hid_interface], sizeof(raw_hid_send_buffer[0]));
-                    comms_raw_hid_send_packet(hid_interface, &raw_hid_send_buffer[hid_interface], TRUE, comms_raw_hid_packet_receive_length[hid_interface]);
+                    comms_raw_hid_send_packet(hid_interface, &raw_hid_recv_buffer[hid_interface], TRUE, comms_raw_hid_packet_receive_length[hid_interface]);
                 }
                 
                 /* Prepare and send message to main MCU */
@@ -12,6 +12,9 @@
 #include "defines.h"
 #include "comms_main_mcu.h"
 
+/* Defines */
+#define RAW_HID_TX_RING_NB_PACKETS  4
+
 /* Type defs */
 typedef struct
 {
@@ -39,11 +42,19 @@ typedef struct
     };
 } hid_packet_t;
 
+typedef struct
+{
+    hid_packet_t packets[RAW_HID_TX_RING_NB_PACKETS];
+    uint16_t packet_sizes[RAW_HID_TX_RING_NB_PACKETS];
+    volatile uint8_t read_index;    // Only moved by the send complete callback & flush
+    uint8_t write_index;            // Only moved by the producer, when committing a packet
+    volatile uint8_t nb_packets;
+} raw_hid_tx_ring_t;
+
 /* Prototypes */
 void comms_raw_hid_send_packet(hid_interface_te hid_interface, hid_packet_t* packet, BOOL wait_send, uint16_t payload_size);
 void comms_raw_hid_send_hid_message(hid_interface_te hid_interface, aux_mcu_message_t* message);
 void comms_raw_hid_recv_callback(hid_interface_te hid_interface, uint16_t recv_bytes);
-hid_packet_t* comms_raw_hid_get_send_buffer(hid_interface_te hid_interface);
 void comms_raw_hid_connection_set_callback(hid_interface_te hid_interface);
 uint8_t* comms_raw_hid_get_recv_buffer(hid_interface_te hid_interface);
 void comms_raw_hid_arm_packet_receive(hid_interface_te hid_interface);
@@ -55,6 +66,7 @@ uint8_t* comms_raw_hid_get_idle_config(uint8_t interface);
 uint8_t* comms_raw_hid_get_protocol(uint8_t interface);
 comms_usb_ret_te comms_usb_communication_routine(void);
 void comms_usb_debug_printf(const char *fmt, ...);
+void comms_raw_hid_send_queued_packets(void);
 void comms_usb_clear_enumerated(void);
 BOOL comms_usb_is_enumerated(void);
 
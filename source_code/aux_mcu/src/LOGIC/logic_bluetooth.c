@@ -1963,6 +1963,61 @@ void logic_bluetooth_raw_send(uint8_t* data, uint16_t data_len)
     }
 }
 
+/*! \fn     logic_bluetooth_send_keyboard_report(uint8_t modifier, uint8_t* keys, BOOL wait_for_sent)
+*   \brief  Send a full keyboard report through keyboard link
+*   \param  modifier        HID modifier
+*   \param  keys            Array of 6 HID keys, 0 for unused slots
+*   \param  wait_for_sent   Set to wait for the notification to be sent. If not set, the next report send will wait for it
+*   \return If we were able to correctly type
+*/
+ret_type_te logic_bluetooth_send_keyboard_report(uint8_t modifier, uint8_t* keys, BOOL wait_for_sent)
+{
+    if (logic_bluetooth_can_communicate_with_host == FALSE)
+    {
+        return RETURN_NOK;
+    }
+    
+    /* Wait for previous notification (possibly our previous report) to be sent */
+    logic_bluetooth_check_and_wait_for_notif_sent();
+    
+    /* Previous wait may have ended with a disconnection */
+    if (logic_bluetooth_can_communicate_with_host == FALSE)
+    {
+        return RETURN_NOK;
+    }
+    
+    /* Send report */
+    logic_bluetooth_notif_being_sent = KEYBOARD_NOTIF_SENDING;
+    logic_bluetooth_keyboard_in_report[0] = modifier;
+    memcpy(&logic_bluetooth_keyboard_in_report[2], keys, sizeof(logic_bluetooth_keyboard_in_report) - 2);
+    logic_bluetooth_typed_report_sent = FALSE;
+    logic_bluetooth_update_report(logic_bluetooth_ble_connection_handle, BLE_KEYBOARD_HID_SERVICE_INSTANCE, BLE_KEYBOARD_HID_IN_REPORT_NB, logic_bluetooth_keyboard_in_report, sizeof(logic_bluetooth_keyboard_in_report), TRUE);
+    
+    /* Pipelined typing: caller will do its inter-report delay while the notification is being sent */
+    if (wait_for_sent == FALSE)
+    {
+        return RETURN_OK;
+    }
+    
+    /* OK I'm still not sure about this one... but I think it should be OK. Stack trace is main > comms_main_mcu_routine > comms_main_mcu_deal_with_non_usb_non_ble_message > logic_keyboard_type_symbols > logic_keyboard_send_report to here */
+    timer_start_timer(TIMER_BT_TYPING_TIMEOUT, 1000);
+    while ((timer_has_timer_expired(TIMER_BT_TYPING_TIMEOUT, FALSE) == TIMER_RUNNING) && (logic_bluetooth_typed_report_sent == FALSE))
+    {
+        ble_event_task();
+    }
+    
+    /* Report sent? */
+    if (logic_bluetooth_typed_report_sent == FALSE)
+    {
+        DBG_LOG("Couldn't send modifier in key as notification in time!");
+        return RETURN_NOK;
+    } 
+    else
+    {
+        return RETURN_OK;
+    }
+}
+
 /*! \fn     logic_bluetooth_send_modifier_and_key(uint8_t modifier, uint8_t key, uint8_t second_key)
 *   \brief  Send modifier and key through keyboard link
 *   \param  modifier    HID modifier
@@ -1972,51 +2027,12 @@ void logic_bluetooth_raw_send(uint8_t* data, uint16_t data_len)
 */
 ret_type_te logic_bluetooth_send_modifier_and_key(uint8_t modifier, uint8_t key, uint8_t second_key)
 {
-    if (logic_bluetooth_can_communicate_with_host != FALSE)
-    {
-        if (TRUE)
-        {
-            logic_bluetooth_check_and_wait_for_notif_sent();
-            logic_bluetooth_notif_being_sent = KEYBOARD_NOTIF_SENDING;
-            logic_bluetooth_keyboard_in_report[0] = modifier;
-            logic_bluetooth_keyboard_in_report[2] = key;
-            logic_bluetooth_keyboard_in_report[3] = second_key;
-            logic_bluetooth_typed_report_sent = FALSE;
-            logic_bluetooth_update_report(logic_bluetooth_ble_connection_handle, BLE_KEYBOARD_HID_SERVICE_INSTANCE, BLE_KEYBOARD_HID_IN_REPORT_NB, logic_bluetooth_keyboard_in_report, sizeof(logic_bluetooth_keyboard_in_report), TRUE);
-        } 
-        else
-        {
-            logic_bluetooth_check_and_wait_for_notif_sent();
-            logic_bluetooth_notif_being_sent = KEYBOARD_NOTIF_SENDING;
-            logic_bluetooth_boot_keyb_in_report[0] = modifier;
-            logic_bluetooth_boot_keyb_in_report[2] = key;
-            logic_bluetooth_boot_keyb_in_report[3] = second_key;
-            logic_bluetooth_typed_report_sent = FALSE;
-            logic_bluetooth_update_report(logic_bluetooth_ble_connection_handle, BLE_KEYBOARD_HID_SERVICE_INSTANCE, BLE_KEYBOARD_HID_IN_REPORT_NB, logic_bluetooth_boot_keyb_in_report, sizeof(logic_bluetooth_boot_keyb_in_report), FALSE);
-        }
-        
-        /* OK I'm still not sure about this one... but I think it should be OK. Stack trace is main > comms_main_mcu_routine > comms_main_mcu_deal_with_non_usb_non_ble_message > logic_keyboard_type_symbol > logic_keyboard_type_key_with_modifier to here */
-        timer_start_timer(TIMER_BT_TYPING_TIMEOUT, 1000);
-        while ((timer_has_timer_expired(TIMER_BT_TYPING_TIMEOUT, FALSE) == TIMER_RUNNING) && (logic_bluetooth_typed_report_sent == FALSE))
-        {
-            ble_event_task();
-        }
-        
-        /* Report sent? */
-        if (logic_bluetooth_typed_report_sent == FALSE)
-        {
-            DBG_LOG("Couldn't send modifier in key as notification in time!");
-            return RETURN_NOK;
-        } 
-        else
-        {
-            return RETURN_OK;
-        }
-    }
-    else
-    {
-        return RETURN_NOK;
-    }
+    uint8_t keys[sizeof(logic_bluetooth_keyboard_in_report) - 2];
+    
+    memset(keys, 0, sizeof(keys));
+    keys[0] = key;
+    keys[1] = second_key;
+    return logic_bluetooth_send_keyboard_report(modifier, keys, TRUE);
 }
 
 /*! \fn     logic_bluetooth_routine(void)
@@ -117,64 +117,181 @@ ret_type_te logic_keyboard_type_key_with_modifier(hid_interface_te interface, ui
     return RETURN_OK; 
 }
 
-/*! \fn     logic_keyboard_type_symbol(hid_interface_te interface, uint8_t symbol, BOOL is_dead_key, uint16_t delay_between_types)
-*   \brief  Type an encoded symbol through a given interface
-*   \param  interface           HID interface on which to type the symbol
-*   \param  symbol              The symbol
-*   \param  is_dead_key         Is the symbol a dead key?
-*   \param  delay_between_types Delay between key presses
-*   \return If we were able to type the symbol
+/*! \fn     logic_keyboard_get_key_and_modifier_for_symbol(uint8_t symbol, uint8_t* key, uint8_t* modifier)
+*   \brief  Convert an encoded symbol into a HID key and modifier
+*   \param  symbol      The symbol
+*   \param  key         Where to store the HID key
+*   \param  modifier    Where to store the HID modifier
 */
-ret_type_te logic_keyboard_type_symbol(hid_interface_te interface, uint8_t symbol, BOOL is_dead_key, uint16_t delay_between_types)
+static void logic_keyboard_get_key_and_modifier_for_symbol(uint8_t symbol, uint8_t* key, uint8_t* modifier)
 {
     uint8_t masked_key = symbol & (SHIFT_MASK|ALTGR_MASK);
-    ret_type_te return_val;
-        
+    
+    if (masked_key == (SHIFT_MASK|ALTGR_MASK))
+    {
+        *modifier = KEY_SHIFT|KEY_RIGHT_ALT;
+    }
+    else if (masked_key == SHIFT_MASK)
+    {
+        // If we need shift
+        *modifier = KEY_SHIFT;
+    }
+    else if (masked_key == ALTGR_MASK)
+    {
+        // We need altgr for the numbered keys, only possible because we don't use the numerical keypad
+        *modifier = KEY_RIGHT_ALT;
+    }
+    else
+    {
+        *modifier = 0;
+    }
+    
     if ((symbol & 0x3F) == KEY_EUROPE_2)
     {
         // Because of a redefine of KEY_EUROPE_2 for storage purposes we need to do that
-        uint8_t mod_tbs = 0;
-            
-        if (masked_key == (SHIFT_MASK|ALTGR_MASK))
-        {
-            mod_tbs = KEY_SHIFT|KEY_RIGHT_ALT;
-        }
-        else if (masked_key == SHIFT_MASK)
-        {
-            mod_tbs = KEY_SHIFT;
-        }
-        else if (masked_key == ALTGR_MASK)
+        *key = KEY_EUROPE_2_REAL;
+    }
+    else
+    {
+        *key = symbol & ~(SHIFT_MASK|ALTGR_MASK);
+    }
+}
+
+/*! \fn     logic_keyboard_send_report(hid_interface_te interface, uint8_t modifier, uint8_t* keys, BOOL wait_for_sent)
+*   \brief  Send a full keyboard report
+*   \param  interface       HID interface on which to send the report
+*   \param  modifier        Modifier (alt, shift...)
+*   \param  keys            Array of LOGIC_KEYBOARD_NB_KEYS_PER_REPORT keys, 0 for unused slots
+*   \param  wait_for_sent   Set to wait for the report to be sent (BLE only)
+*   \return If we were able to send the report
+*/
+static ret_type_te logic_keyboard_send_report(hid_interface_te interface, uint8_t modifier, uint8_t* keys, BOOL wait_for_sent)
+{
+    if (interface == USB_INTERFACE)
+    {
+        /* Check for enumeration */
+        if ((usb_get_config() == 0) || (udc_get_nb_ms_before_last_usb_activity() > 100))
         {
-            mod_tbs = KEY_RIGHT_ALT;
+            return RETURN_NOK;
         }
-            
-        // Send the correct KEY_EUROPE_2 with the correct modifier
-        return_val = logic_keyboard_type_key_with_modifier(interface, KEY_EUROPE_2_REAL, mod_tbs, delay_between_types);
+        
+        logic_keyboard_usb_hid_keys_buffer[0] = modifier;
+        memcpy(&logic_keyboard_usb_hid_keys_buffer[2], keys, LOGIC_KEYBOARD_NB_KEYS_PER_REPORT);
+        usb_send(USB_KEYBOARD_ENDPOINT, (uint8_t*)logic_keyboard_usb_hid_keys_buffer, sizeof(logic_keyboard_usb_hid_keys_buffer));
+        return RETURN_OK;
     }
-    else if (masked_key == (SHIFT_MASK|ALTGR_MASK))
+    else
     {
-        return_val = logic_keyboard_type_key_with_modifier(interface, symbol & ~(SHIFT_MASK|ALTGR_MASK), KEY_SHIFT|KEY_RIGHT_ALT, delay_between_types);
+        return logic_bluetooth_send_keyboard_report(modifier, keys, wait_for_sent);
     }
-    else if (masked_key == SHIFT_MASK)
+}
+
+/*! \fn     logic_keyboard_type_key(logic_keyboard_typing_state_t* state, uint8_t key, uint8_t modifier)
+*   \brief  Press a key, releasing the previous one and setting the new modifier in a single report
+*   \param  state       Typing state
+*   \param  key         Key to type
+*   \param  modifier    Modifier (alt, shift...)
+*   \return If we were able to send the reports
+*   \note   The key is released by the next report
+*/
+static ret_type_te logic_keyboard_type_key(logic_keyboard_typing_state_t* state, uint8_t key, uint8_t modifier)
+{
+    uint8_t keys[LOGIC_KEYBOARD_NB_KEYS_PER_REPORT];
+    memset(keys, 0, sizeof(keys));
+    
+    /* Release the previously pressed key and set the new modifier with a single report */
+    if ((state->key_pressed != FALSE) || (state->held_modifier != modifier))
     {
-        // If we need shift
-        return_val = logic_keyboard_type_key_with_modifier(interface, symbol & ~SHIFT_MASK, KEY_SHIFT, delay_between_types);
+        if (logic_keyboard_send_report(state->interface, modifier, keys, FALSE) != RETURN_OK)
+        {
+            return RETURN_NOK;
+        }
+        timer_delay_ms(state->delay_between_types);
+        state->held_modifier = modifier;
+        state->key_pressed = FALSE;
     }
-    else if (masked_key == ALTGR_MASK)
+    
+    /* Press key on its own: hosts don't all process simultaneous key presses in report slot order */
+    keys[0] = key;
+    if (logic_keyboard_send_report(state->interface, modifier, keys, FALSE) != RETURN_OK)
     {
-        // We need altgr for the numbered keys, only possible because we don't use the numerical keypad
-        return_val = logic_keyboard_type_key_with_modifier(interface, symbol & ~ALTGR_MASK, KEY_RIGHT_ALT, delay_between_types);
+        return RETURN_NOK;
     }
-    else
+    timer_delay_ms(state->delay_between_types);
+    state->key_pressed = TRUE;
+    return RETURN_OK;
+}
+
+/*! \fn     logic_keyboard_type_symbols(hid_interface_te interface, uint16_t* symbols, uint16_t nb_symbols, uint16_t delay_between_types)
+*   \brief  Type a string of encoded symbols through a given interface, with 2 reports per key
+*   \param  interface           HID interface on which to type the symbols
+*   \param  symbols             Symbols, as sent by the main MCU, stops at the first 0 symbol
+*   \param  nb_symbols          Maximum number of symbols
+*   \param  delay_between_types Delay between reports in ms
+*   \return If we were able to type the symbols
+*   \note   Each key release shares its report with the next modifier change, so modifier-only reports are only sent when the modifier changes with nothing pressed
+*/
+ret_type_te logic_keyboard_type_symbols(hid_interface_te interface, uint16_t* symbols, uint16_t nb_symbols, uint16_t delay_between_types)
+{
+    uint8_t keys[LOGIC_KEYBOARD_NB_KEYS_PER_REPORT];
+    logic_keyboard_typing_state_t typing_state;
+    ret_type_te return_val = RETURN_OK;
+    uint8_t modifier;
+    uint8_t key;
+    
+    /* Init typing state: nothing pressed */
+    memset(&typing_state, 0, sizeof(typing_state));
+    typing_state.delay_between_types = delay_between_types;
+    typing_state.interface = interface;
+    
+    /* Iterate over symbols */
+    for (uint16_t i = 0; (i < nb_symbols) && (symbols[i] != 0) && (return_val == RETURN_OK); i++)
     {
-        return_val = logic_keyboard_type_key_with_modifier(interface, symbol, 0, delay_between_types);
+        uint16_t symbol = symbols[i];
+        
+        if (symbol == 0xFFFF)
+        {
+            /* Original unicode point can't be typed */
+        }
+        else if ((symbol & 0x7F00) == 0)
+        {
+            /* One key to be typed */
+            logic_keyboard_get_key_and_modifier_for_symbol((uint8_t)symbol, &key, &modifier);
+            
+            /* Check for dead key: type it followed by a space */
+            if ((symbol & 0x8000) != 0)
+            {
+                return_val = logic_keyboard_type_key(&typing_state, key, modifier);
+                if (return_val == RETURN_OK)
+                {
+                    return_val = logic_keyboard_type_key(&typing_state, KEY_SPACE, 0);
+                }
+            }
+            else
+            {
+                return_val = logic_keyboard_type_key(&typing_state, key, modifier);
+            }
+        }
+        else
+        {
+            /* Two keys to be typed: the first one usually is a dead key */
+            logic_keyboard_get_key_and_modifier_for_symbol((uint8_t)(symbol >> 8), &key, &modifier);
+            return_val = logic_keyboard_type_key(&typing_state, key, modifier);
+            if (return_val == RETURN_OK)
+            {
+                logic_keyboard_get_key_and_modifier_for_symbol((uint8_t)symbol, &key, &modifier);
+                return_val = logic_keyboard_type_key(&typing_state, key, modifier);
+            }
+        }
     }
     
-    /* Add space if typed character is a dead key */
-    if ((is_dead_key != FALSE) && (return_val == RETURN_OK))
+    /* Release all, waiting for it to be sent */
+    memset(keys, 0, sizeof(keys));
+    if (logic_keyboard_send_report(interface, 0, keys, TRUE) != RETURN_OK)
     {
-        return_val = logic_keyboard_type_key_with_modifier(interface, KEY_SPACE, 0, delay_between_types);        
+        return RETURN_NOK;
     }
+    timer_delay_ms(delay_between_types);
     
     return return_val;
-}
\ No newline at end of file
+}
@@ -132,10 +132,20 @@
 #define KEY_F14                0x69
 #define KEY_F15                0x6A
 #define KEY_WIN_L              0xE3
+#define LOGIC_KEYBOARD_NB_KEYS_PER_REPORT   6
+
+/* Typedefs */
+typedef struct
+{
+    hid_interface_te interface;
+    uint16_t delay_between_types;
+    uint8_t held_modifier;
+    BOOL key_pressed;
+} logic_keyboard_typing_state_t;
 
 /* Prototypes */
 ret_type_te logic_keyboard_type_key_with_modifier(hid_interface_te interface, uint8_t key, uint8_t modifier, uint16_t delay_between_types);
-ret_type_te logic_keyboard_type_symbol(hid_interface_te interface, uint8_t symbol, BOOL is_dead_key, uint16_t delay_between_types);
+ret_type_te logic_keyboard_type_symbols(hid_interface_te interface, uint16_t* symbols, uint16_t nb_symbols, uint16_t delay_between_types);
 void logic_keyboard_type_lock_shortcut(hid_interface_te interface_id, uint8_t l_symbol);
 
 #endif /* LOGIC_KEYBOARD_H_ */
\ No newline at end of file
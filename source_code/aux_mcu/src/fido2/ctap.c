@@ -482,32 +482,44 @@ uint8_t ctap_add_attest_statement(CborEncoder * map, uint8_t * sigder, int len)
     return 0;
 }
 
-// Return 1 if credential belongs to this token
+// Return 1 if one of the credentials belongs to this token
 // MiniBLE:
-// Forward message to main_mcu instead and get response.
-int ctap_authenticate_credential(struct rpId * rp, CTAP_credentialDescriptor * desc)
+// Forward the whole batch to main_mcu instead and get a single response.
+int ctap_authenticate_credentials(struct rpId * rp, CredentialId * ids, uint8_t nb_ids)
 {
     aux_mcu_message_t* temp_rx_message_pt = comms_main_mcu_get_temp_rx_message_object_pt();
     aux_mcu_message_t* temp_tx_message_pt;
-    fido2_auth_cred_req_message_t* msg;
+    fido2_exclude_list_req_message_t* msg;
     fido2_auth_cred_rsp_message_t* rsp_msg;
     ret_type_te ret = RETURN_NOK;
+    uint8_t i;
 
-    /* Create message to authenticate a credential */
+    if (nb_ids > FIDO2_ALLOW_LIST_MAX_SIZE)
+    {
+        //Programmer error
+        printf1(TAG_ERR,"Programmer error. Size of arrays is inconsistent");
+        return 0;
+    }
+
+    /* Create message to authenticate the credentials */
     comms_main_mcu_get_empty_packet_ready_to_be_sent(&temp_tx_message_pt, AUX_MCU_MSG_TYPE_FIDO2);
 
-    msg = &temp_tx_message_pt->fido2_message.fido2_auth_cred_req_message;
+    msg = &temp_tx_message_pt->fido2_message.fido2_exclude_list_req_message;
 
     /* Fill message */
     memset(msg, 0, sizeof(*msg));
     memcpy(msg->rpID, rp->id, FIDO2_RPID_LEN);
-    memcpy(msg->cred_ID.tag, desc->id.tag, FIDO2_CREDENTIAL_ID_LENGTH);
+    msg->exclude_list.len = nb_ids;
+    for (i = 0; i < nb_ids; ++i)
+    {
+        memcpy(&msg->exclude_list.tag[i], ids[i].tag, sizeof(msg->exclude_list.tag[i]));
+    }
 
     /* Set length of message */
     temp_tx_message_pt->payload_length1 = sizeof(fido2_message_t);
 
     /* Set message subtype */
-    temp_tx_message_pt->fido2_message.message_type = AUX_MCU_FIDO2_AUTH_CRED_REQ;
+    temp_tx_message_pt->fido2_message.message_type = AUX_MCU_FIDO2_EXCL_LIST_REQ;
 
     /* Send packet */
     comms_main_mcu_send_message((void*)temp_tx_message_pt, (uint16_t)sizeof(aux_mcu_message_t));
@@ -541,9 +553,13 @@ uint8_t ctap_make_credential(CborEncoder * encoder, uint8_t * request, int lengt
     unsigned int i;
     uint8_t auth_data_buf[310];
     CTAP_credentialDescriptor * excl_cred = (CTAP_credentialDescriptor *) auth_data_buf;
+    CredentialId * excl_ids = (CredentialId *) (auth_data_buf + sizeof(CTAP_credentialDescriptor));
+    uint8_t nb_excl_ids = 0;
     uint8_t sigbuf[FIDO2_ATTEST_SIG_LEN];// = auth_data_buf + 32;
     uint8_t sigder[72];// = auth_data_buf + 32 + 64;
 
+    _Static_assert(sizeof(auth_data_buf) >= sizeof(CTAP_credentialDescriptor) + ALLOW_LIST_MAX_SIZE * sizeof(CredentialId), "auth_data_buf can't hold a batch of excluded credential IDs");
+
     ret = ctap_parse_make_credential(&MC,encoder,request,length);
 
     if (ret != 0)
@@ -596,16 +612,27 @@ uint8_t ctap_make_credential(CborEncoder * encoder, uint8_t * request, int lengt
         check_retr(ret);
 
         printf1(TAG_GREEN, "checking credId: "); dump_hex1(TAG_GREEN, (uint8_t*) &excl_cred->id, sizeof(CredentialId));
+        memcpy(&excl_ids[nb_excl_ids++], &excl_cred->id, sizeof(CredentialId));
 
-        if (ctap_authenticate_credential(&MC.common.rp, excl_cred))
+        /* Check credentials by batches: one exchange with main MCU per batch */
+        if (nb_excl_ids == ALLOW_LIST_MAX_SIZE)
         {
-            printf1(TAG_MC, "Cred %d failed!\r",i);
-            return CTAP2_ERR_CREDENTIAL_EXCLUDED;
+            if (ctap_authenticate_credentials(&MC.common.rp, excl_ids, nb_excl_ids))
+            {
+                printf1(TAG_MC, "Cred batch ending at %d failed!\r",i);
+                return CTAP2_ERR_CREDENTIAL_EXCLUDED;
+            }
+            nb_excl_ids = 0;
         }
 
         ret = cbor_value_advance(&MC.excludeList);
         check_ret(ret);
     }
+    if ((nb_excl_ids != 0) && ctap_authenticate_credentials(&MC.common.rp, excl_ids, nb_excl_ids))
+    {
+        printf1(TAG_MC, "Cred batch ending at %d failed!\r",i);
+        return CTAP2_ERR_CREDENTIAL_EXCLUDED;
+    }
 
 
     CborEncoder map;
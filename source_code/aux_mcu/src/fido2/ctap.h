@@ -284,7 +284,7 @@ void ctap_reset_state(void);
 
 uint8_t ctap_add_pin_if_verified(uint8_t * pinTokenEnc, uint8_t * platform_pubkey, uint8_t * pinHashEnc);
 uint8_t ctap_update_pin_if_verified(uint8_t * pinEnc, int len, uint8_t * platform_pubkey, uint8_t * pinAuth, uint8_t * pinHashEnc);
-int ctap_authenticate_credential(struct rpId * rp, CTAP_credentialDescriptor * desc);
+int ctap_authenticate_credentials(struct rpId * rp, CredentialId * ids, uint8_t nb_ids);
 uint8_t ctap_make_credential(CborEncoder * encoder, uint8_t * request, int length);
 uint8_t ctap_get_assertion(CborEncoder * encoder, uint8_t * request, int length);
 uint8_t ctap_add_attest_statement(CborEncoder * map, uint8_t * sigder, int len);
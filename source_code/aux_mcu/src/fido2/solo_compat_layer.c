@@ -10,17 +10,14 @@ uint32_t millis(void)
 
 void usbhid_send(uint8_t * msg)
 {
-    hid_packet_t* send_buf_ptr = comms_raw_hid_get_send_buffer(CTAP_INTERFACE);
-
-    memcpy(send_buf_ptr, msg, USB_RAWHID_RX_SIZE);
-
     //comms_usb_debug_printf("Output buffer3:\n");
     //comms_usb_debug_printf("0x%02x 0x%02x 0x%02x 0x%02x\n", msg[0], msg[1], msg[2], msg[3]);
     //comms_usb_debug_printf("0x%02x 0x%02x 0x%02x 0x%02x\n", msg[4], msg[5], msg[6], msg[7]);
     //comms_usb_debug_printf("0x%02x 0x%02x 0x%02x 0x%02x\n", msg[8], msg[9], msg[10], msg[11]);
     //comms_usb_debug_printf("0x%02x 0x%02x 0x%02x 0x%02x\n", msg[12], msg[13], msg[14], msg[15]);
 
-    comms_raw_hid_send_packet(CTAP_INTERFACE, send_buf_ptr, TRUE, USB_RAWHID_RX_SIZE);
+    /* Packet is copied in the CTAP TX ring, no need to wait for it to be sent */
+    comms_raw_hid_send_packet(CTAP_INTERFACE, (hid_packet_t*)msg, FALSE, USB_RAWHID_RX_SIZE);
 }
 
 void ctaphid_write_block(uint8_t * data)
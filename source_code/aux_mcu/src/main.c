@@ -193,6 +193,9 @@ int main(void)
         {
            logic_bluetooth_routine();
         }
+        
+        /* Send BLE packets that were queued behind a packet being sent */
+        comms_raw_hid_send_queued_packets();
     }
 }
 
@@ -76,6 +76,7 @@ SOURCES += src/EMU/lis2hh12.c \
     src/FILESYSTEM/custom_fs_emergency_font.c \
     src/EMU/dataflash.c \
     src/EMU/dbflash.c \
+    src/FLASH/dbflash_cache.c \
     src/GUI/gui_carousel.c \
     src/GUI/gui_dispatcher.c \
     src/GUI/gui_menu.c \
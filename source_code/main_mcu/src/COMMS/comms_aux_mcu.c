@@ -649,6 +649,18 @@ static comms_msg_rcvd_te comms_aux_mcu_handle_fido2_auth_cred_msg(fido2_message_
     return FIDO2_MSG_RCVD;
 }
 
+/*! \fn     comms_aux_mcu_handle_fido2_exclude_list_msg(fido2_message_t* received_message)
+*   \brief  routine handling checking a batch of excluded credentials
+*   \param  received_message    The received message
+*   \return FIDO2_MSG_RCVD
+*/
+static comms_msg_rcvd_te comms_aux_mcu_handle_fido2_exclude_list_msg(fido2_message_t* received_message)
+{
+    fido2_exclude_list_req_message_t* incoming_message = &received_message->fido2_exclude_list_req_message;
+    logic_fido2_process_exclude_list(incoming_message);
+    return FIDO2_MSG_RCVD;
+}
+
 /*! \fn     comms_aux_mcu_handle_fido2_make_credential_msg(fido2_message_t* received_message)
 *   \brief  routine handling making a new credential
 *   \param  received_message    The received message
@@ -704,6 +716,11 @@ static comms_msg_rcvd_te comms_aux_mcu_handle_fido2_message(fido2_message_t* rec
                 msg_rcvd = comms_aux_mcu_handle_fido2_auth_cred_msg(received_message);
                 break;
             }
+            case AUX_MCU_FIDO2_EXCL_LIST_REQ:
+            {
+                msg_rcvd = comms_aux_mcu_handle_fido2_exclude_list_msg(received_message);
+                break;
+            }
             case AUX_MCU_FIDO2_MC_REQ:
             {
                 msg_rcvd = comms_aux_mcu_handle_fido2_make_credential_msg(received_message);
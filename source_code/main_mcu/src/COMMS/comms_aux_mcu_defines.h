@@ -97,6 +97,7 @@
 #define AUX_MCU_EVENT_RX_DTM_DONE           0x0017
 #define AUX_MCU_EVENT_BLE_CON_SPAM          0x0018
 #define AUX_MCU_EVENT_BONDING_CLEARED       0x0019
+#define AUX_MCU_EVENT_HID_MSG_SENT          0x001A
 
 // BLE commands
 #define BLE_MESSAGE_CMD_ENABLE              0x0001
@@ -122,7 +123,8 @@
 #define AUX_MCU_FIDO2_GA_REQ                0x0005
 #define AUX_MCU_FIDO2_GA_RSP                0x0006
 #define AUX_MCU_FIDO2_RETRY                 0x0007
-#define AUX_MCU_MSG_TYPE_FIDO2_END          AUX_MCU_FIDO2_RETRY
+#define AUX_MCU_FIDO2_EXCL_LIST_REQ         0x0008
+#define AUX_MCU_MSG_TYPE_FIDO2_END          AUX_MCU_FIDO2_EXCL_LIST_REQ
 /* FIDO2 messages end */
 
 /*
@@ -263,6 +265,12 @@ typedef struct fido2_allow_list_s
     uint8_t tag[FIDO2_ALLOW_LIST_MAX_SIZE][FIDO2_CREDENTIAL_ID_LENGTH]; //160 bytes
 } fido2_allow_list_t;
 
+typedef struct fido2_exclude_list_req_message_s
+{
+    uint8_t rpID[FIDO2_RPID_LEN];
+    fido2_allow_list_t exclude_list;
+} fido2_exclude_list_req_message_t;
+
 typedef struct fido2_make_credential_req_message_s
 {
     uint8_t rpID[FIDO2_RPID_LEN];
@@ -323,6 +331,7 @@ typedef struct fido2_message_s
         fido2_make_credential_rsp_message_t fido2_make_credential_rsp_message;
         fido2_get_assertion_req_message_t fido2_get_assertion_req_message;
         fido2_get_assertion_rsp_message_t fido2_get_assertion_rsp_message;
+        fido2_exclude_list_req_message_t fido2_exclude_list_req_message;
     };
 } fido2_message_t;
 
@@ -350,7 +359,7 @@ typedef struct
     union
     {
         uint16_t rx_payload_valid_flag;
-        uint16_t tx_not_used;
+        uint16_t tx_sent_notif_req_flag;
     };
 } aux_mcu_message_t;
 
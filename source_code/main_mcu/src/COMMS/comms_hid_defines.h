@@ -104,6 +104,11 @@
 #define HID_CMD_SET_CUST_BLE_NAME   0x0040
 #define HID_CMD_GET_TOTP_CODE       0x0041
 #define HID_CMD_GET_CUST_BLE_NAME   0x0042
+#define HID_CMD_BUNDLE_WRITE_STREAM 0x0043
+#define HID_CMD_START_BUNDLE_DELTA  0x0044
+#define HID_CMD_GET_BUNDLE_BLK_CRCS 0x0045
+#define HID_CMD_ERASE_BUNDLE_BLOCK  0x0046
+#define HID_CMD_GET_FILE_STREAM     0x0047
 // Below: commands requiring MMM
 #define HID_CMD_GET_START_PARENTS   0x0100
 #define HID_CMD_END_MMM             0x0101
@@ -122,10 +127,32 @@
 #define HID_CMD_GET_CPZ_LUT_ENTRY   0x010E
 #define HID_CMD_GET_FAVORITES       0x010F
 #define HID_CMD_CHANGE_NODE_PWD     0x0110
+#define HID_CMD_READ_NODES          0x0111
+#define HID_CMD_WRITE_NODES         0x0112
 // Define used to identify commands
 #define HID_FIRST_CMD_FOR_MMM       HID_CMD_GET_START_PARENTS
 #define HID_LAST_CMD_FOR_MMM        0x0200
 
+/* Read nodes command modes */
+#define HID_READ_NODES_MODE_RANGE   0x0000
+#define HID_READ_NODES_MODE_LIST    0x0001
+#define HID_READ_NODES_MODE_FOLLOW  0x0002
+/* Read nodes command: maximum number of nodes per request */
+#define HID_READ_NODES_MAX_NB_NODES 32
+
+/* Bundle streaming: flag set by the host to request an immediate acknowledgement */
+#define HID_BUNDLE_STREAM_FLAG_ACK_REQ  0x0001
+/* Bundle streaming: unsolicited acknowledgement every N chunks written in sequence */
+#define HID_BUNDLE_STREAM_ACK_INTERVAL  8
+
+/* File streaming export: request flag to export a note instead of a file */
+#define HID_FILE_STREAM_REQ_FLAG_NOTE   0x0001
+/* File streaming export: chunk flags */
+#define HID_FILE_STREAM_FLAG_LAST       0x0001
+#define HID_FILE_STREAM_FLAG_ERROR      0x0002
+/* File streaming export: number of chunks sent for each host request */
+#define HID_FILE_STREAM_BURST_LENGTH    8
+
 /* Typedefs */
 typedef struct
 {
@@ -205,6 +232,39 @@ typedef struct
     cust_char_t category_strings[4][33];
 } hid_message_get_set_category_strings_t;
 
+typedef struct
+{
+    uint16_t mode;
+    uint16_t nb_nodes;
+    uint16_t addresses[0];
+} hid_message_read_nodes_req_t;
+
+typedef struct
+{
+    uint16_t node_address;
+    uint16_t node_length;
+    uint8_t node[0];
+} hid_message_node_with_addr_t;
+
+typedef struct
+{
+    uint16_t nb_nodes;
+    uint16_t last_packet_flag;
+    uint8_t nodes[0];
+} hid_message_read_nodes_answer_t;
+
+typedef struct
+{
+    uint16_t nb_nodes;
+    uint8_t nodes[0];
+} hid_message_write_nodes_req_t;
+
+typedef struct
+{
+    uint16_t nb_nodes;
+    uint16_t node_written_flags[(AUX_MCU_MSG_PAYLOAD_LENGTH-sizeof(uint16_t)-sizeof(uint16_t)-sizeof(uint16_t))/sizeof(uint16_t)];
+} hid_message_write_nodes_answer_t;
+
 typedef struct
 {
     cpz_lut_entry_t cpz_lut_entry;
@@ -237,6 +297,40 @@ typedef struct
     uint16_t last_chunk_flag;
 } hid_message_store_data_into_file_t;
 
+typedef struct
+{
+    uint16_t sequence_number;
+    uint16_t flags;
+    uint8_t chunk[256];
+} hid_message_bundle_stream_chunk_t;
+
+typedef struct
+{
+    uint16_t next_sequence_number;
+    uint16_t gap_detected;
+} hid_message_bundle_stream_ack_t;
+
+typedef struct
+{
+    uint16_t next_sequence_number;
+    uint16_t flags;
+    cust_char_t service_name[0];
+} hid_message_file_stream_req_t;
+
+typedef struct
+{
+    uint16_t sequence_number;
+    uint16_t flags;
+    uint8_t data[AUX_MCU_MSG_PAYLOAD_LENGTH-sizeof(uint16_t)-sizeof(uint16_t)-sizeof(uint16_t)-sizeof(uint16_t)];
+} hid_message_file_stream_chunk_t;
+
+typedef struct
+{
+    uint16_t first_block;
+    uint16_t nb_blocks;
+    uint32_t block_crc32s[(AUX_MCU_MSG_PAYLOAD_LENGTH-sizeof(uint16_t)-sizeof(uint16_t)-sizeof(uint16_t)-sizeof(uint16_t))/sizeof(uint32_t)];
+} hid_message_bundle_block_crcs_t;
+
 typedef struct
 {
     uint16_t message_type;
@@ -260,6 +354,15 @@ typedef struct
         hid_message_store_data_into_file_t store_data_in_file;
         hid_message_get_set_category_strings_t get_set_cat_strings;
         hid_message_setup_existing_user_req_t setup_existing_user_req;
+        hid_message_read_nodes_answer_t read_nodes_answer;
+        hid_message_read_nodes_req_t read_nodes_request;
+        hid_message_write_nodes_answer_t write_nodes_answer;
+        hid_message_write_nodes_req_t write_nodes_request;
+        hid_message_bundle_stream_chunk_t bundle_stream_chunk;
+        hid_message_bundle_stream_ack_t bundle_stream_ack;
+        hid_message_bundle_block_crcs_t bundle_block_crcs;
+        hid_message_file_stream_req_t file_stream_request;
+        hid_message_file_stream_chunk_t file_stream_chunk;
     };
 } hid_message_t;
 
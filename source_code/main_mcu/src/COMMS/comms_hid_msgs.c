@@ -51,6 +51,22 @@
 #include "rng.h"
 /* Boolean to specify if bundle data upload is allowed */
 BOOL comms_hid_msgs_bundle_upload_allowed = FALSE;
+/* Bundle streaming: next expected chunk sequence number */
+uint16_t comms_hid_msgs_bundle_stream_next_seq_nb = 0;
+/* Bundle streaming: set when a sequence gap was reported to the host, until it is filled */
+BOOL comms_hid_msgs_bundle_stream_gap_reported = FALSE;
+/* File streaming export: set while an export is ongoing */
+BOOL comms_hid_msgs_file_stream_ongoing = FALSE;
+/* File streaming export: set once the last data node was fetched */
+BOOL comms_hid_msgs_file_stream_all_data_fetched = FALSE;
+/* File streaming export: interface and data type of the ongoing export */
+BOOL comms_hid_msgs_file_stream_from_usb = FALSE;
+nodemgmt_data_category_te comms_hid_msgs_file_stream_data_type = NODEMGMT_STANDARD_DATA_TYPE_ID;
+/* File streaming export: sequence number of the next chunk to be sent */
+uint16_t comms_hid_msgs_file_stream_next_seq_nb = 0;
+/* File streaming export: decrypted data read ahead and not sent yet, room for a full chunk and one more data node */
+uint8_t comms_hid_msgs_file_stream_buffer[MEMBER_SIZE(hid_message_file_stream_chunk_t, data) + MEMBER_SIZE(child_data_node_t, data) + MEMBER_SIZE(child_data_node_t, data2)];
+uint16_t comms_hid_msgs_file_stream_buffer_fill = 0;
 
 
 /*! \fn     comms_hid_msgs_fill_get_status_message_answer(uint16_t* msg_array_uint16)
@@ -204,6 +220,211 @@ void comms_hid_msgs_send_ack_nack_message(BOOL usb_hid_message, uint16_t message
     comms_aux_mcu_send_message(temp_tx_message_pt);
 }
 
+/*! \fn     comms_hid_msgs_reset_bundle_stream(uint16_t next_sequence_number)
+*   \brief  Reset the bundle streaming state, to be called when (part of) the dataflash is erased
+*   \param  next_sequence_number    Sequence number of the first chunk to be written
+*/
+void comms_hid_msgs_reset_bundle_stream(uint16_t next_sequence_number)
+{
+    comms_hid_msgs_bundle_stream_next_seq_nb = next_sequence_number;
+    comms_hid_msgs_bundle_stream_gap_reported = FALSE;
+}
+
+/*! \fn     comms_hid_msgs_send_bundle_stream_ack(BOOL usb_hid_message, uint16_t message_type, BOOL gap_detected)
+*   \brief  Send a cumulative acknowledgement for the bundle stream
+*   \param  usb_hid_message TRUE for USB HID message
+*   \param  message_type    Message type for the acknowledgement
+*   \param  gap_detected    TRUE to let the host know that it should resend from the acknowledged sequence number
+*/
+static void comms_hid_msgs_send_bundle_stream_ack(BOOL usb_hid_message, uint16_t message_type, BOOL gap_detected)
+{
+    aux_mcu_message_t* temp_tx_message_pt = comms_hid_msgs_get_empty_hid_packet(usb_hid_message, message_type, sizeof(temp_tx_message_pt->hid_message.bundle_stream_ack));
+    temp_tx_message_pt->hid_message.bundle_stream_ack.next_sequence_number = comms_hid_msgs_bundle_stream_next_seq_nb;
+    temp_tx_message_pt->hid_message.bundle_stream_ack.gap_detected = (uint16_t)gap_detected;
+    comms_aux_mcu_send_message(temp_tx_message_pt);
+}
+
+/*! \fn     comms_hid_msgs_parse_bundle_stream_chunk(hid_message_t* rcv_msg, BOOL is_message_from_usb, uint16_t message_type)
+*   \brief  Parse a sequence numbered bundle chunk: chunk N is written at address N*256
+*   \param  rcv_msg             Received message
+*   \param  is_message_from_usb Boolean set to TRUE if message comes from USB
+*   \param  message_type        Message type for the acknowledgements
+*   \note   Chunks are programmed without waiting for the page program to end, so the flash writes while the next chunk is received
+*   \note   In order chunks are acknowledged every HID_BUNDLE_STREAM_ACK_INTERVAL chunks or when the host asks for it, a gap is reported once
+*/
+void comms_hid_msgs_parse_bundle_stream_chunk(hid_message_t* rcv_msg, BOOL is_message_from_usb, uint16_t message_type)
+{
+    hid_message_bundle_stream_chunk_t* chunk_pt = &rcv_msg->bundle_stream_chunk;
+    uint16_t chunk_length = rcv_msg->payload_length - sizeof(chunk_pt->sequence_number) - sizeof(chunk_pt->flags);
+    uint32_t write_address = (uint32_t)chunk_pt->sequence_number * sizeof(chunk_pt->chunk);
+    BOOL ack_requested = FALSE;
+    
+    /* Check for correct payload length and address */
+    if ((rcv_msg->payload_length <= sizeof(chunk_pt->sequence_number) + sizeof(chunk_pt->flags)) || (chunk_length > sizeof(chunk_pt->chunk)) || (write_address + chunk_length > W25Q16_FLASH_SIZE))
+    {
+        comms_hid_msgs_send_ack_nack_message(is_message_from_usb, message_type, FALSE);
+        return;
+    }
+    
+    /* Did the host ask for an acknowledgement? */
+    if ((chunk_pt->flags & HID_BUNDLE_STREAM_FLAG_ACK_REQ) != 0)
+    {
+        ack_requested = TRUE;
+    }
+    
+    if (chunk_pt->sequence_number == comms_hid_msgs_bundle_stream_next_seq_nb)
+    {
+        /* Expected chunk: start programming it, previous page program is waited for inside */
+        dataflash_write_page_without_wait(&dataflash_descriptor, write_address, chunk_pt->chunk, chunk_length);
+        comms_hid_msgs_bundle_stream_next_seq_nb++;
+        comms_hid_msgs_bundle_stream_gap_reported = FALSE;
+        
+        /* Cumulative acknowledgement */
+        if ((ack_requested != FALSE) || ((comms_hid_msgs_bundle_stream_next_seq_nb % HID_BUNDLE_STREAM_ACK_INTERVAL) == 0))
+        {
+            comms_hid_msgs_send_bundle_stream_ack(is_message_from_usb, message_type, FALSE);
+        }
+    }
+    else if (chunk_pt->sequence_number > comms_hid_msgs_bundle_stream_next_seq_nb)
+    {
+        /* Chunk(s) lost: chunk discarded, ask for retransmission once, host will go back to the acknowledged sequence number */
+        if (comms_hid_msgs_bundle_stream_gap_reported == FALSE)
+        {
+            comms_hid_msgs_bundle_stream_gap_reported = TRUE;
+            comms_hid_msgs_send_bundle_stream_ack(is_message_from_usb, message_type, TRUE);
+        }
+    }
+    else if (ack_requested != FALSE)
+    {
+        /* Already written chunk (retransmission): data can't be programmed twice, only acknowledge */
+        comms_hid_msgs_send_bundle_stream_ack(is_message_from_usb, message_type, FALSE);
+    }
+}
+
+/*! \fn     comms_hid_msgs_end_file_stream(void)
+*   \brief  End the file streaming export, clearing the decrypted data it buffered
+*   \note   Also called when the user logs out or the card is removed
+*/
+void comms_hid_msgs_end_file_stream(void)
+{
+    comms_hid_msgs_file_stream_ongoing = FALSE;
+    memset((void*)comms_hid_msgs_file_stream_buffer, 0, sizeof(comms_hid_msgs_file_stream_buffer));
+    comms_hid_msgs_file_stream_buffer_fill = 0;
+}
+
+/*! \fn     comms_hid_msgs_send_file_stream_error(BOOL usb_hid_message, uint16_t message_type)
+*   \brief  End the file streaming export and let the host know it was aborted
+*   \param  usb_hid_message     TRUE for USB HID message
+*   \param  message_type        HID message type
+*/
+static void comms_hid_msgs_send_file_stream_error(BOOL usb_hid_message, uint16_t message_type)
+{
+    comms_hid_msgs_end_file_stream();
+    
+    aux_mcu_message_t* temp_tx_message_pt = comms_hid_msgs_get_empty_hid_packet(usb_hid_message, message_type, sizeof(temp_tx_message_pt->hid_message.file_stream_chunk.sequence_number) + sizeof(temp_tx_message_pt->hid_message.file_stream_chunk.flags));
+    temp_tx_message_pt->hid_message.file_stream_chunk.sequence_number = comms_hid_msgs_file_stream_next_seq_nb;
+    temp_tx_message_pt->hid_message.file_stream_chunk.flags = HID_FILE_STREAM_FLAG_ERROR;
+    comms_aux_mcu_send_message(temp_tx_message_pt);
+}
+
+/*! \fn     comms_hid_msgs_file_stream_read_ahead(void)
+*   \brief  Fetch and decrypt data nodes of the ongoing export until a full chunk is buffered or all data was fetched
+*   \return success or not
+*/
+static RET_TYPE comms_hid_msgs_file_stream_read_ahead(void)
+{
+    while ((comms_hid_msgs_file_stream_all_data_fetched == FALSE) && (comms_hid_msgs_file_stream_buffer_fill < MEMBER_SIZE(hid_message_file_stream_chunk_t, data)))
+    {
+        uint16_t decrypted_bytes_nb = 0;
+        
+        /* Decrypt the next node right after the buffered data (nb of bytes is sanitized by the logic_user call) */
+        if (logic_user_get_data_from_service((cust_char_t*)0, &comms_hid_msgs_file_stream_buffer[comms_hid_msgs_file_stream_buffer_fill], &decrypted_bytes_nb, comms_hid_msgs_file_stream_from_usb, comms_hid_msgs_file_stream_data_type) != RETURN_OK)
+        {
+            return RETURN_NOK;
+        }
+        
+        /* No bytes: end of file */
+        if (decrypted_bytes_nb == 0)
+        {
+            comms_hid_msgs_file_stream_all_data_fetched = TRUE;
+        }
+        comms_hid_msgs_file_stream_buffer_fill += decrypted_bytes_nb;
+    }
+    
+    return RETURN_OK;
+}
+
+/*! \fn     comms_hid_msgs_send_file_stream_burst(BOOL usb_hid_message, uint16_t message_type)
+*   \brief  Send up to HID_FILE_STREAM_BURST_LENGTH full chunks of the ongoing export
+*   \param  usb_hid_message     TRUE for USB HID message
+*   \param  message_type        HID message type
+*   \note   The next data nodes are fetched and decrypted while each chunk is being transmitted
+*   \note   As the aux MCU only has one receive buffer per interface, the next chunk is only sent once the aux MCU reports it forwarded the previous one
+*   \note   HID requests received while waiting for the aux MCU are ignored (MSG_RESTRICT_ALL), they can't abort the burst
+*/
+static void comms_hid_msgs_send_file_stream_burst(BOOL usb_hid_message, uint16_t message_type)
+{
+    for (uint16_t i = 0; i < HID_FILE_STREAM_BURST_LENGTH; i++)
+    {
+        /* Fill the chunk to capacity */
+        uint16_t chunk_data_length = comms_hid_msgs_file_stream_buffer_fill;
+        if (chunk_data_length > MEMBER_SIZE(hid_message_file_stream_chunk_t, data))
+        {
+            chunk_data_length = MEMBER_SIZE(hid_message_file_stream_chunk_t, data);
+        }
+        
+        /* Last chunk if all data was fetched and fits inside it */
+        BOOL is_last_chunk = ((comms_hid_msgs_file_stream_all_data_fetched != FALSE) && (chunk_data_length == comms_hid_msgs_file_stream_buffer_fill))?TRUE:FALSE;
+        BOOL more_chunks_in_burst = ((is_last_chunk == FALSE) && (i + 1 < HID_FILE_STREAM_BURST_LENGTH))?TRUE:FALSE;
+        
+        /* Create chunk message */
+        aux_mcu_message_t* temp_tx_message_pt = comms_hid_msgs_get_empty_hid_packet(usb_hid_message, message_type, sizeof(temp_tx_message_pt->hid_message.file_stream_chunk.sequence_number) + sizeof(temp_tx_message_pt->hid_message.file_stream_chunk.flags) + chunk_data_length);
+        temp_tx_message_pt->hid_message.file_stream_chunk.sequence_number = comms_hid_msgs_file_stream_next_seq_nb++;
+        temp_tx_message_pt->hid_message.file_stream_chunk.flags = (is_last_chunk != FALSE)?HID_FILE_STREAM_FLAG_LAST:0;
+        memcpy((void*)temp_tx_message_pt->hid_message.file_stream_chunk.data, (void*)comms_hid_msgs_file_stream_buffer, chunk_data_length);
+        temp_tx_message_pt->tx_sent_notif_req_flag = (is_last_chunk == FALSE)?TRUE:FALSE;
+        comms_aux_mcu_send_message(temp_tx_message_pt);
+        
+        /* Export done */
+        if (is_last_chunk != FALSE)
+        {
+            comms_hid_msgs_end_file_stream();
+            break;
+        }
+        
+        /* Remove sent data and read the next nodes ahead while the chunk is transmitted */
+        memmove((void*)comms_hid_msgs_file_stream_buffer, (void*)&comms_hid_msgs_file_stream_buffer[chunk_data_length], comms_hid_msgs_file_stream_buffer_fill - chunk_data_length);
+        comms_hid_msgs_file_stream_buffer_fill -= chunk_data_length;
+        RET_TYPE read_ahead_return = comms_hid_msgs_file_stream_read_ahead();
+        
+        /* Wait for the aux MCU to forward our chunk, even at the end of the burst as an error chunk may follow */
+        aux_mcu_message_t* temp_rx_message;
+        if (comms_aux_mcu_active_wait(&temp_rx_message, AUX_MCU_MSG_TYPE_AUX_MCU_EVENT, FALSE, AUX_MCU_EVENT_HID_MSG_SENT) != RETURN_OK)
+        {
+            /* Host will request the next chunks, an export with a read error can't continue */
+            if (read_ahead_return != RETURN_OK)
+            {
+                comms_hid_msgs_end_file_stream();
+            }
+            break;
+        }
+        comms_aux_arm_rx_and_clear_no_comms();
+        
+        /* Read error */
+        if (read_ahead_return != RETURN_OK)
+        {
+            comms_hid_msgs_send_file_stream_error(usb_hid_message, message_type);
+            break;
+        }
+        
+        /* End of burst */
+        if (more_chunks_in_burst == FALSE)
+        {
+            break;
+        }
+    }
+}
+
 /*! \fn     comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_length, msg_restrict_type_te answer_restrict_type, BOOL is_message_from_usb)
 *   \brief  Parse an incoming message from USB or BLE
 *   \param  rcv_msg                 Received message
@@ -296,6 +517,10 @@ void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_leng
     (rcv_msg->message_type != HID_CMD_GET_DEVICE_STATUS) &&
     (rcv_msg->message_type != HID_CMD_START_BUNDLE_UL) &&
     (rcv_msg->message_type != HID_CMD_BUNDLE_WRITE_256B) &&
+    (rcv_msg->message_type != HID_CMD_BUNDLE_WRITE_STREAM) &&
+    (rcv_msg->message_type != HID_CMD_START_BUNDLE_DELTA) &&
+    (rcv_msg->message_type != HID_CMD_GET_BUNDLE_BLK_CRCS) &&
+    (rcv_msg->message_type != HID_CMD_ERASE_BUNDLE_BLOCK) &&
     (rcv_msg->message_type != HID_CMD_BUNDLE_UL_DONE) &&
     (rcv_msg->message_type != HID_CMD_ID_CANCEL_REQ) &&
     (rcv_msg->message_type != HID_CMD_IM_LOCKED) &&
@@ -785,6 +1010,8 @@ void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_leng
             {
                 /* Store new address */
                 nodemgmt_set_cred_start_address(rcv_msg->payload_as_uint16[1], rcv_msg->payload_as_uint16[0]);
+                nodemgmt_invalidate_service_index();
+                nodemgmt_invalidate_category_cache();
 
                 /* Set success byte */
                 comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, TRUE);
@@ -805,6 +1032,7 @@ void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_leng
             {
                 /* Store new address */
                 nodemgmt_set_data_start_address(rcv_msg->payload_as_uint16[1], rcv_msg->payload_as_uint16[0]);
+                nodemgmt_invalidate_service_index();
 
                 /* Set success byte */
                 comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, TRUE);
@@ -825,6 +1053,8 @@ void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_leng
             {
                 /* Store new addresses */
                 nodemgmt_set_start_addresses(rcv_msg->payload_as_uint16);
+                nodemgmt_invalidate_service_index();
+                nodemgmt_invalidate_category_cache();
 
                 /* Set success byte */
                 comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, TRUE);
@@ -875,6 +1105,9 @@ void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_leng
                 gui_dispatcher_set_current_screen(GUI_SCREEN_MAIN_MENU, TRUE, GUI_INTO_MENU_TRANSITION);
                 gui_dispatcher_get_back_to_current_screen();
                 nodemgmt_scan_node_usage();
+                
+                /* Write back coalesced database changes */
+                dbflash_flush_cache(&dbflash_descriptor);
             }
             
             /* Set ack, leave same command id */
@@ -1030,6 +1263,151 @@ void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_leng
             }
         }
 
+        case HID_CMD_READ_NODES:
+        {
+            /* Check message length, mode and number of nodes */
+            if ((rcv_msg->payload_length < offsetof(hid_message_read_nodes_req_t, addresses) + sizeof(uint16_t)) || \
+                (rcv_msg->read_nodes_request.mode > HID_READ_NODES_MODE_FOLLOW) || \
+                (rcv_msg->read_nodes_request.nb_nodes == 0) || \
+                (rcv_msg->read_nodes_request.nb_nodes > HID_READ_NODES_MAX_NB_NODES) || \
+                ((rcv_msg->read_nodes_request.mode == HID_READ_NODES_MODE_LIST) && (rcv_msg->read_nodes_request.nb_nodes > (rcv_msg->payload_length - offsetof(hid_message_read_nodes_req_t, addresses))/sizeof(uint16_t))))
+            {
+                /* Set nack, leave same command id */
+                comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, FALSE);
+                return;
+            }
+            
+            uint16_t nb_nodes_to_read = rcv_msg->read_nodes_request.nb_nodes;
+            uint16_t node_addr = rcv_msg->read_nodes_request.addresses[0];
+            uint16_t read_mode = rcv_msg->read_nodes_request.mode;
+            uint16_t node_addresses[HID_READ_NODES_MAX_NB_NODES];
+            aux_mcu_message_t* temp_tx_message_pt = 0;
+            uint16_t answer_length = 0;
+            
+            /* The received message is overwritten while we wait for the aux MCU to forward our packets */
+            if (read_mode == HID_READ_NODES_MODE_LIST)
+            {
+                memcpy(node_addresses, rcv_msg->read_nodes_request.addresses, nb_nodes_to_read*sizeof(uint16_t));
+            }
+            
+            /* Stream back as many nodes as possible per packet */
+            for (uint16_t i = 0; i < nb_nodes_to_read; i++)
+            {
+                uint16_t next_node_addr = NODE_ADDR_NULL;
+                node_type_te temp_node_type = NODE_TYPE_NULL;
+                uint16_t node_length = 0;
+                
+                /* Address list mode */
+                if (read_mode == HID_READ_NODES_MODE_LIST)
+                {
+                    node_addr = node_addresses[i];
+                }
+                
+                /* Same checks as for single node read, node length set to 0 when not allowed */
+                if ((nodemgmt_check_address_validity(node_addr) == RETURN_OK) && (nodemgmt_check_user_permission(node_addr, &temp_node_type) == RETURN_OK))
+                {
+                    if ((temp_node_type == NODE_TYPE_PARENT) || (temp_node_type == NODE_TYPE_PARENT_DATA) || (temp_node_type == NODE_TYPE_NULL))
+                    {
+                        node_length = sizeof(parent_node_t);
+                    } 
+                    else
+                    {
+                        node_length = sizeof(child_node_t);
+                    }
+                    
+                    /* Node can't fit in a packet (eg: AES-GCM messages) */
+                    if (offsetof(hid_message_read_nodes_answer_t, nodes) + sizeof(hid_message_node_with_addr_t) + node_length > max_payload_size)
+                    {
+                        node_length = 0;
+                    }
+                }
+                
+                /* Send current packet if the node doesn't fit */
+                if ((temp_tx_message_pt != 0) && (answer_length + sizeof(hid_message_node_with_addr_t) + node_length > max_payload_size))
+                {
+                    comms_hid_msgs_update_message_payload_length_fields(temp_tx_message_pt, answer_length);
+                    temp_tx_message_pt->tx_sent_notif_req_flag = TRUE;
+                    comms_aux_mcu_send_message(temp_tx_message_pt);
+                    temp_tx_message_pt = 0;
+                    
+                    /* The aux MCU only has one receive buffer per interface: wait for it to forward our packet */
+                    aux_mcu_message_t* temp_rx_message;
+                    if (comms_aux_mcu_active_wait(&temp_rx_message, AUX_MCU_MSG_TYPE_AUX_MCU_EVENT, FALSE, AUX_MCU_EVENT_HID_MSG_SENT) != RETURN_OK)
+                    {
+                        /* Host won't get the last packet flag and will request the nodes again */
+                        return;
+                    }
+                    comms_aux_arm_rx_and_clear_no_comms();
+                }
+                
+                /* Get new packet if needed */
+                if (temp_tx_message_pt == 0)
+                {
+                    temp_tx_message_pt = comms_hid_msgs_get_empty_hid_packet(is_message_from_usb, rcv_message_type, 0);
+                    answer_length = offsetof(hid_message_read_nodes_answer_t, nodes);
+                }
+                
+                /* Node address & length, then contents */
+                hid_message_node_with_addr_t* node_in_answer_pt = (hid_message_node_with_addr_t*)&temp_tx_message_pt->hid_message.payload[answer_length];
+                node_in_answer_pt->node_address = node_addr;
+                node_in_answer_pt->node_length = node_length;
+                if (node_length == sizeof(parent_node_t))
+                {
+                    nodemgmt_read_parent_node_data_block_from_flash(node_addr, (parent_node_t*)node_in_answer_pt->node);
+                    if (temp_node_type != NODE_TYPE_NULL)
+                    {
+                        next_node_addr = ((parent_node_t*)node_in_answer_pt->node)->cred_parent.nextParentAddress;
+                    }
+                }
+                else if (node_length == sizeof(child_node_t))
+                {
+                    nodemgmt_read_child_node_data_block_from_flash(node_addr, (child_node_t*)node_in_answer_pt->node);
+                    if (temp_node_type == NODE_TYPE_DATA)
+                    {
+                        next_node_addr = ((child_node_t*)node_in_answer_pt->node)->data_child.nextDataAddress;
+                    }
+                    else
+                    {
+                        next_node_addr = ((child_node_t*)node_in_answer_pt->node)->cred_child.nextChildAddress;
+                    }
+                }
+                temp_tx_message_pt->hid_message.read_nodes_answer.nb_nodes++;
+                answer_length += sizeof(hid_message_node_with_addr_t) + node_length;
+                
+                /* Stop at the first node we couldn't read, whatever the mode */
+                if (node_length == 0)
+                {
+                    break;
+                }
+                
+                /* Compute next address to read */
+                if (read_mode == HID_READ_NODES_MODE_RANGE)
+                {
+                    /* Child nodes take 2 node slots */
+                    node_addr = nodemgmt_get_incremented_address(node_addr);
+                    if (node_length == sizeof(child_node_t))
+                    {
+                        node_addr = nodemgmt_get_incremented_address(node_addr);
+                    }
+                }
+                else if (read_mode == HID_READ_NODES_MODE_FOLLOW)
+                {
+                    /* Stop at the end of the chain */
+                    if (next_node_addr == NODE_ADDR_NULL)
+                    {
+                        break;
+                    }
+                    node_addr = next_node_addr;
+                }
+            }
+            
+            /* Send last packet */
+            temp_tx_message_pt->hid_message.read_nodes_answer.last_packet_flag = TRUE;
+            comms_hid_msgs_update_message_payload_length_fields(temp_tx_message_pt, answer_length);
+            comms_aux_mcu_send_message(temp_tx_message_pt);
+            return;
+        }
+
         case HID_CMD_WRITE_NODE:
         {
             node_type_te temp_node_type_te;
@@ -1041,6 +1419,7 @@ void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_leng
             {
                 /* big node */
                 nodemgmt_write_child_node_block_to_flash(rcv_msg->payload_as_uint16[0], (child_node_t*)&(rcv_msg->payload_as_uint16[1]), FALSE);
+                nodemgmt_invalidate_category_cache();
 
                 /* Set success byte */
                 comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, TRUE);
@@ -1051,6 +1430,8 @@ void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_leng
             {
                 /* small node */
                 nodemgmt_write_parent_node_data_block_to_flash(rcv_msg->payload_as_uint16[0], (parent_node_t*)&(rcv_msg->payload_as_uint16[1]));
+                nodemgmt_invalidate_service_index();
+                nodemgmt_invalidate_category_cache();
 
                 /* Set success byte */
                 comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, TRUE);
@@ -1064,6 +1445,79 @@ void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_leng
             }
         }
 
+        case HID_CMD_WRITE_NODES:
+        {
+            uint16_t node_addresses[NODEMGMT_MAX_SLOTS_PER_BATCH_WRITE];
+            uint16_t node_lengths[NODEMGMT_MAX_SLOTS_PER_BATCH_WRITE];
+            uint8_t* node_pts[NODEMGMT_MAX_SLOTS_PER_BATCH_WRITE];
+            BOOL node_written[NODEMGMT_MAX_SLOTS_PER_BATCH_WRITE];
+            uint16_t parsed_length = offsetof(hid_message_write_nodes_req_t, nodes);
+            uint16_t nb_nodes_to_write = 0;
+            uint16_t nb_nodes = 0;
+            
+            /* Check message length & number of nodes */
+            if ((rcv_msg->payload_length < parsed_length) || (rcv_msg->write_nodes_request.nb_nodes == 0) || (rcv_msg->write_nodes_request.nb_nodes > NODEMGMT_MAX_SLOTS_PER_BATCH_WRITE))
+            {
+                /* Set failure byte */
+                comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, FALSE);
+                return;
+            }
+            nb_nodes = rcv_msg->write_nodes_request.nb_nodes;
+            
+            /* Parse (address, node) tuples, same permission checks as single node write */
+            for (uint16_t i = 0; i < nb_nodes; i++)
+            {
+                hid_message_node_with_addr_t* node_in_msg_pt = (hid_message_node_with_addr_t*)&rcv_msg->payload[parsed_length];
+                node_type_te temp_node_type_te;
+                
+                /* Check that the tuple is within the message */
+                if ((parsed_length + sizeof(hid_message_node_with_addr_t) > rcv_msg->payload_length) || (parsed_length + sizeof(hid_message_node_with_addr_t) + node_in_msg_pt->node_length > rcv_msg->payload_length))
+                {
+                    /* Set failure byte */
+                    comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, FALSE);
+                    return;
+                }
+                parsed_length += sizeof(hid_message_node_with_addr_t) + node_in_msg_pt->node_length;
+                node_written[i] = FALSE;
+                
+                if (((node_in_msg_pt->node_length == sizeof(child_node_t)) \
+                        && (nodemgmt_check_address_validity(node_in_msg_pt->node_address) == RETURN_OK) \
+                        && (nodemgmt_check_address_validity(nodemgmt_get_incremented_address(node_in_msg_pt->node_address)) == RETURN_OK) \
+                        && (nodemgmt_check_user_permission(node_in_msg_pt->node_address, &temp_node_type_te) == RETURN_OK) \
+                        && (nodemgmt_check_user_permission(nodemgmt_get_incremented_address(node_in_msg_pt->node_address), &temp_node_type_te) == RETURN_OK)) || \
+                    ((node_in_msg_pt->node_length == sizeof(parent_node_t)) \
+                        && (nodemgmt_check_address_validity(node_in_msg_pt->node_address) == RETURN_OK) \
+                        && (nodemgmt_check_user_permission(node_in_msg_pt->node_address, &temp_node_type_te) == RETURN_OK)))
+                {
+                    node_addresses[nb_nodes_to_write] = node_in_msg_pt->node_address;
+                    node_lengths[nb_nodes_to_write] = node_in_msg_pt->node_length;
+                    node_pts[nb_nodes_to_write++] = node_in_msg_pt->node;
+                    node_written[i] = TRUE;
+                }
+            }
+            
+            /* Write the allowed nodes, grouped by flash page */
+            if (nb_nodes_to_write != 0)
+            {
+                if (nodemgmt_write_node_blocks_to_flash(nb_nodes_to_write, node_addresses, node_lengths, node_pts) != RETURN_OK)
+                {
+                    memset(node_written, 0, sizeof(node_written));
+                }
+                nodemgmt_invalidate_service_index();
+                nodemgmt_invalidate_category_cache();
+            }
+            
+            /* Per node status */
+            aux_mcu_message_t* temp_tx_message_pt = comms_hid_msgs_get_empty_hid_packet(is_message_from_usb, rcv_message_type, offsetof(hid_message_write_nodes_answer_t, node_written_flags) + nb_nodes*sizeof(uint16_t));
+            temp_tx_message_pt->hid_message.write_nodes_answer.nb_nodes = nb_nodes;
+            for (uint16_t i = 0; i < nb_nodes; i++)
+            {
+                temp_tx_message_pt->hid_message.write_nodes_answer.node_written_flags[i] = (node_written[i] != FALSE)? TRUE : FALSE;
+            }
+            comms_aux_mcu_send_message(temp_tx_message_pt);
+            return;
+        }
+
         case HID_CMD_GET_USER_CHANGE_NB :
         {
             /* Smartcard unlocked? */
@@ -1734,6 +2188,71 @@ void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_leng
             }        
         }
         
+        case HID_CMD_GET_FILE_STREAM:
+        {
+            hid_message_file_stream_req_t* file_stream_req_pt = &rcv_msg->file_stream_request;
+            uint16_t file_stream_req_header_size = sizeof(file_stream_req_pt->next_sequence_number) + sizeof(file_stream_req_pt->flags);
+            
+            /* Malformed request or no unlocked card: abort export */
+            if ((rcv_msg->payload_length < file_stream_req_header_size) || (logic_security_is_smc_inserted_unlocked() == FALSE))
+            {
+                comms_hid_msgs_send_file_stream_error(is_message_from_usb, rcv_message_type);
+                return;
+            }
+            
+            /* Request for the next chunks: the host acknowledges all the chunks before the requested one */
+            if (rcv_msg->payload_length == file_stream_req_header_size)
+            {
+                if ((comms_hid_msgs_file_stream_ongoing != FALSE) && (comms_hid_msgs_file_stream_from_usb == is_message_from_usb) && (file_stream_req_pt->next_sequence_number == comms_hid_msgs_file_stream_next_seq_nb))
+                {
+                    comms_hid_msgs_send_file_stream_burst(is_message_from_usb, rcv_message_type);
+                }
+                else
+                {
+                    /* Chunk lost or no export: host needs to restart the export */
+                    comms_hid_msgs_send_file_stream_error(is_message_from_usb, rcv_message_type);
+                }
+                return;
+            }
+            
+            /* New export: input sanitazing */
+            uint16_t max_cust_char_length = (max_payload_size - file_stream_req_header_size)/sizeof(cust_char_t);
+            uint16_t string_length = utils_strnlen(file_stream_req_pt->service_name, max_cust_char_length);
+            
+            /* Check for valid length, not exceeding payload size */
+            if ((string_length >= max_cust_char_length) || ((string_length + 1) != ((rcv_msg->payload_length - file_stream_req_header_size) / (uint16_t)sizeof(cust_char_t))))
+            {
+                comms_hid_msgs_send_file_stream_error(is_message_from_usb, rcv_message_type);
+                return;
+            }
+            
+            /* Reset export */
+            comms_hid_msgs_end_file_stream();
+            comms_hid_msgs_file_stream_all_data_fetched = FALSE;
+            comms_hid_msgs_file_stream_from_usb = is_message_from_usb;
+            comms_hid_msgs_file_stream_data_type = ((file_stream_req_pt->flags & HID_FILE_STREAM_REQ_FLAG_NOTE) != 0)?NODEMGMT_NOTES_DATA_TYPE_ID:NODEMGMT_STANDARD_DATA_TYPE_ID;
+            comms_hid_msgs_file_stream_next_seq_nb = 0;
+            
+            /* Query user and get the first node, then fill our first chunk */
+            if (logic_user_get_data_from_service(file_stream_req_pt->service_name, comms_hid_msgs_file_stream_buffer, &comms_hid_msgs_file_stream_buffer_fill, is_message_from_usb, comms_hid_msgs_file_stream_data_type) == RETURN_OK)
+            {
+                comms_hid_msgs_file_stream_ongoing = TRUE;
+                if (comms_hid_msgs_file_stream_buffer_fill == 0)
+                {
+                    comms_hid_msgs_file_stream_all_data_fetched = TRUE;
+                }
+                if (comms_hid_msgs_file_stream_read_ahead() == RETURN_OK)
+                {
+                    comms_hid_msgs_send_file_stream_burst(is_message_from_usb, rcv_message_type);
+                    return;
+                }
+            }
+            
+            /* Set failure flag */
+            comms_hid_msgs_send_file_stream_error(is_message_from_usb, rcv_message_type);
+            return;
+        }
+        
         case HID_CMD_TEST_FILE_ID:
         {
             /* Input sanitazing */
@@ -2139,18 +2658,23 @@ void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_leng
         }
         
         case HID_CMD_START_BUNDLE_UL:
+        case HID_CMD_START_BUNDLE_DELTA:
         {
             /* Required actions when we start dealing with graphics memory */
             if ((is_message_from_usb != FALSE) && (rcv_msg->payload_length == (AES_BLOCK_SIZE/8)) && (logic_device_bundle_update_start(FALSE, rcv_msg->payload) == RETURN_OK))
             {
                 /* Set bundle upload allowed boolean */
                 comms_hid_msgs_bundle_upload_allowed = TRUE;
+                comms_hid_msgs_reset_bundle_stream(0);
                 
                 /* Set state changed */
                 logic_device_set_state_changed();
                 
-                /* Erase data flash */
-                dataflash_bulk_erase_with_wait(&dataflash_descriptor);
+                /* Erase data flash, delta update: blocks are erased by the host using HID_CMD_ERASE_BUNDLE_BLOCK */
+                if (rcv_msg->message_type == HID_CMD_START_BUNDLE_UL)
+                {
+                    dataflash_bulk_erase_with_wait(&dataflash_descriptor);
+                }
                 
                 /* Set ack, leave same command id */
                 comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, TRUE);
@@ -2184,10 +2708,83 @@ void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_leng
             }
         }
         
+        case HID_CMD_BUNDLE_WRITE_STREAM:
+        {
+            if (comms_hid_msgs_bundle_upload_allowed != FALSE)
+            {
+                comms_hid_msgs_parse_bundle_stream_chunk(rcv_msg, is_message_from_usb, rcv_message_type);
+                return;
+            }
+            else
+            {
+                /* Set nack, leave same command id */
+                comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, FALSE);
+                return;
+            }
+        }
+        
+        case HID_CMD_GET_BUNDLE_BLK_CRCS:
+        {
+            /* Request: first block & number of blocks, answer: same fields followed by the crc32s of the current dataflash blocks */
+            hid_message_bundle_block_crcs_t* block_crcs_req_pt = &rcv_msg->bundle_block_crcs;
+            if ((comms_hid_msgs_bundle_upload_allowed != FALSE) && (rcv_msg->payload_length == offsetof(hid_message_bundle_block_crcs_t, block_crc32s)) && (block_crcs_req_pt->nb_blocks != 0) && (block_crcs_req_pt->first_block < W25Q16_NB_BLOCKS) && (block_crcs_req_pt->nb_blocks <= W25Q16_NB_BLOCKS - block_crcs_req_pt->first_block))
+            {
+                uint16_t first_block = block_crcs_req_pt->first_block;
+                uint16_t nb_blocks = block_crcs_req_pt->nb_blocks;
+                aux_mcu_message_t* temp_tx_message_pt = comms_hid_msgs_get_empty_hid_packet(is_message_from_usb, rcv_message_type, offsetof(hid_message_bundle_block_crcs_t, block_crc32s) + nb_blocks*sizeof(uint32_t));
+                temp_tx_message_pt->hid_message.bundle_block_crcs.first_block = first_block;
+                temp_tx_message_pt->hid_message.bundle_block_crcs.nb_blocks = nb_blocks;
+                
+                /* Let a possibly ongoing page program finish before reading */
+                dataflash_wait_for_not_busy(&dataflash_descriptor);
+                
+                /* Compute crc32s */
+                for (uint16_t i = 0; i < nb_blocks; i++)
+                {
+                    temp_tx_message_pt->hid_message.bundle_block_crcs.block_crc32s[i] = custom_fs_compute_external_flash_crc32((first_block + i) * W25Q16_BLOCK_SIZE, W25Q16_BLOCK_SIZE);
+                }
+                
+                /* Send message */
+                comms_aux_mcu_send_message(temp_tx_message_pt);
+                return;
+            }
+            else
+            {
+                /* Set nack, leave same command id */
+                comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, FALSE);
+                return;
+            }
+        }
+        
+        case HID_CMD_ERASE_BUNDLE_BLOCK:
+        {
+            /* Erase a 64KB block and expect its first chunk in the bundle stream */
+            if ((comms_hid_msgs_bundle_upload_allowed != FALSE) && (rcv_msg->payload_length == sizeof(uint16_t)) && (rcv_msg->payload_as_uint16[0] < W25Q16_NB_BLOCKS))
+            {
+                uint16_t block_id = rcv_msg->payload_as_uint16[0];
+                dataflash_erase_64kb_block(&dataflash_descriptor, block_id * W25Q16_BLOCK_SIZE);
+                dataflash_wait_for_not_busy(&dataflash_descriptor);
+                comms_hid_msgs_reset_bundle_stream((uint16_t)(block_id * (W25Q16_BLOCK_SIZE / W25Q16_PAGE_SIZE)));
+                
+                /* Set ack, leave same command id */
+                comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, TRUE);
+                return;
+            }
+            else
+            {
+                /* Set nack, leave same command id */
+                comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, FALSE);
+                return;
+            }
+        }
+        
         case HID_CMD_BUNDLE_UL_DONE:
         {
             if (comms_hid_msgs_bundle_upload_allowed != FALSE)
             {
+                /* Last streamed chunk may still be programming */
+                dataflash_wait_for_not_busy(&dataflash_descriptor);
+                
                 /* Do required actions: depending on the mini BLE version, it's possible we don't come back from this function (bootloader launched) */
                 logic_device_bundle_update_end(FALSE);
                 
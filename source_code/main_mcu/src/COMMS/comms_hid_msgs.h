@@ -28,10 +28,13 @@
 
 /* Prototypes */
 void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_length, msg_restrict_type_te answer_restrict_type, BOOL is_message_from_usb);
+void comms_hid_msgs_parse_bundle_stream_chunk(hid_message_t* rcv_msg, BOOL is_message_from_usb, uint16_t message_type);
 void comms_hid_msgs_update_message_fields(aux_mcu_message_t* message_pt, BOOL usb_hid_message, uint16_t message_type, uint16_t hid_payload_size);
 aux_mcu_message_t* comms_hid_msgs_get_empty_hid_packet(BOOL usb_hid_message, uint16_t message_type, uint16_t hid_payload_size);
 void comms_hid_msgs_update_message_payload_length_fields(aux_mcu_message_t* message_pt, uint16_t hid_payload_size);
 void comms_hid_msgs_send_ack_nack_message(BOOL usb_hid_message, uint16_t message_type, BOOL ack_message);
 uint16_t comms_hid_msgs_fill_get_status_message_answer(uint16_t* msg_array_uint16);
+void comms_hid_msgs_reset_bundle_stream(uint16_t next_sequence_number);
+void comms_hid_msgs_end_file_stream(void);
 
 #endif /* COMMS_HID_MSGS_H_ */
\ No newline at end of file
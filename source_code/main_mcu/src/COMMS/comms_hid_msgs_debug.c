@@ -35,6 +35,7 @@
 #include "platform_io.h"
 #include "logic_power.h"
 #include "dataflash.h"
+#include "dbflash.h"
 #include "main.h"
 #include "dma.h"
 /* Variable to know if we're allowing bundle upload */
@@ -168,6 +169,7 @@ void comms_hid_msgs_parse_debug(hid_message_t* rcv_msg, uint16_t supposed_payloa
             {
                 /* Set upload allowed boolean */
                 comms_hid_msgs_debug_upload_allowed = TRUE;
+                comms_hid_msgs_reset_bundle_stream(0);
                 
                 /* Erase data flash */
                 dataflash_bulk_erase_without_wait(&dataflash_descriptor);
@@ -217,10 +219,28 @@ void comms_hid_msgs_parse_debug(hid_message_t* rcv_msg, uint16_t supposed_payloa
                 return;
             }
         }
+        case HID_CMD_ID_DATAFLASH_WRITE_STREAM:
+        {
+            if (comms_hid_msgs_debug_upload_allowed != FALSE)
+            {
+                /* Sequence numbered 256B chunks, see comms_hid_msgs_parse_bundle_stream_chunk */
+                comms_hid_msgs_parse_bundle_stream_chunk(rcv_msg, is_message_from_usb, rcv_message_type);
+                return;
+            } 
+            else
+            {
+                /* Set nack, leave same command id */
+                comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, FALSE);
+                return;
+            }
+        }
         case HID_CMD_ID_REINDEX_BUNDLE:
         {        
             if (comms_hid_msgs_debug_upload_allowed != FALSE)
             {
+                /* Last streamed chunk may still be programming */
+                dataflash_wait_for_not_busy(&dataflash_descriptor);
+                
                 /* Do required actions */
                 logic_device_bundle_update_end(TRUE);
                 
@@ -348,6 +368,26 @@ void comms_hid_msgs_parse_debug(hid_message_t* rcv_msg, uint16_t supposed_payloa
             comms_aux_mcu_send_message(temp_tx_message_pt);
             return;          
         }
+        case HID_CMD_ID_GET_DBFLASH_CACHE_STATS:
+        {
+            aux_mcu_message_t* temp_tx_message_pt;
+            
+            /* Get empty message, fill it and send it */
+            temp_tx_message_pt = comms_hid_msgs_get_empty_hid_packet(is_message_from_usb, rcv_message_type, sizeof(dbflash_cache_stats_t));
+            dbflash_get_cache_stats((dbflash_cache_stats_t*)temp_tx_message_pt->hid_message.payload_as_uint32);
+            comms_aux_mcu_send_message(temp_tx_message_pt);
+            return;
+        }
+        case HID_CMD_ID_GET_MAIN_LOOP_STATS:
+        {
+            aux_mcu_message_t* temp_tx_message_pt;
+            
+            /* Get empty message, fill it and send it */
+            temp_tx_message_pt = comms_hid_msgs_get_empty_hid_packet(is_message_from_usb, rcv_message_type, sizeof(main_loop_stats_t));
+            main_get_loop_stats((main_loop_stats_t*)temp_tx_message_pt->hid_message.payload_as_uint32);
+            comms_aux_mcu_send_message(temp_tx_message_pt);
+            return;
+        }
         case HID_CMD_ID_GET_BATTERY_STATUS:
         {
             aux_mcu_message_t* temp_tx_message_pt;
@@ -24,6 +24,7 @@
 #include "comms_aux_mcu.h"
 #include "driver_timer.h"
 #include "platform_io.h"
+#include "main.h"
 #include "dma.h"
 /* DMA Descriptors for our transfers and their DMA priority levels (highest number is higher priority, contrary to what is written in some datasheets) */
 /* Beware of errata 15683 if you do want to implement linked descriptors! */
@@ -34,14 +35,20 @@
 // SPI RX routine for transfer from accelerometer: level 2
 // SPI TX routine for transfer to accelerometer: level 2
 // SPI TX routine for transfer to a display: level 1
-DmacDescriptor dma_writeback_descriptors[7] __attribute__ ((aligned (16)));
-DmacDescriptor dma_descriptors[7] __attribute__ ((aligned (16)));
+// SPI RX routine for transfer from smartcard: level 0
+// SPI TX routine for transfer to smartcard: level 0
+DmacDescriptor dma_writeback_descriptors[9] __attribute__ ((aligned (16)));
+DmacDescriptor dma_descriptors[9] __attribute__ ((aligned (16)));
 /* Boolean to specify if the last DMA transfer for the custom_fs is done */
 volatile BOOL dma_custom_fs_transfer_done = FALSE;
 /* Boolean to specify if the last DMA transfer for the oled display is done */
 volatile BOOL dma_oled_transfer_done = FALSE;
 /* Boolean to specify if the last DMA transfer for the accelerometer is done */
 volatile BOOL dma_acc_transfer_done = FALSE;
+/* Boolean to specify if the last DMA transfer for the smartcard is done */
+volatile BOOL dma_smartcard_transfer_done = FALSE;
+/* Byte clocked out to the smartcard during reads */
+const uint8_t dma_smartcard_dummy_tx_byte = 0x00;
 /* Boolean to specify if we received a packet from aux MCU */
 volatile BOOL dma_aux_mcu_packet_received = FALSE;
 /* Boolean to specify if we sent a packet to aux MCU */
@@ -65,6 +72,7 @@ void DMAC_Handler(void)
         dma_aux_mcu_packet_received = TRUE;
         DMAC->CHINTFLAG.reg = DMAC_CHINTFLAG_TCMPL;
         dma_aux_mcu_rx_transfer_to_be_rearmed = TRUE;
+        main_post_event(MAIN_EVENT_AUX_COMMS);
     }
     
     /* AUX MCU RX routine */
@@ -112,8 +120,20 @@ void DMAC_Handler(void)
         /* Set transfer done boolean, clear interrupt */
         dma_acc_transfer_done = TRUE;
         DMAC->CHINTFLAG.reg = DMAC_CHINTFLAG_TCMPL;
+        main_post_event(MAIN_EVENT_ACC);
+    }
+    
+    #ifndef MINIBLE_V2
+    /* Smartcard RX routine */
+    DMAC->CHID.reg = DMAC_CHID_ID(DMA_DESCID_RX_SMC);
+    if ((DMAC->CHINTFLAG.reg & DMAC_CHINTFLAG_TCMPL) != 0)
+    {
+        /* Set transfer done boolean, clear interrupt */
+        dma_smartcard_transfer_done = TRUE;
+        DMAC->CHINTFLAG.reg = DMAC_CHINTFLAG_TCMPL;
     }
     #endif
+    #endif
 }
 
 /*! \fn     dma_set_custom_fs_flag_done(void)
@@ -296,6 +316,44 @@ void dma_init(void)
     dma_chctrlb_reg.bit.TRIGSRC = AUX_MCU_SERCOM_RXTRIG;                                    // Select RX trigger
     DMAC->CHCTRLB = dma_chctrlb_reg;                                                        // Write register
     DMAC->CHINTENSET.reg = DMAC_CHINTENSET_TCMPL;                                           // Enable channel transfer complete interrupt
+    
+    #ifndef MINIBLE_V2
+    /* Setup transfer descriptor for smartcard RX */
+    dma_descriptors[DMA_DESCID_RX_SMC].BTCTRL.reg = DMAC_BTCTRL_VALID;                      // Valid descriptor
+    dma_descriptors[DMA_DESCID_RX_SMC].BTCTRL.bit.STEPSIZE = DMAC_BTCTRL_STEPSIZE_X1_Val;   // 1 byte address increment
+    dma_descriptors[DMA_DESCID_RX_SMC].BTCTRL.bit.STEPSEL = DMAC_BTCTRL_STEPSEL_DST_Val;    // Step selection for destination
+    dma_descriptors[DMA_DESCID_RX_SMC].BTCTRL.bit.DSTINC = 1;                               // Destination Address Increment is enabled.
+    dma_descriptors[DMA_DESCID_RX_SMC].BTCTRL.bit.BEATSIZE = DMAC_BTCTRL_BEATSIZE_BYTE_Val; // Byte data transfer
+    dma_descriptors[DMA_DESCID_RX_SMC].BTCTRL.bit.BLOCKACT = DMAC_BTCTRL_BLOCKACT_INT_Val;  // Once data block is transferred, generate interrupt
+    dma_descriptors[DMA_DESCID_RX_SMC].DESCADDR.reg = 0;                                    // No next descriptor address
+    
+    /* Setup DMA channel */
+    DMAC->CHID.reg = DMAC_CHID_ID(DMA_DESCID_RX_SMC);                                       // Select channel
+    dma_chctrlb_reg.reg = 0;                                                                // Clear temp register
+    dma_chctrlb_reg.bit.LVL = 0;                                                            // Priority level
+    dma_chctrlb_reg.bit.TRIGACT = DMAC_CHCTRLB_TRIGACT_BEAT_Val;                            // One trigger required for each beat transfer
+    dma_chctrlb_reg.bit.TRIGSRC = SMARTCARD_DMA_SERCOM_RXTRIG;                              // Select RX trigger
+    DMAC->CHCTRLB = dma_chctrlb_reg;                                                        // Write register
+    DMAC->CHINTENSET.reg = DMAC_CHINTENSET_TCMPL;                                           // Enable channel transfer complete interrupt
+    
+    /* Setup transfer descriptor for smartcard TX */
+    dma_descriptors[DMA_DESCID_TX_SMC].BTCTRL.reg = DMAC_BTCTRL_VALID;                      // Valid descriptor
+    dma_descriptors[DMA_DESCID_TX_SMC].BTCTRL.bit.STEPSIZE = DMAC_BTCTRL_STEPSIZE_X1_Val;   // 1 byte address increment
+    dma_descriptors[DMA_DESCID_TX_SMC].BTCTRL.bit.STEPSEL = DMAC_BTCTRL_STEPSEL_SRC_Val;    // Step selection for source
+    dma_descriptors[DMA_DESCID_TX_SMC].BTCTRL.bit.SRCINC = 0;                               // Source Address Increment is disabled: always send the dummy byte
+    dma_descriptors[DMA_DESCID_TX_SMC].BTCTRL.bit.BEATSIZE = DMAC_BTCTRL_BEATSIZE_BYTE_Val; // Byte data transfer
+    dma_descriptors[DMA_DESCID_TX_SMC].BTCTRL.bit.BLOCKACT = DMAC_BTCTRL_BLOCKACT_NOACT_Val;// Once data block is transferred, do nothing
+    dma_descriptors[DMA_DESCID_TX_SMC].SRCADDR.reg = (uint32_t)&dma_smartcard_dummy_tx_byte;// Source address: dummy byte
+    dma_descriptors[DMA_DESCID_TX_SMC].DESCADDR.reg = 0;                                    // No next descriptor address
+    
+    /* Setup DMA channel */
+    DMAC->CHID.reg = DMAC_CHID_ID(DMA_DESCID_TX_SMC);                                       // Select channel
+    dma_chctrlb_reg.reg = 0;                                                                // Clear temp register
+    dma_chctrlb_reg.bit.LVL = 0;                                                            // Priority level
+    dma_chctrlb_reg.bit.TRIGACT = DMAC_CHCTRLB_TRIGACT_BEAT_Val;                            // One trigger required for each beat transfer
+    dma_chctrlb_reg.bit.TRIGSRC = SMARTCARD_DMA_SERCOM_TXTRIG;                              // Select TX trigger
+    DMAC->CHCTRLB = dma_chctrlb_reg;                                                        // Write register
+    #endif
     #endif
 
     /* Enable IRQ */
@@ -318,6 +376,22 @@ BOOL dma_custom_fs_check_and_clear_dma_transfer_flag(void)
     return FALSE;
 }
 
+/*! \fn     dma_smartcard_check_and_clear_dma_transfer_flag(void)
+*   \brief  Check if a DMA transfer that we requested for smartcard read is done
+*   \note   If the flag is true, flag will be cleared to false
+*   \return TRUE or FALSE
+*/
+BOOL dma_smartcard_check_and_clear_dma_transfer_flag(void)
+{
+    /* flag can't be set twice, code is safe */
+    if (dma_smartcard_transfer_done != FALSE)
+    {
+        dma_smartcard_transfer_done = FALSE;
+        return TRUE;
+    }
+    return FALSE;
+}
+
 /*! \fn     dma_oled_check_and_clear_dma_transfer_flag(void)
 *   \brief  Check if a DMA transfer that we requested for led transfer is done
 *   \note   If the flag is true, flag will be cleared to false
@@ -452,6 +526,102 @@ void dma_custom_fs_init_transfer(Sercom* sercom, void* datap, uint16_t size)
     cpu_irq_leave_critical();
 }
 
+/*! \fn     dma_smartcard_init_transfer(Sercom* sercom, void* datap, uint16_t size)
+*   \brief  Initialize a DMA transfer from the smartcard bus to the array, clocking out 0x00 bytes
+*   \param  sercom      Pointer to a sercom module
+*   \param  datap       Pointer to where to store the data
+*   \param  size        Number of bytes to transfer
+*/
+void dma_smartcard_init_transfer(Sercom* sercom, void* datap, uint16_t size)
+{
+    volatile void *spi_data_p = &sercom->SPI.DATA.reg;
+    cpu_irq_enter_critical();
+    
+    /* SPI RX DMA TRANSFER */
+    /* Setup transfer size */
+    dma_descriptors[DMA_DESCID_RX_SMC].BTCNT.bit.BTCNT = (uint16_t)size;
+    /* Source address: DATA register from SPI */
+    dma_descriptors[DMA_DESCID_RX_SMC].SRCADDR.reg = (uint32_t)spi_data_p;
+    /* Destination address: given value */
+    dma_descriptors[DMA_DESCID_RX_SMC].DSTADDR.reg = (uint32_t)datap + size;
+    
+    /* Resume DMA channel operation */
+    DMAC->CHID.reg= DMAC_CHID_ID(DMA_DESCID_RX_SMC);
+    DMAC->CHCTRLA.reg = DMAC_CHCTRLA_ENABLE;
+
+    /* SPI TX DMA TRANSFER */
+    /* Setup transfer size */
+    dma_descriptors[DMA_DESCID_TX_SMC].BTCNT.bit.BTCNT = (uint16_t)size;
+    /* Destination address: DATA register from SPI */
+    dma_descriptors[DMA_DESCID_TX_SMC].DSTADDR.reg = (uint32_t)spi_data_p;
+    
+    /* Resume DMA channel operation */
+    DMAC->CHID.reg= DMAC_CHID_ID(DMA_DESCID_TX_SMC);
+    DMAC->CHCTRLA.reg = DMAC_CHCTRLA_ENABLE;
+    
+    cpu_irq_leave_critical();
+}
+
+/*! \fn     dma_smartcard_disable_transfer(void)
+*   \brief  Disable the DMA transfer for the smartcard
+*/
+void dma_smartcard_disable_transfer(void)
+{
+    cpu_irq_enter_critical();
+    
+    /* Stop DMA channel operation */
+    DMAC->CHID.reg= DMAC_CHID_ID(DMA_DESCID_RX_SMC);
+    DMAC->CHCTRLA.reg = 0;
+    
+    /* Wait for bit clear */
+    while(DMAC->CHCTRLA.reg != 0);
+    
+    /* Stop DMA channel operation */
+    DMAC->CHID.reg= DMAC_CHID_ID(DMA_DESCID_TX_SMC);
+    DMAC->CHCTRLA.reg = 0;
+    
+    /* Wait for bit clear */
+    while(DMAC->CHCTRLA.reg != 0);
+    
+    /* Reset bool */
+    dma_smartcard_transfer_done = FALSE;
+    
+    cpu_irq_leave_critical();
+}
+
+/*! \fn     dma_custom_fs_crc32_start(void)
+*   \brief  Start computing a crc32 over the data received by the custom fs DMA transfers
+*   \note   Unlike dma_compute_crc32_from_spi, can be used while other DMA transfers are ongoing
+*/
+void dma_custom_fs_crc32_start(void)
+{
+    /* CRC control register can only be written while the CRC module is disabled */
+    DMAC->CTRL.bit.CRCENABLE = 0;
+    
+    /* Setup CRC32 */
+    DMAC_CRCCTRL_Type crc_ctrl_reg;
+    crc_ctrl_reg.reg = 0;
+    crc_ctrl_reg.bit.CRCSRC = 0x20 + DMA_DESCID_RX_FS;                                      // DMA channel for custom fs RX
+    crc_ctrl_reg.bit.CRCPOLY = DMAC_CRCCTRL_CRCPOLY_CRC32_Val;                              // CRC32
+    crc_ctrl_reg.bit.CRCBEATSIZE = DMAC_CRCCTRL_CRCBEATSIZE_BYTE_Val;                       // Beat size is one byte
+    DMAC->CRCCTRL = crc_ctrl_reg;                                                           // Store register
+    DMAC->CRCCHKSUM.reg = 0xFFFFFFFF;                                                       // Same as dma_compute_crc32_from_spi
+    DMAC->CTRL.bit.CRCENABLE = 1;                                                           // Enable CRC generator
+}
+
+/*! \fn     dma_custom_fs_crc32_get_and_stop(void)
+*   \brief  Get the crc32 started by dma_custom_fs_crc32_start and disable the CRC module
+*   \return the crc32
+*/
+uint32_t dma_custom_fs_crc32_get_and_stop(void)
+{
+    while ((DMAC->CRCSTATUS.reg & DMAC_CRCSTATUS_CRCBUSY) == DMAC_CRCSTATUS_CRCBUSY);
+    uint32_t crc32 = DMAC->CRCCHKSUM.reg;
+    DMAC->CTRL.bit.CRCENABLE = 0;
+    DMAC->CRCCTRL.reg = 0;
+    return crc32;
+}
+
 /*! \fn     dma_compute_crc32_from_spi(Sercom* sercom, uint32_t size)
 *   \brief  Use the DMA controller to compute a CRC32 from a spi transfer
 *   \param  sercom      Pointer to a sercom module
@@ -34,9 +34,12 @@ uint32_t dma_compute_crc32_from_spi(Sercom* sercom, uint32_t size);
 void dma_aux_mcu_init_tx_transfer(Sercom* sercom, void* datap, uint16_t size);
 void dma_aux_mcu_init_rx_transfer(Sercom* sercom, void* datap, uint16_t size);
 void dma_custom_fs_init_transfer(Sercom* sercom, void* datap, uint16_t size);
+void dma_smartcard_init_transfer(Sercom* sercom, void* datap, uint16_t size);
 BOOL dma_aux_mcu_wait_for_current_packet_reception_and_clear_flag(void);
 uint16_t dma_aux_mcu_get_remaining_bytes_for_rx_transfer(void);
 BOOL dma_custom_fs_check_and_clear_dma_transfer_flag(void);
+BOOL dma_smartcard_check_and_clear_dma_transfer_flag(void);
+uint32_t dma_custom_fs_crc32_get_and_stop(void);
 BOOL dma_aux_mcu_check_and_clear_dma_transfer_flag(void);
 BOOL dma_oled_check_and_clear_dma_transfer_flag(void);
 BOOL dma_acc_check_and_clear_dma_transfer_flag(void);
@@ -46,7 +49,9 @@ void dma_wait_for_aux_mcu_packet_sent(void);
 BOOL dma_acc_check_dma_transfer_flag(void);
 void dma_aux_mcu_disable_transfer(void);
 void dma_set_custom_fs_flag_done(void);
+void dma_custom_fs_crc32_start(void);
 void dma_acc_disable_transfer(void);
+void dma_smartcard_disable_transfer(void);
 void dma_reset(void);
 void dma_init(void);
 
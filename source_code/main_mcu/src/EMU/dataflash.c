@@ -3,9 +3,58 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 static int bundle_fd = -1;
 
+/* Bundle mapped in memory when possible, lseek+read otherwise */
+static uint8_t* bundle_map = NULL;
+static uint32_t bundle_size = 0;
+static uint32_t bundle_read_address = 0;
+
+/* Slicing-by-8 tables for the DMAC CRC32: IEEE 802.3 polynomial, reflected */
+static uint32_t crc32_tables[8][256];
+static BOOL crc32_tables_generated = FALSE;
+
+static void emu_dataflash_map_bundle(void)
+{
+#ifndef WIN32
+    struct stat bundle_stat;
+    if((fstat(bundle_fd, &bundle_stat) != 0) || (bundle_stat.st_size == 0))
+        return;
+
+    void *map = mmap(NULL, bundle_stat.st_size, PROT_READ, MAP_PRIVATE, bundle_fd, 0);
+    if(map == MAP_FAILED) {
+        fprintf(stderr, "Failed to map bundle file, using file reads\n");
+        return;
+    }
+
+    bundle_map = (uint8_t*)map;
+    bundle_size = (uint32_t)bundle_stat.st_size;
+#endif
+}
+
+static void emu_dataflash_read_from_bundle(uint32_t address, uint8_t* data, uint32_t length)
+{
+    if(bundle_map == NULL) {
+        lseek(bundle_fd, address, SEEK_SET);
+        read(bundle_fd, data, length);
+        return;
+    }
+
+    // like read(), reads past the end of the bundle leave the buffer untouched
+    if(address < bundle_size) {
+        uint32_t available = bundle_size - address;
+        memcpy(data, bundle_map + address, length < available ? length : available);
+    }
+}
+
 void emu_dataflash_init(const char *path)
 {
     int i;
@@ -31,8 +80,10 @@ void emu_dataflash_init(const char *path)
 #else
         bundle_fd = open(bundle_paths[i], O_RDONLY);
 #endif
-        if(bundle_fd >= 0)
+        if(bundle_fd >= 0) {
+            emu_dataflash_map_bundle();
             return;
+        }
     }
 
     fprintf(stderr, "Failed to open bundle file, tried:\n");
@@ -41,21 +92,151 @@ void emu_dataflash_init(const char *path)
 
 }
 
+static void emu_dataflash_generate_crc32_tables(void)
+{
+    for(uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for(int j = 0; j < 8; j++)
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+        crc32_tables[0][i] = crc;
+    }
+
+    for(uint32_t i = 0; i < 256; i++) {
+        for(int slice = 1; slice < 8; slice++)
+            crc32_tables[slice][i] = (crc32_tables[slice-1][i] >> 8) ^ crc32_tables[0][crc32_tables[slice-1][i] & 0xFF];
+    }
+
+    crc32_tables_generated = TRUE;
+}
+
+/* Bytewise reference implementation, only used by the benchmark */
+static uint32_t emu_dataflash_crc32_bytewise(uint32_t crc_register, const uint8_t* data, uint32_t length)
+{
+    while(length--)
+        crc_register = (crc_register >> 8) ^ crc32_tables[0][(crc_register ^ *data++) & 0xFF];
+    return crc_register;
+}
+
+/* Feed data to an emulated DMAC CRC32 register: start with 0xFFFFFFFF, the checksum register then reads as the complement.
+ * Data is consumed as little endian words, like on the SAMD21 and on all our emulator hosts.
+ */
+uint32_t emu_dataflash_crc32(uint32_t crc_register, const uint8_t* data, uint32_t length)
+{
+    if(!crc32_tables_generated)
+        emu_dataflash_generate_crc32_tables();
+
+    while(length >= 8) {
+        uint32_t low, high;
+        memcpy(&low, data, sizeof(low));
+        memcpy(&high, data + 4, sizeof(high));
+        low ^= crc_register;
+        crc_register = crc32_tables[7][low & 0xFF] ^ crc32_tables[6][(low >> 8) & 0xFF] ^
+                       crc32_tables[5][(low >> 16) & 0xFF] ^ crc32_tables[4][low >> 24] ^
+                       crc32_tables[3][high & 0xFF] ^ crc32_tables[2][(high >> 8) & 0xFF] ^
+                       crc32_tables[1][(high >> 16) & 0xFF] ^ crc32_tables[0][high >> 24];
+        data += 8;
+        length -= 8;
+    }
+
+    return emu_dataflash_crc32_bytewise(crc_register, data, length);
+}
+
+/* What dma_compute_crc32_from_spi() does on the device: crc32 of the next bytes of the opened transfer */
+uint32_t emu_dataflash_crc32_from_opened_transfer(uint32_t size)
+{
+    uint32_t crc_register = 0xFFFFFFFF;
+    uint8_t buffer[4096];
+
+    while(size > 0) {
+        uint32_t chunk = size < sizeof(buffer) ? size : sizeof(buffer);
+
+        // past the end of the bundle file, the flash reads as erased
+        memset(buffer, 0xFF, chunk);
+        dataflash_read_bytes_from_opened_transfer(NULL, buffer, chunk);
+        crc_register = emu_dataflash_crc32(crc_register, buffer, chunk);
+        size -= chunk;
+    }
+
+    return ~crc_register;
+}
+
+static double emu_dataflash_benchmark_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Compare the crc32 implementations on the loaded bundle, return 0 if they match the bundle header crc32 */
+int emu_dataflash_crc32_benchmark(int nb_rounds)
+{
+    uint32_t header[3];
+    uint8_t *bundle_data;
+    uint32_t length;
+
+    if(bundle_fd < 0) {
+        fprintf(stderr, "No bundle loaded\n");
+        return 1;
+    }
+
+    // magic, total size, crc32: the crc32 covers the rest of the bundle
+    emu_dataflash_read_from_bundle(0, (uint8_t*)header, sizeof(header));
+    if(header[1] <= sizeof(header)) {
+        fprintf(stderr, "Invalid bundle header\n");
+        return 1;
+    }
+    length = header[1] - sizeof(header);
+    bundle_data = malloc(length);
+    if(bundle_data == NULL)
+        return 1;
+    memset(bundle_data, 0xFF, length);
+    emu_dataflash_read_from_bundle(sizeof(header), bundle_data, length);
+
+    if(!crc32_tables_generated)
+        emu_dataflash_generate_crc32_tables();
+
+    uint32_t bytewise_crc = 0, sliced_crc = 0;
+    double start = emu_dataflash_benchmark_seconds();
+    for(int i = 0; i < nb_rounds; i++)
+        bytewise_crc = ~emu_dataflash_crc32_bytewise(0xFFFFFFFF, bundle_data, length);
+    double bytewise_time = (emu_dataflash_benchmark_seconds() - start) / nb_rounds;
+
+    start = emu_dataflash_benchmark_seconds();
+    for(int i = 0; i < nb_rounds; i++)
+        sliced_crc = ~emu_dataflash_crc32(0xFFFFFFFF, bundle_data, length);
+    double sliced_time = (emu_dataflash_benchmark_seconds() - start) / nb_rounds;
+    free(bundle_data);
+
+    fprintf(stderr, "Bundle: %u bytes, header crc32 0x%08x\n", length, header[2]);
+    fprintf(stderr, "  bytewise:      crc32 0x%08x, %8.3f ms per bundle, %8.1f MB/s\n", bytewise_crc, bytewise_time * 1e3, length / bytewise_time / 1e6);
+    fprintf(stderr, "  slicing-by-8:  crc32 0x%08x, %8.3f ms per bundle, %8.1f MB/s\n", sliced_crc, sliced_time * 1e3, length / sliced_time / 1e6);
+
+    return (bytewise_crc == header[2] && sliced_crc == header[2]) ? 0 : 1;
+}
+
+void dataflash_write_page_without_wait(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint32_t length){}
 void dataflash_write_array_to_memory(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint32_t length){}
 void dataflash_read_data_array(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint32_t length) 
 {
-    lseek(bundle_fd, address, SEEK_SET);
-    read(bundle_fd, data, length);
+    emu_dataflash_read_from_bundle(address, data, length);
+    bundle_read_address = address + length;
 }
 
 void dataflash_read_bytes_from_opened_transfer(spi_flash_descriptor_t* descriptor_pt, uint8_t* data, uint32_t length) {
-    read(bundle_fd, data, length);
+    if(bundle_map == NULL) {
+        read(bundle_fd, data, length);
+    } else {
+        emu_dataflash_read_from_bundle(bundle_read_address, data, length);
+    }
+    bundle_read_address += length;
 }
 
 void dataflash_send_command(spi_flash_descriptor_t* descriptor_pt, uint8_t* data, uint32_t length){}
 void dataflash_send_single_byte_command(spi_flash_descriptor_t* descriptor_pt, uint8_t command){}
 void dataflash_read_data_array_start(spi_flash_descriptor_t* descriptor_pt, uint32_t address) {
-    lseek(bundle_fd, address, SEEK_SET);
+    if(bundle_map == NULL)
+        lseek(bundle_fd, address, SEEK_SET);
+    bundle_read_address = address;
 }
 
 void dataflash_erase_64kb_block(spi_flash_descriptor_t* descriptor_pt, uint32_t address){}
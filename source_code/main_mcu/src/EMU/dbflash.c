@@ -1,39 +1,114 @@
 #include "dbflash.h"
+#include "dbflash_cache.h"
+#include "emu_dbflash.h"
 #include "emu_storage.h"
+#include "nodemgmt.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+/* Write ordering test: number of single byte writes done through the cache, pages used */
+#define EMU_DBFLASH_TEST_NB_WRITES  BYTES_PER_PAGE
+#define EMU_DBFLASH_TEST_NB_PAGES   (DBFLASH_CACHE_NB_PAGES + 2)
+#define EMU_DBFLASH_TEST_FIRST_PAGE (PAGE_COUNT - EMU_DBFLASH_TEST_NB_PAGES)
+
+static BOOL emu_dbflash_test_running = FALSE;
+static BOOL emu_dbflash_test_failed = FALSE;
+static uint16_t emu_dbflash_test_pages[EMU_DBFLASH_TEST_NB_WRITES];
+static int emu_dbflash_test_nb_writes = 0;
+
+// like the flash chip, a single SRAM buffer for buffer writes and cache write backs
+static uint8_t emu_dbflash_internal_buffer[BYTES_PER_PAGE];
+
 void dbflash_write_data_pattern_to_flash(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, uint8_t pattern)
 {
+#ifdef DBFLASH_PAGE_CACHE
+    dbflash_cache_write_data(descriptor_pt, pageNumber, offset, dataSize, NULL, pattern);
+#else
     char *tmp = malloc(dataSize);
     memset(tmp, pattern, dataSize);
     dbflash_write_data_to_flash(descriptor_pt, pageNumber, offset, dataSize, tmp);
     free(tmp);
+#endif
 }
 
 void dbflash_read_data_from_flash(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data)
 {
+#ifdef DBFLASH_PAGE_CACHE
+    dbflash_cache_read_data(descriptor_pt, pageNumber, offset, dataSize, data);
+#else
     emu_dbflash_read(pageNumber * BYTES_PER_PAGE + offset, data, dataSize);
+#endif
 }
 
 void dbflash_write_data_to_flash(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data)
 {
+#ifdef DBFLASH_PAGE_CACHE
+    dbflash_cache_write_data(descriptor_pt, pageNumber, offset, dataSize, data, 0);
+#else
     emu_dbflash_write(pageNumber * BYTES_PER_PAGE + offset, data, dataSize);
+#endif
+}
+
+void dbflash_read_data_bypassing_cache(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data)
+{
+    emu_dbflash_read(pageNumber * BYTES_PER_PAGE + offset, data, dataSize);
+}
+
+static void emu_dbflash_check_write_order(void);
+
+void dbflash_write_page_bypassing_cache(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint8_t* data)
+{
+    // main memory page program through the internal buffer
+    memcpy(emu_dbflash_internal_buffer, data, BYTES_PER_PAGE);
+    emu_dbflash_write(pageNumber * BYTES_PER_PAGE, emu_dbflash_internal_buffer, BYTES_PER_PAGE);
+
+    if(emu_dbflash_test_running)
+        emu_dbflash_check_write_order();
 }
 
 void dbflash_page_erase(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber)
 {
-    char *tmp = malloc(BYTES_PER_PAGE);
-    memset(tmp, 0xFF, BYTES_PER_PAGE);
-    dbflash_write_data_to_flash(descriptor_pt, pageNumber, 0, BYTES_PER_PAGE, tmp);
-    free(tmp);
+    uint8_t erased[BYTES_PER_PAGE];
+    memset(erased, 0xFF, sizeof(erased));
+#ifdef DBFLASH_PAGE_CACHE
+    dbflash_cache_erase_pages(descriptor_pt, pageNumber, 1);
+#endif
+    emu_dbflash_write(pageNumber * BYTES_PER_PAGE, erased, BYTES_PER_PAGE);
+}
+
+void dbflash_load_page_to_internal_buffer(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber)
+{
+    // the page will be programmed after all cached writes
+    dbflash_flush_cache(descriptor_pt);
+    emu_dbflash_read(pageNumber * BYTES_PER_PAGE, emu_dbflash_internal_buffer, BYTES_PER_PAGE);
+}
+
+void dbflash_write_buffer(spi_flash_descriptor_t* descriptor_pt, uint8_t* datap, uint16_t offset, uint16_t size)
+{
+    memcpy(&emu_dbflash_internal_buffer[offset], datap, size);
+}
+
+void dbflash_flash_write_buffer_to_page(spi_flash_descriptor_t* descriptor_pt, uint16_t page)
+{
+#ifdef DBFLASH_PAGE_CACHE
+    dbflash_cache_invalidate_pages(page, 1);
+#endif
+    emu_dbflash_write(page * BYTES_PER_PAGE, emu_dbflash_internal_buffer, BYTES_PER_PAGE);
+}
+
+void dbflash_flush_cache(spi_flash_descriptor_t* descriptor_pt)
+{
+#ifdef DBFLASH_PAGE_CACHE
+    dbflash_cache_flush(descriptor_pt);
+#endif
 }
 
 static BOOL initialized = FALSE;
 
 RET_TYPE dbflash_check_presence(spi_flash_descriptor_t* descriptor_pt)
-{   
+{
     if(!initialized) {
         initialized = TRUE;
         emu_dbflash_open();
@@ -41,3 +116,148 @@ RET_TYPE dbflash_check_presence(spi_flash_descriptor_t* descriptor_pt)
 
     return RETURN_OK;
 }
+
+/* Write k of the test sets byte k of page emu_dbflash_test_pages[k] to 0: at any time, the written bytes found in flash must be a prefix of the writes */
+static void emu_dbflash_check_write_order(void)
+{
+    BOOL missing_write = FALSE;
+
+    for(int i = 0; i < emu_dbflash_test_nb_writes; i++) {
+        uint8_t byte;
+        emu_dbflash_read(emu_dbflash_test_pages[i] * BYTES_PER_PAGE + i, &byte, 1);
+        if(byte != 0) {
+            missing_write = TRUE;
+        } else if(missing_write) {
+            fprintf(stderr, "Write %d reached the flash before an earlier write\n", i);
+            emu_dbflash_test_failed = TRUE;
+            return;
+        }
+    }
+}
+
+int emu_dbflash_cache_ordering_test(void)
+{
+#ifdef DBFLASH_PAGE_CACHE
+    uint8_t *saved_pages = malloc(EMU_DBFLASH_TEST_NB_PAGES * BYTES_PER_PAGE);
+    uint8_t page[BYTES_PER_PAGE];
+    uint8_t zero = 0;
+    uint32_t rand_state = 12345;
+    dbflash_cache_stats_t stats;
+
+    if(saved_pages == NULL)
+        return 1;
+
+    // the test pages are restored afterwards
+    dbflash_check_presence(NULL);
+    dbflash_flush_cache(NULL);
+    emu_dbflash_read(EMU_DBFLASH_TEST_FIRST_PAGE * BYTES_PER_PAGE, saved_pages, EMU_DBFLASH_TEST_NB_PAGES * BYTES_PER_PAGE);
+    for(int i = 0; i < EMU_DBFLASH_TEST_NB_PAGES; i++)
+        dbflash_page_erase(NULL, EMU_DBFLASH_TEST_FIRST_PAGE + i);
+
+    // random single byte writes, runs of writes to the same page and full page reads: more test pages than cached pages to exercise evictions
+    emu_dbflash_test_running = TRUE;
+    for(int i = 0; i < EMU_DBFLASH_TEST_NB_WRITES; i++) {
+        rand_state = rand_state * 1103515245 + 12345;
+        if((i == 0) || ((rand_state >> 16) % 3 != 0))
+            emu_dbflash_test_pages[i] = EMU_DBFLASH_TEST_FIRST_PAGE + (rand_state >> 20) % EMU_DBFLASH_TEST_NB_PAGES;
+        else
+            emu_dbflash_test_pages[i] = emu_dbflash_test_pages[i-1];
+        emu_dbflash_test_nb_writes = i + 1;
+        dbflash_write_data_to_flash(NULL, emu_dbflash_test_pages[i], i, 1, &zero);
+
+        if((rand_state >> 24) % 5 == 0)
+            dbflash_read_data_from_flash(NULL, EMU_DBFLASH_TEST_FIRST_PAGE + (rand_state >> 12) % EMU_DBFLASH_TEST_NB_PAGES, 0, BYTES_PER_PAGE, page);
+    }
+    dbflash_flush_cache(NULL);
+    emu_dbflash_test_running = FALSE;
+
+    // every write must have reached the flash
+    for(int i = 0; i < EMU_DBFLASH_TEST_NB_WRITES; i++) {
+        emu_dbflash_read(emu_dbflash_test_pages[i] * BYTES_PER_PAGE + i, page, 1);
+        if(page[0] != 0) {
+            fprintf(stderr, "Write %d didn't reach the flash\n", i);
+            emu_dbflash_test_failed = TRUE;
+        }
+    }
+
+    // restore the test pages, drop them from the cache
+    for(int i = 0; i < EMU_DBFLASH_TEST_NB_PAGES; i++)
+        dbflash_cache_erase_pages(NULL, EMU_DBFLASH_TEST_FIRST_PAGE + i, 1);
+    emu_dbflash_write(EMU_DBFLASH_TEST_FIRST_PAGE * BYTES_PER_PAGE, saved_pages, EMU_DBFLASH_TEST_NB_PAGES * BYTES_PER_PAGE);
+    dbflash_flush_cache(NULL);
+    free(saved_pages);
+
+    dbflash_get_cache_stats(&stats);
+    fprintf(stderr, "Database flash cache write ordering: %s, %d writes, %u page writes\n", emu_dbflash_test_failed ? "FAILED" : "ok", EMU_DBFLASH_TEST_NB_WRITES, stats.page_writes);
+    return emu_dbflash_test_failed ? 1 : 0;
+#else
+    fprintf(stderr, "Database flash cache disabled\n");
+    return 1;
+#endif
+}
+
+/* Full page batched node write while other pages are modified in the cache: their write backs must not end up in the programmed page */
+int emu_dbflash_batch_write_test(void)
+{
+#ifdef DBFLASH_PAGE_CACHE
+    uint8_t *saved_pages = malloc(EMU_DBFLASH_TEST_NB_PAGES * BYTES_PER_PAGE);
+    uint8_t nodes[NODEMGMT_NODES_PER_PAGE][BASE_NODE_SIZE];
+    uint8_t *node_pts[NODEMGMT_NODES_PER_PAGE];
+    uint16_t addresses[NODEMGMT_NODES_PER_PAGE];
+    uint16_t lengths[NODEMGMT_NODES_PER_PAGE];
+    uint8_t page[BYTES_PER_PAGE];
+    uint8_t marker = 0xA5;
+    BOOL failed = FALSE;
+
+    if(saved_pages == NULL)
+        return 1;
+
+    // the test pages are restored afterwards
+    dbflash_check_presence(NULL);
+    dbflash_flush_cache(NULL);
+    emu_dbflash_read(EMU_DBFLASH_TEST_FIRST_PAGE * BYTES_PER_PAGE, saved_pages, EMU_DBFLASH_TEST_NB_PAGES * BYTES_PER_PAGE);
+
+    // leave pages after the first test page modified in the cache
+    for(int i = 1; i < DBFLASH_CACHE_NB_PAGES; i++)
+        dbflash_write_data_to_flash(NULL, EMU_DBFLASH_TEST_FIRST_PAGE + i, 0, 1, &marker);
+
+    // overwrite all the nodes of the first test page
+    for(int i = 0; i < NODEMGMT_NODES_PER_PAGE; i++) {
+        memset(nodes[i], 0x10 + i, BASE_NODE_SIZE);
+        node_pts[i] = nodes[i];
+        addresses[i] = (EMU_DBFLASH_TEST_FIRST_PAGE << NODEMGMT_ADDR_PAGE_BITSHIFT) | i;
+        lengths[i] = BASE_NODE_SIZE;
+    }
+    if(nodemgmt_write_node_blocks_to_flash(NODEMGMT_NODES_PER_PAGE, addresses, lengths, node_pts) != RETURN_OK)
+        failed = TRUE;
+    dbflash_flush_cache(NULL);
+
+    // the user ID is set by the write function, compare with the nodes as they were written
+    emu_dbflash_read(EMU_DBFLASH_TEST_FIRST_PAGE * BYTES_PER_PAGE, page, BYTES_PER_PAGE);
+    for(int i = 0; i < NODEMGMT_NODES_PER_PAGE; i++) {
+        if(memcmp(&page[i * BASE_NODE_SIZE], nodes[i], BASE_NODE_SIZE) != 0) {
+            fprintf(stderr, "Node %d of the batch written page has the wrong contents\n", i);
+            failed = TRUE;
+        }
+    }
+    for(int i = 1; i < DBFLASH_CACHE_NB_PAGES; i++) {
+        emu_dbflash_read((EMU_DBFLASH_TEST_FIRST_PAGE + i) * BYTES_PER_PAGE, page, 1);
+        if(page[0] != marker) {
+            fprintf(stderr, "Cached write to page %d didn't reach the flash\n", i);
+            failed = TRUE;
+        }
+    }
+
+    // restore the test pages, drop them from the cache
+    dbflash_cache_invalidate_pages(EMU_DBFLASH_TEST_FIRST_PAGE, EMU_DBFLASH_TEST_NB_PAGES);
+    emu_dbflash_write(EMU_DBFLASH_TEST_FIRST_PAGE * BYTES_PER_PAGE, saved_pages, EMU_DBFLASH_TEST_NB_PAGES * BYTES_PER_PAGE);
+    dbflash_flush_cache(NULL);
+    free(saved_pages);
+
+    fprintf(stderr, "Database flash batched node write: %s\n", failed ? "FAILED" : "ok");
+    return failed ? 1 : 0;
+#else
+    fprintf(stderr, "Database flash cache disabled\n");
+    return 1;
+#endif
+}
@@ -1,9 +1,18 @@
 #include "dma.h"
 #include "emu_aux_mcu.h"
+#include "emu_dataflash.h"
+#include "dataflash.h"
+
+/* Emulated DMAC CRC engine, fed by the custom fs RX channel */
+static BOOL dma_custom_fs_crc32_enabled = FALSE;
+static uint32_t dma_custom_fs_crc32_register;
 
 void dma_oled_init_transfer(Sercom* sercom, void* datap, uint16_t size, uint16_t dma_trigger){}
 void dma_acc_init_transfer(Sercom* sercom, void* datap, uint16_t size, uint8_t* read_cmd){}
-uint32_t dma_compute_crc32_from_spi(Sercom* sercom, uint32_t size){return 0;}
+uint32_t dma_compute_crc32_from_spi(Sercom* sercom, uint32_t size)
+{
+    return emu_dataflash_crc32_from_opened_transfer(size);
+}
 
 void dma_aux_mcu_init_tx_transfer(Sercom* sercom, void* datap, uint16_t size)
 {
@@ -61,7 +70,26 @@ void dma_aux_mcu_disable_transfer(void){
     aux_rcv_remain = 0;
 }
 
-void dma_custom_fs_init_transfer(Sercom* sercom, void* datap, uint16_t size){}
+/* Transfers are done immediately: the done flag is always set */
+void dma_custom_fs_init_transfer(Sercom* sercom, void* datap, uint16_t size)
+{
+    dataflash_read_bytes_from_opened_transfer(NULL, datap, size);
+    if(dma_custom_fs_crc32_enabled)
+        dma_custom_fs_crc32_register = emu_dataflash_crc32(dma_custom_fs_crc32_register, datap, size);
+}
+
+void dma_custom_fs_crc32_start(void)
+{
+    dma_custom_fs_crc32_register = 0xFFFFFFFF;
+    dma_custom_fs_crc32_enabled = TRUE;
+}
+
+uint32_t dma_custom_fs_crc32_get_and_stop(void)
+{
+    dma_custom_fs_crc32_enabled = FALSE;
+    return ~dma_custom_fs_crc32_register;
+}
+
 BOOL dma_custom_fs_check_and_clear_dma_transfer_flag(void){return TRUE;}
 BOOL dma_oled_check_and_clear_dma_transfer_flag(void){return TRUE;}
 BOOL dma_acc_check_and_clear_dma_transfer_flag(void){return TRUE;}
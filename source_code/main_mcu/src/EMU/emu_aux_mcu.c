@@ -27,6 +27,13 @@ void emu_send_aux(char *data, int size)
     switch(msg->message_type) {
         case AUX_MCU_MSG_TYPE_USB:
             send_hid_message(msg);
+            if(msg->tx_sent_notif_req_flag != 0) {
+                memset(&response, 0, sizeof(response));
+                response.message_type = AUX_MCU_MSG_TYPE_AUX_MCU_EVENT;
+                response.payload_length1 = sizeof(response.aux_mcu_event_message.event_id);
+                response.aux_mcu_event_message.event_id = AUX_MCU_EVENT_HID_MSG_SENT;
+                response_valid = TRUE;
+            }
             break;
             
         case AUX_MCU_MSG_TYPE_KEYBOARD_TYPE:
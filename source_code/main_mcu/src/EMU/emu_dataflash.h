@@ -1,11 +1,16 @@
 #ifndef EMU_DATAFLASH_H
 #define EMU_DATAFLASH_H
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 void emu_dataflash_init(const char *path);
+uint32_t emu_dataflash_crc32(uint32_t crc_register, const uint8_t* data, uint32_t length);
+uint32_t emu_dataflash_crc32_from_opened_transfer(uint32_t size);
+int emu_dataflash_crc32_benchmark(int nb_rounds);
 
 #ifdef __cplusplus
 }
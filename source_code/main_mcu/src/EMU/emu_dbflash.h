@@ -0,0 +1,15 @@
+#ifndef EMU_DBFLASH_H
+#define EMU_DBFLASH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int emu_dbflash_cache_ordering_test(void);
+int emu_dbflash_batch_write_test(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
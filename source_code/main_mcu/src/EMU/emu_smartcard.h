@@ -26,7 +26,7 @@ void emu_close_smartcard(BOOL written);
 
 enum { EMU_SMARTCARD_REGULAR, EMU_SMARTCARD_INVALID, EMU_SMARTCARD_BROKEN };
 void emu_init_smartcard(struct emu_smartcard_storage_t *smartcard, int smartcard_type);
-void emu_reset_smartcard();
+void emu_reset_smartcard(void);
 
 #ifdef __cplusplus
 
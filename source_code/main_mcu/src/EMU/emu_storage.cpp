@@ -1,54 +1,149 @@
 #include "emu_storage.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include <QDebug>
 #include <QFile>
 
-static QFile eeprom("eeprom.bin");
-static QFile dbflash("dbflash.bin");
-static bool emu_open_flash(QFile & flashFile)
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/* Emulated flash: the file is memory mapped so that accesses are plain memcpys.
+ * If mapping isn't possible we fall back to seek+read/write on the QFile.
+ * The file is still grown on demand with 0xff bytes, exactly like before, so its format doesn't change.
+ */
+struct emu_flash_t {
+    QFile file;
+    uchar *map = nullptr;
+    qint64 map_size = 0;
+    emu_flash_t(const char *name): file(name) {}
+};
+
+static emu_flash_t eeprom("eeprom.bin");
+static emu_flash_t dbflash("dbflash.bin");
+static emu_storage_sync_policy_te sync_policy = EMU_STORAGE_SYNC_ON_EXIT;
+
+static void emu_sync_flash_range(emu_flash_t & flash, int offset, int length)
 {
-    if(!flashFile.open(QIODevice::ReadWrite)) {
-        qWarning() << "Failed to open emulated flash" << flashFile.fileName();
-        abort();
+    if(flash.map == nullptr) {
+        if(flash.file.isOpen())
+            flash.file.flush();
+        return;
+    }
+
+#ifdef WIN32
+    FlushViewOfFile(flash.map + offset, length);
+#else
+    // msync wants a page aligned start address
+    long page_size = sysconf(_SC_PAGESIZE);
+    int aligned_offset = offset - (offset % page_size);
+    msync(flash.map + aligned_offset, length + (offset - aligned_offset), MS_SYNC);
+#endif
+}
+
+static void emu_map_flash(emu_flash_t & flash)
+{
+    if(flash.map != nullptr) {
+        flash.file.unmap(flash.map);
+        flash.map = nullptr;
+        flash.map_size = 0;
     }
 
-    return flashFile.size() > 0;
+    if(flash.file.size() == 0)
+        return;
+
+    flash.map = flash.file.map(0, flash.file.size());
+    if(flash.map == nullptr) {
+        qWarning() << "Failed to map emulated flash" << flash.file.fileName() << ", using file accesses";
+        return;
+    }
+    flash.map_size = flash.file.size();
 }
 
-static void emu_extend_flash(QFile & flashFile, int size)
+static bool emu_open_flash(emu_flash_t & flash)
 {
-    if(flashFile.size() < size) {
-        flashFile.seek(flashFile.size());
-        int extend_size = size - flashFile.size();
-        flashFile.write(QByteArray(extend_size, '\xff'));
+    if(!flash.file.open(QIODevice::ReadWrite)) {
+        qWarning() << "Failed to open emulated flash" << flash.file.fileName();
+        abort();
     }
-    
-    flashFile.flush();
+
+    emu_map_flash(flash);
+    return flash.file.size() > 0;
 }
 
-static void emu_flash_read(QFile & flashFile, int offset, uint8_t *buf, int length) 
+static bool emu_extend_flash(emu_flash_t & flash, int size)
 {
-    if(flashFile.isOpen()) {
-        emu_extend_flash(flashFile, offset+length);
-        flashFile.seek(offset);
-        flashFile.read((char*)buf, length);
+    if((flash.map != nullptr) && (flash.map_size >= size))
+        return true;
+
+    if(flash.file.size() < size) {
+        flash.file.seek(flash.file.size());
+        int extend_size = size - flash.file.size();
+        flash.file.write(QByteArray(extend_size, '\xff'));
+        flash.file.flush();
+
+        // Remap to cover the new file size
+        emu_map_flash(flash);
+    }
 
+    if((flash.file.size() < size) || ((flash.map != nullptr) && (flash.map_size < size))) {
+        qWarning() << "Failed to extend emulated flash" << flash.file.fileName();
+        return false;
+    }
+    return true;
+}
+
+static void emu_flash_read(emu_flash_t & flash, int offset, uint8_t *buf, int length)
+{
+    if(flash.file.isOpen() && emu_extend_flash(flash, offset+length)) {
+        if(flash.map != nullptr) {
+            memcpy(buf, flash.map + offset, length);
+        } else {
+            flash.file.seek(offset);
+            flash.file.read((char*)buf, length);
+        }
     } else {
+        // reads as erased flash
         memset(buf, 0xff, length);
     }
 }
 
-static void emu_flash_write(QFile & flashFile, int offset, uint8_t *buf, int length)
+static void emu_flash_write(emu_flash_t & flash, int offset, uint8_t *buf, int length)
 {
-    if(flashFile.isOpen()) {
-        emu_extend_flash(flashFile, offset+length);
-        flashFile.seek(offset);
-        flashFile.write((char*)buf, length);
-        flashFile.flush();
+    if(flash.file.isOpen() && emu_extend_flash(flash, offset+length)) {
+        if(flash.map != nullptr) {
+            memcpy(flash.map + offset, buf, length);
+        } else {
+            flash.file.seek(offset);
+            flash.file.write((char*)buf, length);
+        }
+
+        if((sync_policy == EMU_STORAGE_SYNC_ON_WRITE) || (flash.map == nullptr))
+            emu_sync_flash_range(flash, offset, length);
     }
 }
 
+static void emu_sync_flash(emu_flash_t & flash)
+{
+    if(flash.file.isOpen())
+        emu_sync_flash_range(flash, 0, flash.map_size);
+}
+
+void emu_storage_set_sync_policy(emu_storage_sync_policy_te policy)
+{
+    sync_policy = policy;
+}
+
+void emu_storage_sync(void)
+{
+    emu_sync_flash(eeprom);
+    emu_sync_flash(dbflash);
+}
+
 BOOL emu_eeprom_open()
 {
     return emu_open_flash(eeprom);
@@ -78,4 +173,3 @@ void emu_dbflash_write(int offset, uint8_t *buf, int length)
 {
     return emu_flash_write(dbflash, offset, buf, length);
 }
-
@@ -7,6 +7,12 @@
 extern "C" {
 #endif
 
+/* When emulated flash contents are explicitly synced to disk: the memory mapped files are otherwise written back by the OS */
+typedef enum {EMU_STORAGE_SYNC_ON_EXIT = 0, EMU_STORAGE_SYNC_ON_WRITE = 1} emu_storage_sync_policy_te;
+
+void emu_storage_set_sync_policy(emu_storage_sync_policy_te policy);
+void emu_storage_sync(void);
+
 BOOL emu_eeprom_open(void);
 void emu_eeprom_read(int offset, uint8_t *buf, int length);
 void emu_eeprom_write(int offset, uint8_t *buf, int length);
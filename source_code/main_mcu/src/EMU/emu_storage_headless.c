@@ -0,0 +1,158 @@
+/* Emulated flash for the headless emulator: same behavior and file format as emu_storage.cpp, using POSIX calls instead of Qt */
+#include "emu_storage.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+typedef struct {
+    const char *name;
+    int fd;
+    uint8_t *map;
+    off_t map_size;
+} emu_flash_t;
+
+static emu_flash_t eeprom = {"eeprom.bin", -1, NULL, 0};
+static emu_flash_t dbflash = {"dbflash.bin", -1, NULL, 0};
+static emu_storage_sync_policy_te sync_policy = EMU_STORAGE_SYNC_ON_EXIT;
+
+static off_t emu_flash_file_size(emu_flash_t *flash)
+{
+    struct stat st;
+    if(fstat(flash->fd, &st) != 0)
+        return 0;
+    return st.st_size;
+}
+
+static void emu_map_flash(emu_flash_t *flash)
+{
+    if(flash->map != NULL) {
+        munmap(flash->map, flash->map_size);
+        flash->map = NULL;
+        flash->map_size = 0;
+    }
+
+    off_t size = emu_flash_file_size(flash);
+    if(size == 0)
+        return;
+
+    void *map = mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_SHARED, flash->fd, 0);
+    if(map == MAP_FAILED) {
+        fprintf(stderr, "Failed to map emulated flash %s\n", flash->name);
+        abort();
+    }
+    flash->map = map;
+    flash->map_size = size;
+}
+
+static BOOL emu_open_flash(emu_flash_t *flash)
+{
+    flash->fd = open(flash->name, O_RDWR|O_CREAT, 0644);
+    if(flash->fd < 0) {
+        fprintf(stderr, "Failed to open emulated flash %s\n", flash->name);
+        abort();
+    }
+
+    emu_map_flash(flash);
+    return flash->map_size > 0;
+}
+
+static BOOL emu_extend_flash(emu_flash_t *flash, int size)
+{
+    static const uint8_t erased[256] = {[0 ... 255] = 0xff};
+
+    if(flash->map_size >= size)
+        return TRUE;
+
+    off_t file_size = emu_flash_file_size(flash);
+    while(file_size < size) {
+        size_t chunk = size - file_size > (off_t)sizeof(erased) ? sizeof(erased) : (size_t)(size - file_size);
+        ssize_t nb = pwrite(flash->fd, erased, chunk, file_size);
+        if(nb <= 0)
+            break;
+        file_size += nb;
+    }
+
+    // Remap to cover the new file size
+    emu_map_flash(flash);
+
+    if(flash->map_size < size) {
+        fprintf(stderr, "Failed to extend emulated flash %s\n", flash->name);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static void emu_sync_flash_range(emu_flash_t *flash, int offset, int length)
+{
+    long page_size = sysconf(_SC_PAGESIZE);
+    int aligned_offset = offset - (offset % page_size);
+
+    if(flash->map != NULL)
+        msync(flash->map + aligned_offset, length + (offset - aligned_offset), MS_SYNC);
+}
+
+static void emu_flash_read(emu_flash_t *flash, int offset, uint8_t *buf, int length)
+{
+    if(flash->fd >= 0 && emu_extend_flash(flash, offset+length)) {
+        memcpy(buf, flash->map + offset, length);
+    } else {
+        // reads as erased flash
+        memset(buf, 0xff, length);
+    }
+}
+
+static void emu_flash_write(emu_flash_t *flash, int offset, uint8_t *buf, int length)
+{
+    if(flash->fd >= 0 && emu_extend_flash(flash, offset+length)) {
+        memcpy(flash->map + offset, buf, length);
+
+        if(sync_policy == EMU_STORAGE_SYNC_ON_WRITE)
+            emu_sync_flash_range(flash, offset, length);
+    }
+}
+
+void emu_storage_set_sync_policy(emu_storage_sync_policy_te policy)
+{
+    sync_policy = policy;
+}
+
+void emu_storage_sync(void)
+{
+    emu_sync_flash_range(&eeprom, 0, eeprom.map_size);
+    emu_sync_flash_range(&dbflash, 0, dbflash.map_size);
+}
+
+BOOL emu_eeprom_open(void)
+{
+    return emu_open_flash(&eeprom);
+}
+
+void emu_eeprom_read(int offset, uint8_t *buf, int length)
+{
+    emu_flash_read(&eeprom, offset, buf, length);
+}
+
+void emu_eeprom_write(int offset, uint8_t *buf, int length)
+{
+    emu_flash_write(&eeprom, offset, buf, length);
+}
+
+BOOL emu_dbflash_open(void)
+{
+    return emu_open_flash(&dbflash);
+}
+
+void emu_dbflash_read(int offset, uint8_t *buf, int length)
+{
+    emu_flash_read(&dbflash, offset, buf, length);
+}
+
+void emu_dbflash_write(int offset, uint8_t *buf, int length)
+{
+    emu_flash_write(&dbflash, offset, buf, length);
+}
@@ -20,6 +20,7 @@ extern "C" {
 #include "emu_oled.h"
 #include "emu_smartcard.h"
 #include "emu_dataflash.h"
+#include "emu_storage.h"
 #include "emulator_ui.h"
 
 static struct emu_port_t _PORT;
@@ -177,8 +178,12 @@ int main(int ac, char ** av)
 
     parser.addOption(QCommandLineOption("smartcard", "Smartcard file to be used at startup", "smartcard"));
     parser.addOption(QCommandLineOption("bundle", "Specify path to bundle.img file", "bundle"));
+    parser.addOption(QCommandLineOption("storage-sync", "When to sync emulated flash files to disk: exit (default) or write", "policy"));
     parser.process(app);
 
+    if(parser.value("storage-sync") == "write")
+        emu_storage_set_sync_policy(EMU_STORAGE_SYNC_ON_WRITE);
+
     QTimer ms_timer;
     ms_timer.setInterval(1);
     ms_timer.start();
@@ -214,6 +219,7 @@ int main(int ac, char ** av)
     app.exec();
 
     app_thread.stop();
+    emu_storage_sync();
 
     delete oled;
     return 0;
@@ -24,6 +24,12 @@ void emu_charger_enable(BOOL en);
 
 BOOL emu_get_systick(uint32_t *value);
 
+#ifdef EMULATOR_HEADLESS_BUILD
+/* Headless emulator: timer ticks are generated when the firmware polls its timers or waits */
+void emu_timer_poll(void);
+void emu_delay_us(uint32_t us);
+#endif
+
 BOOL emu_get_lefthanded(void);
 
 int emu_get_failure_flags(void);
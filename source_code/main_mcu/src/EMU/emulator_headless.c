@@ -0,0 +1,414 @@
+/* Headless emulator: runs the firmware as a plain process, without Qt.
+ * - no OLED rendering, no UI: buttons are never pressed, battery/charger are fixed
+ * - HID transport over stdin/stdout or a UNIX socket (moolticute's local device socket by default)
+ * - real time (wall clock driven) or virtual time, where timers advance every time the firmware
+ *   looks at them so that delays and timeouts elapse instantly
+ * The whole firmware runs on the main thread, timer "interrupts" are generated from the timer polls.
+ */
+#include "asf.h"
+#include "driver_timer.h"
+#include "emulator.h"
+#include "emu_oled.h"
+#include "emu_smartcard.h"
+#include "emu_storage.h"
+#include "emu_dataflash.h"
+#include "emu_dbflash.h"
+#include "inputs.h"
+#include "logic_power.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define EMU_HEADLESS_DEFAULT_SOCKET     "/tmp/moolticuted_local_dev"
+
+static struct emu_port_t _PORT;
+struct emu_port_t *PORT=&_PORT;
+
+void minible_main(void);
+
+/* Single threaded: nothing can interrupt us */
+void cpu_irq_enter_critical(void) {}
+void cpu_irq_leave_critical(void) {}
+
+/*** Exit handling ***/
+
+static volatile sig_atomic_t app_exiting = 0;
+
+static void emu_headless_exit(int code)
+{
+    emu_storage_sync();
+    exit(code);
+}
+
+static void emu_headless_signal_handler(int sig)
+{
+    (void)sig;
+    app_exiting = 1;
+}
+
+void emu_appexit_test(void)
+{
+    if(app_exiting)
+        emu_headless_exit(0);
+}
+
+/*** Time ***/
+
+static BOOL virtual_time = FALSE;
+static uint64_t emulated_ms;
+static uint64_t start_ms;
+static BOOL in_tick;
+
+static uint64_t emu_monotonic_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void emu_run_ticks(uint64_t nb_ticks)
+{
+    /* Ticks may call code polling timers */
+    if(in_tick)
+        return;
+
+    in_tick = TRUE;
+    while(nb_ticks--) {
+        emulated_ms++;
+        timer_ms_tick();
+        inputs_scan();
+        logic_power_ms_tick();
+    }
+    in_tick = FALSE;
+}
+
+void emu_timer_poll(void)
+{
+    if(virtual_time) {
+        emu_run_ticks(1);
+    } else {
+        uint64_t now = emu_monotonic_ms() - start_ms;
+        if(now > emulated_ms)
+            emu_run_ticks(now - emulated_ms);
+    }
+}
+
+void emu_delay_us(uint32_t us)
+{
+    if(virtual_time) {
+        emu_run_ticks((us + 999) / 1000);
+    } else {
+        usleep(us);
+    }
+}
+
+BOOL emu_get_systick(uint32_t *value)
+{
+    static uint64_t last_systick;
+
+    // milliseconds to 48MHz ticks
+    uint64_t systick = emulated_ms * (uint64_t)48000;
+    BOOL wrapped = FALSE;
+    if((systick & 0xffffff) != (last_systick & 0xffffff))
+        wrapped = TRUE;
+
+    *value = systick & 0xffffff;
+    last_systick = systick;
+    return wrapped;
+}
+
+/*** HID transport ***/
+
+typedef struct {
+    const char *name;
+    BOOL (*connect)(void);          // (re)connect, return TRUE if connected
+    void (*disconnected)(void);     // called when the other side went away
+} emu_hid_transport_t;
+
+static int hid_fd_in = -1, hid_fd_out = -1;
+static const char *hid_socket_path = EMU_HEADLESS_DEFAULT_SOCKET;
+static const emu_hid_transport_t *hid_transport;
+
+static BOOL emu_hid_stdio_connect(void)
+{
+    if(hid_fd_in < 0) {
+        hid_fd_in = STDIN_FILENO;
+        hid_fd_out = STDOUT_FILENO;
+    }
+    return TRUE;
+}
+
+static void emu_hid_stdio_disconnected(void)
+{
+    // host closed our stdin: we're done
+    emu_headless_exit(0);
+}
+
+static BOOL emu_hid_unix_connect(void)
+{
+    struct sockaddr_un addr;
+
+    if(hid_fd_in >= 0)
+        return TRUE;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0)
+        return FALSE;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, hid_socket_path, sizeof(addr.sun_path)-1);
+    if(connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return FALSE;
+    }
+
+    hid_fd_in = hid_fd_out = fd;
+    return TRUE;
+}
+
+static void emu_hid_unix_disconnected(void)
+{
+    close(hid_fd_in);
+    hid_fd_in = hid_fd_out = -1;
+}
+
+static const emu_hid_transport_t emu_hid_transports[] = {
+    {"stdio", emu_hid_stdio_connect, emu_hid_stdio_disconnected},
+    {"unix", emu_hid_unix_connect, emu_hid_unix_disconnected},
+};
+
+void emu_send_hid(char *data, int size)
+{
+    if(!hid_transport->connect())
+        return;
+
+    while(size > 0) {
+        ssize_t nb = write(hid_fd_out, data, size);
+        if(nb < 0 && errno == EINTR)
+            continue;
+        if(nb <= 0) {
+            hid_transport->disconnected();
+            return;
+        }
+
+        data += nb;
+        size -= nb;
+    }
+}
+
+int emu_rcv_hid(char *data, int size)
+{
+    struct pollfd pfd;
+
+    emu_appexit_test();
+    emu_timer_poll();
+    if(!hid_transport->connect())
+        return -1;
+
+    /* In real time, don't spin at 100% CPU while idle */
+    pfd.fd = hid_fd_in;
+    pfd.events = POLLIN;
+    if(poll(&pfd, 1, virtual_time ? 0 : 1) <= 0)
+        return 0;
+
+    ssize_t nb = read(hid_fd_in, data, size);
+    if(nb == 0 || (nb < 0 && errno != EINTR && errno != EAGAIN)) {
+        hid_transport->disconnected();
+        return -1;
+    }
+
+    return nb > 0 ? (int)nb : 0;
+}
+
+/*** OLED: nothing is rendered ***/
+
+void emu_oled_byte(uint8_t data)
+{
+    (void)data;
+}
+
+void emu_oled_flush(void)
+{
+    emu_appexit_test();
+}
+
+/*** Inputs: the wheel is never touched ***/
+
+extern volatile uint16_t inputs_wheel_click_duration_counter;
+extern volatile det_ret_type_te inputs_wheel_click_return;
+
+void inputs_scan(void)
+{
+    if(inputs_wheel_click_return == RETURN_INV_DET) {
+        inputs_wheel_click_return = RETURN_REL;
+    } else if(inputs_wheel_click_return == RETURN_DET) {
+        inputs_wheel_click_return = RETURN_JRELEASED;
+    }
+    inputs_wheel_click_duration_counter = 0;
+}
+
+/*** Platform state ***/
+
+static BOOL charger_enabled;
+
+int emu_get_battery_level(void) { return 75; }
+BOOL emu_get_usb_charging(void) { return TRUE; }
+void emu_charger_enable(BOOL en) { charger_enabled = en; }
+BOOL emu_get_lefthanded(void) { return FALSE; }
+int emu_get_failure_flags(void) { return 0; }
+
+/*** Smartcard, stored in a file like the Qt emulator ***/
+
+static struct emu_smartcard_t card;
+static BOOL card_present = FALSE;
+static FILE *smartcard_file;
+
+struct emu_smartcard_t *emu_open_smartcard(void)
+{
+    return card_present ? &card : NULL;
+}
+
+void emu_close_smartcard(BOOL written)
+{
+    if(written && smartcard_file) {
+        fseek(smartcard_file, 0, SEEK_SET);
+        fwrite(&card.storage, sizeof(card.storage), 1, smartcard_file);
+        fflush(smartcard_file);
+    }
+}
+
+void emu_reset_smartcard(void)
+{
+    card.unlocked = FALSE;
+}
+
+/* Insert the card stored in file_path, create a new blank card if it doesn't exist */
+static BOOL emu_headless_insert_smartcard(const char *file_path)
+{
+    memset(&card, 0, sizeof(card));
+
+    smartcard_file = fopen(file_path, "r+b");
+    if(smartcard_file) {
+        if(fread(&card.storage, sizeof(card.storage), 1, smartcard_file) != 1)
+            return FALSE;
+    } else {
+        smartcard_file = fopen(file_path, "w+b");
+        if(!smartcard_file)
+            return FALSE;
+        emu_init_smartcard(&card.storage, EMU_SMARTCARD_REGULAR);
+        emu_close_smartcard(TRUE);
+    }
+
+    card_present = TRUE;
+    return TRUE;
+}
+
+/*** Entry point ***/
+
+static void emu_headless_usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [options]\n"
+        "  --bundle PATH          bundle image to use\n"
+        "  --smartcard PATH       smartcard file inserted at startup, created if missing\n"
+        "  --hid stdio|unix[:PATH] HID transport, default unix:" EMU_HEADLESS_DEFAULT_SOCKET "\n"
+        "  --time real|virtual    virtual: timers advance instantly whenever the firmware waits\n"
+        "  --storage-sync exit|write  when to sync emulated flash files to disk\n"
+        "  --crc32-benchmark      time the bundle crc32 implementations and check them against the bundle header, then exit\n"
+        "  --dbflash-cache-test   check that the database flash cache writes pages back in write order and doesn't corrupt batched node writes, then exit\n", name);
+}
+
+int main(int ac, char **av)
+{
+    static const struct option options[] = {
+        {"bundle", required_argument, NULL, 'b'},
+        {"smartcard", required_argument, NULL, 's'},
+        {"hid", required_argument, NULL, 'H'},
+        {"time", required_argument, NULL, 't'},
+        {"storage-sync", required_argument, NULL, 'y'},
+        {"crc32-benchmark", no_argument, NULL, 'c'},
+        {"dbflash-cache-test", no_argument, NULL, 'd'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    const char *bundle = NULL;
+    const char *smartcard = NULL;
+    BOOL crc32_benchmark = FALSE;
+    BOOL dbflash_cache_test = FALSE;
+    int opt;
+
+    hid_transport = &emu_hid_transports[1];
+
+    while((opt = getopt_long(ac, av, "h", options, NULL)) != -1) {
+        switch(opt) {
+            case 'b':
+                bundle = optarg;
+                break;
+            case 's':
+                smartcard = optarg;
+                break;
+            case 'H':
+                if(strcmp(optarg, "stdio") == 0) {
+                    hid_transport = &emu_hid_transports[0];
+                } else if(strncmp(optarg, "unix", 4) == 0 && (optarg[4] == 0 || optarg[4] == ':')) {
+                    hid_transport = &emu_hid_transports[1];
+                    if(optarg[4] == ':')
+                        hid_socket_path = optarg + 5;
+                } else {
+                    emu_headless_usage(av[0]);
+                    return 1;
+                }
+                break;
+            case 't':
+                virtual_time = strcmp(optarg, "virtual") == 0;
+                break;
+            case 'y':
+                if(strcmp(optarg, "write") == 0)
+                    emu_storage_set_sync_policy(EMU_STORAGE_SYNC_ON_WRITE);
+                break;
+            case 'c':
+                crc32_benchmark = TRUE;
+                break;
+            case 'd':
+                dbflash_cache_test = TRUE;
+                break;
+            default:
+                emu_headless_usage(av[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    // ensure that the calendar works in UTC, so that time doesn't shift unpredictably
+    setenv("TZ", "", 1);
+
+    signal(SIGINT, emu_headless_signal_handler);
+    signal(SIGTERM, emu_headless_signal_handler);
+    signal(SIGPIPE, SIG_IGN);
+
+    start_ms = emu_monotonic_ms();
+
+    if(smartcard && !emu_headless_insert_smartcard(smartcard))
+        fprintf(stderr, "Failed to insert smartcard %s\n", smartcard);
+
+    emu_dataflash_init(bundle);
+    if(crc32_benchmark)
+        return emu_dataflash_crc32_benchmark(20);
+    if(dbflash_cache_test)
+        return emu_dbflash_cache_ordering_test() | emu_dbflash_batch_write_test();
+
+    fprintf(stderr, "Headless emulator started, HID over %s, %s time\n", hid_transport->name, virtual_time ? "virtual" : "real");
+    minible_main();
+
+    emu_headless_exit(0);
+    return 0;
+}
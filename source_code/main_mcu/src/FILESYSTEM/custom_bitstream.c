@@ -45,6 +45,7 @@ void bitstream_bitmap_init(bitstream_bitmap_t* bs, bitmap_t* bitmap, custom_fs_a
     bs->_count = 0;
     bs->_flags = bitmap->flags;
     bs->addr = address;
+    bs->ram_data_pt = 0;
     bs->bufSel = 0;
     bs->_exclusive_transfer = exclusive;
 
@@ -110,6 +111,7 @@ void bitstream_glyph_bitmap_init(bitstream_bitmap_t* bs, font_header_t* font, fo
     bs->_count = 0;
     bs->_flags = 0;
     bs->addr = address;
+    bs->ram_data_pt = 0;
     bs->bufSel = 0;
     bs->_exclusive_transfer = exclusive;
 
@@ -155,6 +157,32 @@ void bitstream_glyph_bitmap_init(bitstream_bitmap_t* bs, font_header_t* font, fo
     #endif
 }
 
+/*! \fn     bitstream_glyph_bitmap_init_from_ram(bitstream_bitmap_t* bs, font_header_t* font, font_glyph_t* glyph, uint8_t* data_pt)
+*   \brief  Initialize a glyph bitstream whose data was already fetched to RAM
+*   \param  bs          Pointer to a bitmap bitstream structure
+*   \param  font        Pointer to a font structure
+*   \param  glyph       Pointer to a glyph structure
+*   \param  data_pt     Pointer to the glyph data
+*/
+void bitstream_glyph_bitmap_init_from_ram(bitstream_bitmap_t* bs, font_header_t* font, font_glyph_t* glyph, uint8_t* data_pt)
+{
+    bs->bitsPerPixel = font->depth;
+    bs->width = glyph->xrect;
+    bs->height = glyph->yrect;
+    bs->_size = ((bs->width*bs->bitsPerPixel+7)/8) * bs->height;
+    bs->mask = (1 << bs->bitsPerPixel) - 1;
+    bs->_bits = 0;
+    bs->_word = 0xAA55;
+    bs->_count = 0;
+    bs->_flags = 0;
+    bs->addr = 0;
+    bs->ram_data_pt = data_pt;
+    bs->bufSel = 0;
+    bs->bufInd = sizeof(bs->buf[0]);
+    bs->_exclusive_transfer = FALSE;
+    bs->_dma_transfer = FALSE;
+}
+
 /*! \fn     bitstream_bitmap_get_next_byte(bitstream_bitmap_t* bs)
 *   \brief  Get the next byte of a bitmap bitstream
 *   \param  bs          Pointer to a bitmap bitstream structure
@@ -165,6 +193,12 @@ static inline uint8_t bitstream_bitmap_get_next_byte(bitstream_bitmap_t* bs)
     /* Check if didn't read too much data */
     if (bs->_count < bs->_size) 
     {
+        /* Data already in RAM */
+        if (bs->ram_data_pt != 0)
+        {
+            return bs->ram_data_pt[bs->_count++];
+        }
+        
         /* Increment read counter */
         bs->_count++;
         
@@ -426,6 +460,12 @@ void bitstream_bitmap_array_read_rev(bitstream_bitmap_t* bs, uint16_t* data, uin
 */
 void bitstream_bitmap_close(bitstream_bitmap_t* bs)
 {
+    /* Nothing to stop if data was in RAM */
+    if (bs->ram_data_pt != 0)
+    {
+        return;
+    }
+    
     #ifdef FLASH_ALONE_ON_SPI_BUS
         BOOL using_emergency_data = (bs->addr < CUSTOM_FS_EMERGENCY_FONT_FILE_ADDR)?FALSE:TRUE;
         if (bs->_dma_transfer != FALSE)
@@ -41,6 +41,7 @@ typedef struct
     uint8_t _pixel;             //*< current pixel for RLE decompress
     uint8_t _flags;		        //*< format flags.  E.g. RLE=1
     custom_fs_address_t addr;	//*< address of data in SPI FLASH store.
+    uint8_t* ram_data_pt;       //*< if not 0, pointer to the data already in RAM
     uint8_t buf[2][32];	        //*< FLASH read-ahead buffer
     uint32_t bufInd;	        //*< read-ahead buffer index
     uint32_t bufSel;            //*< specify which of the 2 buffers we're using
@@ -50,6 +51,7 @@ typedef struct
 
 /* Prototypes */
 void bitstream_glyph_bitmap_init(bitstream_bitmap_t* bs, font_header_t* font, font_glyph_t* glyph, custom_fs_address_t address, BOOL exclusive);
+void bitstream_glyph_bitmap_init_from_ram(bitstream_bitmap_t* bs, font_header_t* font, font_glyph_t* glyph, uint8_t* data_pt);
 void bitstream_bitmap_array_read_rev(bitstream_bitmap_t* bs, uint16_t* data, uint16_t nb_pixels, uint16_t pixel_shift);
 void bitstream_bitmap_init(bitstream_bitmap_t* bs, bitmap_t* bitmap, custom_fs_address_t address, BOOL exclusive);
 uint16_t bitstream_bitmap_read_rev_with_shift(bitstream_bitmap_t* bs, uint16_t nb_pixels, uint16_t pixel_shift);
@@ -108,6 +108,8 @@ custom_fs_address_t custom_fs_usb_keyboard_layout_addr = 0;
 uint8_t custom_fs_cur_usb_keyboard_id = 0;
 custom_fs_address_t custom_fs_ble_keyboard_layout_addr = 0;
 uint8_t custom_fs_cur_ble_keyboard_id = 0;
+/* Last used keyboard layout, decoded on demand */
+keyboard_layout_cache_t custom_fs_keyboard_layout_cache;
 /* CPZ look up table */
 cpz_lut_entry_t* custom_fs_cpz_lut;
 
@@ -317,7 +319,6 @@ RET_TYPE custom_fs_continuous_read_from_flash(uint8_t* datap, custom_fs_address_
 */
 RET_TYPE custom_fs_compute_and_check_external_bundle_crc32(void)
 {
-#ifndef EMULATOR_BUILD
     /* Start a read on external flash */
     dataflash_read_data_array_start(custom_fs_dataflash_desc, CUSTOM_FS_FILES_ADDR_OFFSET + sizeof(custom_fs_flash_header.magic_header) + sizeof(custom_fs_flash_header.total_size) + sizeof(custom_fs_flash_header.crc32));
 
@@ -342,11 +343,41 @@ RET_TYPE custom_fs_compute_and_check_external_bundle_crc32(void)
     {
         return RETURN_NOK;
     }
+}
 
-#else
-    /* We don't emulate the DMA controller, and don't bother with reimplementing the crc32 routines */
-    return RETURN_OK;
-#endif
+/*! \fn     custom_fs_compute_external_flash_crc32(custom_fs_address_t address, uint32_t size)
+*   \brief  Compute the crc32 of an external flash area, using the DMA CRC engine on the custom fs transfers
+*   \param  address     Address of the area
+*   \param  size        Size of the area
+*   \return the crc32, computed the same way as the bundle crc32
+*   \note   Unlike custom_fs_compute_and_check_external_bundle_crc32, doesn't reset the DMA controller and can be called at run time
+*/
+uint32_t custom_fs_compute_external_flash_crc32(custom_fs_address_t address, uint32_t size)
+{
+    uint32_t temp_buffer[64];
+    
+    /* Start a read on external flash */
+    dataflash_read_data_array_start(custom_fs_dataflash_desc, address);
+    
+    /* Feed the read data to the CRC engine through our DMA channel */
+    dma_custom_fs_crc32_start();
+    while (size > 0)
+    {
+        uint16_t nb_bytes_to_read = sizeof(temp_buffer);
+        if (size < nb_bytes_to_read)
+        {
+            nb_bytes_to_read = (uint16_t)size;
+        }
+        
+        dma_custom_fs_init_transfer(custom_fs_dataflash_desc->sercom_pt, (void*)temp_buffer, nb_bytes_to_read);
+        while(dma_custom_fs_check_and_clear_dma_transfer_flag() == FALSE);
+        size -= nb_bytes_to_read;
+    }
+    uint32_t crc32 = dma_custom_fs_crc32_get_and_stop();
+    
+    /* Stop transfer */
+    dataflash_stop_ongoing_transfer(custom_fs_dataflash_desc);
+    return crc32;
 }
 
 /*! \fn     custom_fs_stop_continuous_read_from_flash(BOOL was_using_emergency_bundle_data)
@@ -482,6 +513,147 @@ ret_type_te custom_fs_get_keyboard_descriptor_string(uint8_t keyboard_id, cust_c
     return RETURN_OK;
 }
 
+/*! \fn     custom_fs_get_keyboard_symbol_from_flash(custom_fs_address_t layout_address, cust_char_t unicode_point)
+*   \brief  Get the keyboard symbol for a unicode point by reading the layout file
+*   \param  layout_address  Keyboard layout file address
+*   \param  unicode_point   The unicode point
+*   \return The keyboard symbol, 0xFFFF if not supported
+*   \note   Only used for points that didn't fit in our layout cache
+*/
+static uint16_t custom_fs_get_keyboard_symbol_from_flash(custom_fs_address_t layout_address, cust_char_t unicode_point)
+{
+    unicode_interval_desc_t description_intervals[CUSTOM_FS_KEYB_NB_INT_DESCRIBED];
+    uint16_t symbol_desc_pt_offset = 0;
+    uint16_t symbol = 0xFFFF;
+    
+    /* Load the description intervals */
+    custom_fs_read_from_flash((uint8_t*)description_intervals, layout_address + CUSTOM_FS_KEYBOARD_DESC_LGTH*sizeof(cust_char_t), sizeof(description_intervals));
+    
+    /* Check that support for this point is described */
+    for (uint16_t i = 0; i < ARRAY_SIZE(description_intervals); i++)
+    {
+        /* Check if char is within this interval */
+        if ((description_intervals[i].interval_start != 0xFFFF) && (description_intervals[i].interval_start <= unicode_point) && (description_intervals[i].interval_end >= unicode_point))
+        {
+            /* Fetch keyboard symbol: 0xFFFF for "not supported" */
+            custom_fs_read_from_flash((uint8_t*)&symbol, layout_address + CUSTOM_FS_KEYBOARD_DESC_LGTH*sizeof(cust_char_t) + sizeof(description_intervals) + (symbol_desc_pt_offset + unicode_point - description_intervals[i].interval_start)*sizeof(uint16_t), sizeof(symbol));
+            break;
+        }
+        
+        /* Add offset to descriptor */
+        symbol_desc_pt_offset += description_intervals[i].interval_end - description_intervals[i].interval_start + 1;
+    }
+    
+    return symbol;
+}
+
+/*! \fn     custom_fs_add_keyboard_layout_cache_sparse_symbol(cust_char_t unicode_point, uint16_t symbol)
+*   \brief  Add a symbol for a point outside of the dense range to our keyboard layout cache
+*   \param  unicode_point   The unicode point
+*   \param  symbol          The keyboard symbol
+*/
+static void custom_fs_add_keyboard_layout_cache_sparse_symbol(cust_char_t unicode_point, uint16_t symbol)
+{
+    keyboard_layout_cache_t* cache_pt = &custom_fs_keyboard_layout_cache;
+    
+    if (cache_pt->nb_sparse_symbols == ARRAY_SIZE(cache_pt->sparse_symbols))
+    {
+        cache_pt->sparse_symbols_complete = FALSE;
+        return;
+    }
+    
+    /* Sorted insert: intervals are normally stored in ascending order so this is mostly an append */
+    uint16_t insert_index = cache_pt->nb_sparse_symbols;
+    while ((insert_index > 0) && (cache_pt->sparse_symbols[insert_index-1].unicode_point > unicode_point))
+    {
+        cache_pt->sparse_symbols[insert_index] = cache_pt->sparse_symbols[insert_index-1];
+        insert_index--;
+    }
+    cache_pt->sparse_symbols[insert_index].unicode_point = unicode_point;
+    cache_pt->sparse_symbols[insert_index].symbol = symbol;
+    cache_pt->nb_sparse_symbols++;
+}
+
+/*! \fn     custom_fs_load_keyboard_layout_cache(custom_fs_address_t layout_address)
+*   \brief  Decode a keyboard layout file into our RAM look up table
+*   \param  layout_address  Keyboard layout file address
+*   \note   Only one layout is cached: typing alternatively on USB & BLE with different layouts decodes the file each time
+*/
+static void custom_fs_load_keyboard_layout_cache(custom_fs_address_t layout_address)
+{
+    unicode_interval_desc_t description_intervals[CUSTOM_FS_KEYB_NB_INT_DESCRIBED];
+    custom_fs_address_t symbols_address = layout_address + CUSTOM_FS_KEYBOARD_DESC_LGTH*sizeof(cust_char_t) + sizeof(description_intervals);
+    keyboard_layout_cache_t* cache_pt = &custom_fs_keyboard_layout_cache;
+    BOOL return_described = FALSE;
+    BOOL tab_described = FALSE;
+    uint16_t symbols_buffer[32];
+    
+    /* Reset cache */
+    memset(cache_pt->dense_symbols, 0xFF, sizeof(cache_pt->dense_symbols));
+    cache_pt->layout_address = layout_address;
+    cache_pt->sparse_symbols_complete = TRUE;
+    cache_pt->nb_sparse_symbols = 0;
+    
+    /* Load the description intervals */
+    custom_fs_read_from_flash((uint8_t*)description_intervals, layout_address + CUSTOM_FS_KEYBOARD_DESC_LGTH*sizeof(cust_char_t), sizeof(description_intervals));
+    
+    /* Tab & return are typeable when not described by the layout */
+    for (uint16_t i = 0; i < ARRAY_SIZE(description_intervals); i++)
+    {
+        if ((description_intervals[i].interval_start != 0xFFFF) && (description_intervals[i].interval_start <= 0x09) && (description_intervals[i].interval_end >= 0x09))
+        {
+            tab_described = TRUE;
+        }
+        if ((description_intervals[i].interval_start != 0xFFFF) && (description_intervals[i].interval_start <= 0x0A) && (description_intervals[i].interval_end >= 0x0A))
+        {
+            return_described = TRUE;
+        }
+    }
+    if (tab_described == FALSE)
+    {
+        custom_fs_add_keyboard_layout_cache_sparse_symbol(0x09, KEY_TAB);
+    }
+    if (return_described == FALSE)
+    {
+        custom_fs_add_keyboard_layout_cache_sparse_symbol(0x0A, KEY_RETURN);
+    }
+    
+    /* Decode each interval */
+    for (uint16_t i = 0; i < ARRAY_SIZE(description_intervals); i++)
+    {
+        if ((description_intervals[i].interval_start == 0xFFFF) || (description_intervals[i].interval_end < description_intervals[i].interval_start))
+        {
+            continue;
+        }
+        
+        /* Read symbols by chunks */
+        uint32_t unicode_point = description_intervals[i].interval_start;
+        while (unicode_point <= description_intervals[i].interval_end)
+        {
+            uint16_t nb_symbols_to_read = ARRAY_SIZE(symbols_buffer);
+            if (description_intervals[i].interval_end - unicode_point + 1 < nb_symbols_to_read)
+            {
+                nb_symbols_to_read = description_intervals[i].interval_end - unicode_point + 1;
+            }
+            custom_fs_read_from_flash((uint8_t*)symbols_buffer, symbols_address, nb_symbols_to_read*sizeof(uint16_t));
+            symbols_address += nb_symbols_to_read*sizeof(uint16_t);
+            
+            for (uint16_t j = 0; j < nb_symbols_to_read; j++, unicode_point++)
+            {
+                if ((unicode_point >= CUSTOM_FS_KEYB_FIRST_DENSE_POINT) && (unicode_point < CUSTOM_FS_KEYB_FIRST_DENSE_POINT + ARRAY_SIZE(cache_pt->dense_symbols)))
+                {
+                    /* Described points are stored even when not supported, matching our definition of described */
+                    cache_pt->dense_symbols[unicode_point - CUSTOM_FS_KEYB_FIRST_DENSE_POINT] = symbols_buffer[j];
+                }
+                else if (symbols_buffer[j] != 0xFFFF)
+                {
+                    custom_fs_add_keyboard_layout_cache_sparse_symbol((cust_char_t)unicode_point, symbols_buffer[j]);
+                }
+            }
+        }
+    }
+}
+
 /*! \fn     custom_fs_set_current_keyboard_id(uint8_t keyboard_id, BOOL usb_layout)
 *   \brief  Set current keyboard ID
 *   \param  keyboard_id     Keyboard ID
@@ -501,7 +673,8 @@ ret_type_te custom_fs_set_current_keyboard_id(uint8_t keyboard_id, BOOL usb_layo
         return RETURN_NOK;
     }
     
-    /* Store address and ID */
+    /* Store address and ID, layout file may have changed: invalidate our decoded layout */
+    custom_fs_keyboard_layout_cache.layout_address = 0;
     if (usb_layout == FALSE)
     {
         custom_fs_ble_keyboard_layout_addr = layout_file_addr;
@@ -523,15 +696,13 @@ ret_type_te custom_fs_set_current_keyboard_id(uint8_t keyboard_id, BOOL usb_layo
 *   \param  usb_layout  Set to TRUE to use USB layout mapping, FALSE for BLE layout mapping
 *   \return RETURN_(N)OK depending on if we were able to "translate" the complete string
 *   \note   Take care of buffer overflows. One symbol will be generated per unicode point
+*   \note   Decodes the layout in our RAM cache if needed: no other flash reads unless the layout was too big for our cache
 */
 ret_type_te custom_fs_get_keyboard_symbols_for_unicode_string(cust_char_t* string_pt, uint16_t* buffer, BOOL usb_layout)
 {
-    unicode_interval_desc_t description_intervals[CUSTOM_FS_KEYB_NB_INT_DESCRIBED];
+    keyboard_layout_cache_t* cache_pt = &custom_fs_keyboard_layout_cache;
     custom_fs_address_t layout_address = custom_fs_usb_keyboard_layout_addr;
-    BOOL point_support_described = FALSE;
-    uint16_t symbol_desc_pt_offset = 0;
     BOOL all_points_described = TRUE;
-    uint16_t interval_start = 0;
     
     /* Check for correctly setup keyboard layout */
     if ((custom_fs_usb_keyboard_layout_addr == 0) || (custom_fs_ble_keyboard_layout_addr == 0))
@@ -539,67 +710,62 @@ ret_type_te custom_fs_get_keyboard_symbols_for_unicode_string(cust_char_t* strin
         return RETURN_NOK;
     }   
     
-    /* Mapping address based on layout selection */
+    /* Mapping based on layout selection */
     if (usb_layout == FALSE)
     {
         layout_address = custom_fs_ble_keyboard_layout_addr;
     }
     
-    /* Load the description intervals */
-    custom_fs_read_from_flash((uint8_t*)description_intervals, layout_address + CUSTOM_FS_KEYBOARD_DESC_LGTH*sizeof(cust_char_t), sizeof(description_intervals));
+    /* Decode layout if it isn't the one in our cache */
+    if (cache_pt->layout_address != layout_address)
+    {
+        custom_fs_load_keyboard_layout_cache(layout_address);
+    }
     
-    /* Iterate over string */
+    /* Iterate over string, which may be the same buffer as our output one */
     while (*string_pt != 0)
     {
-        /* Reset vars */
-        point_support_described = FALSE;
-        symbol_desc_pt_offset = 0;
-        interval_start = 0;
+        cust_char_t unicode_point = *string_pt;
+        uint16_t symbol = 0xFFFF;
         
-        /* Check that support for this point is described */
-        for (uint16_t i = 0; i < ARRAY_SIZE(description_intervals); i++)
+        if ((unicode_point >= CUSTOM_FS_KEYB_FIRST_DENSE_POINT) && (unicode_point < CUSTOM_FS_KEYB_FIRST_DENSE_POINT + ARRAY_SIZE(cache_pt->dense_symbols)))
         {
-            /* Check if char is within this interval */
-            if ((description_intervals[i].interval_start != 0xFFFF) && (description_intervals[i].interval_start <= *string_pt) && (description_intervals[i].interval_end >= *string_pt))
-            {
-                interval_start = description_intervals[i].interval_start;
-                point_support_described = TRUE;
-                break;
-            }
-            
-            /* Add offset to descriptor */
-            symbol_desc_pt_offset += description_intervals[i].interval_end - description_intervals[i].interval_start + 1;
+            symbol = cache_pt->dense_symbols[unicode_point - CUSTOM_FS_KEYB_FIRST_DENSE_POINT];
         }
-        
-        /* Check for described point support */
-        if (point_support_described == FALSE)
+        else
         {
-            /* Check for tab or return */
-            if (*string_pt == 0x09)
+            /* Binary search in the sparse table */
+            uint16_t lower_index = 0;
+            uint16_t upper_index = cache_pt->nb_sparse_symbols;
+            while (lower_index < upper_index)
             {
-                *buffer = KEY_TAB;
-            } 
-            else if (*string_pt == 0x0A)
+                uint16_t middle_index = (lower_index + upper_index) / 2;
+                if (cache_pt->sparse_symbols[middle_index].unicode_point < unicode_point)
+                {
+                    lower_index = middle_index + 1;
+                }
+                else
+                {
+                    upper_index = middle_index;
+                }
+            }
+            if ((lower_index < cache_pt->nb_sparse_symbols) && (cache_pt->sparse_symbols[lower_index].unicode_point == unicode_point))
             {
-                *buffer = KEY_RETURN;
-            } 
-            else
+                symbol = cache_pt->sparse_symbols[lower_index].symbol;
+            }
+            else if (cache_pt->sparse_symbols_complete == FALSE)
             {
-                all_points_described = FALSE;
-                *buffer = 0xFFFF;
+                /* Layout too big for our cache */
+                symbol = custom_fs_get_keyboard_symbol_from_flash(layout_address, unicode_point);
             }
         }
-        else
+        
+        /* Is this symbol supported? */
+        *buffer = symbol;
+        if (symbol == 0xFFFF)
         {
-            /* Fetch keyboard symbol: 0xFFFF for "not supported" matches with our definition of not described */
-            custom_fs_read_from_flash((uint8_t*)buffer, layout_address + CUSTOM_FS_KEYBOARD_DESC_LGTH*sizeof(cust_char_t) + sizeof(description_intervals) + symbol_desc_pt_offset*sizeof(*string_pt) + (*string_pt - interval_start)*sizeof(*string_pt), sizeof(*buffer));       
-            
-            /* Is this symbol supported? */
-            if (*buffer == 0xFFFF)
-            {
-                all_points_described = FALSE;
-            }
-        }        
+            all_points_described = FALSE;
+        }
         
         /* Move on to the next point */
         string_pt++;
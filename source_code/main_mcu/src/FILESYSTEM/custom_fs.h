@@ -42,6 +42,7 @@ RET_TYPE custom_fs_get_string_from_file(uint32_t string_id, cust_char_t** string
 ret_type_te custom_fs_get_keyboard_descriptor_string(uint8_t keyboard_id, cust_char_t* string_pt);
 RET_TYPE custom_fs_read_from_flash(uint8_t* datap, custom_fs_address_t address, uint32_t size);
 ret_type_te custom_fs_get_language_description(uint8_t language_id, cust_char_t* string_pt);
+uint32_t custom_fs_compute_external_flash_crc32(custom_fs_address_t address, uint32_t size);
 void custom_fs_read_256B_at_internal_custom_storage_slot(uint32_t slot_id, void* array);
 void custom_fs_get_time_calibration_data(time_calibration_data_t* time_calib_data_pt);
 void custom_fs_stop_continuous_read_from_flash(BOOL was_using_emergency_bundle_data);
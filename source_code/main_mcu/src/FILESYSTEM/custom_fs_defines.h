@@ -52,6 +52,9 @@
 /* Fields sizes */
 #define CUSTOM_FS_KEYBOARD_DESC_LGTH        20
 #define CUSTOM_FS_KEYB_NB_INT_DESCRIBED     20
+#define CUSTOM_FS_KEYB_FIRST_DENSE_POINT    0x20
+#define CUSTOM_FS_KEYB_NB_DENSE_POINTS      (0x100 - CUSTOM_FS_KEYB_FIRST_DENSE_POINT)
+#define CUSTOM_FS_KEYB_NB_SPARSE_POINTS     96
 
 /* Settings IDs */
 #define NB_DEVICE_SETTINGS                  64
@@ -263,4 +266,21 @@ typedef struct
     uint8_t reserved[6];
 } cpz_lut_entry_t;
 
+// Keyboard symbol for a unicode point outside of the dense range
+typedef struct
+{
+    uint16_t unicode_point;
+    uint16_t symbol;
+} keyboard_sparse_symbol_t;
+
+// Decoded keyboard layout, see custom_fs_load_keyboard_layout_cache()
+typedef struct
+{
+    custom_fs_address_t layout_address;                                         // Address of the decoded layout file, 0 when empty
+    uint16_t dense_symbols[CUSTOM_FS_KEYB_NB_DENSE_POINTS];                     // Symbols for printable ASCII / Latin-1, 0xFFFF when not supported
+    keyboard_sparse_symbol_t sparse_symbols[CUSTOM_FS_KEYB_NB_SPARSE_POINTS];   // Supported symbols for other points, sorted by unicode point
+    uint16_t nb_sparse_symbols;
+    BOOL sparse_symbols_complete;                                               // FALSE when the layout had more points than we could cache
+} keyboard_layout_cache_t;
+
 #endif /* CUSTOM_FS_DEFINES_H_ */
@@ -23,6 +23,77 @@
 #include "driver_sercom.h"
 #include "driver_timer.h"
 #include "dataflash.h"
+/* Set when a page program or an erase was started without waiting for its completion */
+BOOL dataflash_write_ongoing = FALSE;
+
+
+/*! \fn     dataflash_send_page_program(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint32_t length)
+*   \brief  Send a page program command, without waiting for its completion
+*   \param  descriptor_pt   Pointer to dataflash descriptor
+*   \param  address         Address at which we should write the data
+*   \param  data            Pointer to the buffer containing the data of interest
+*   \param  length          Length of data to write, page boundary shouldn't be crossed
+*/
+static void dataflash_send_page_program(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint32_t length)
+{
+    /* Write enable */
+    dataflash_send_write_enable(descriptor_pt);
+    
+    /* SS low */
+    PORT->Group[descriptor_pt->cs_pin_group].OUTCLR.reg = descriptor_pt->cs_pin_mask;
+    
+    /* Send write command */
+    sercom_spi_send_single_byte(descriptor_pt->sercom_pt, 0x02);
+    sercom_spi_send_single_byte(descriptor_pt->sercom_pt, (uint8_t)((address >> 16) & 0x0FF));
+    sercom_spi_send_single_byte(descriptor_pt->sercom_pt, (uint8_t)((address >> 8) & 0x0FF));
+    sercom_spi_send_single_byte(descriptor_pt->sercom_pt, (uint8_t)((address >> 0) & 0x0FF));
+    
+    /* Send data */
+    for (uint32_t i = 0; i < length; i++)
+    {
+        sercom_spi_send_single_byte(descriptor_pt->sercom_pt, *data++);
+    }
+    
+    /* SS high */
+    PORT->Group[descriptor_pt->cs_pin_group].OUTSET.reg = descriptor_pt->cs_pin_mask;
+}
+
+/*! \fn     dataflash_wait_for_ongoing_write(spi_flash_descriptor_t* descriptor_pt)
+*   \brief  Wait for the end of a page program or erase we didn't wait for
+*   \param  descriptor_pt   Pointer to dataflash descriptor
+*/
+static void dataflash_wait_for_ongoing_write(spi_flash_descriptor_t* descriptor_pt)
+{
+    if (dataflash_write_ongoing != FALSE)
+    {
+        dataflash_wait_for_not_busy(descriptor_pt);
+    }
+}
+
+/*! \fn     dataflash_write_page_without_wait(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint32_t length)
+*   \brief  Start writing data inside a single page, without waiting for the page program to end
+*   \param  descriptor_pt   Pointer to dataflash descriptor
+*   \param  address         Address at which we should write the data
+*   \param  data            Pointer to the buffer containing the data of interest
+*   \param  length          Length of data to write
+*   \note   Flash should be previously erased before calling this function
+*   \note   Waits for a previous page program to end, other dataflash accesses do the same
+*/
+void dataflash_write_page_without_wait(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint32_t length)
+{
+    /* Do not cross page boundaries: the flash would wrap around inside the page */
+    if ((length == 0) || (((address & 0x0FF) + length) > W25Q16_PAGE_SIZE))
+    {
+        return;
+    }
+    
+    /* Previous page program must be over before we can send a new one */
+    dataflash_wait_for_ongoing_write(descriptor_pt);
+    
+    /* Start programming, device busy for up to 3ms */
+    dataflash_send_page_program(descriptor_pt, address, data, length);
+    dataflash_write_ongoing = TRUE;
+}
 
 
 /*! \fn     dataflash_write_array_to_memory(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint32_t length)
@@ -35,6 +106,9 @@
 */
 void dataflash_write_array_to_memory(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint32_t length)
 {
+    /* Let a possibly ongoing write finish */
+    dataflash_wait_for_ongoing_write(descriptor_pt);
+    
     uint32_t nb_bytes_to_write = 0;
     
     /* First run: check if we're aligned and compute number of bytes to write accordingly */
@@ -61,29 +135,12 @@ void dataflash_write_array_to_memory(spi_flash_descriptor_t* descriptor_pt, uint
         /* Guaranteed to not go below 0 */
         length -= nb_bytes_to_write;
         
-        /* Write enable */
-        dataflash_send_write_enable(descriptor_pt);
-        
-        /* SS low */
-        PORT->Group[descriptor_pt->cs_pin_group].OUTCLR.reg = descriptor_pt->cs_pin_mask;
-        
-        /* Send write command */
-        sercom_spi_send_single_byte(descriptor_pt->sercom_pt, 0x02);
-        sercom_spi_send_single_byte(descriptor_pt->sercom_pt, (uint8_t)((address >> 16) & 0x0FF));
-        sercom_spi_send_single_byte(descriptor_pt->sercom_pt, (uint8_t)((address >> 8) & 0x0FF));
-        sercom_spi_send_single_byte(descriptor_pt->sercom_pt, (uint8_t)((address >> 0) & 0x0FF));
-        
-        /* Send data */
-        for (uint32_t i = 0; i < nb_bytes_to_write; i++)
-        {
-            sercom_spi_send_single_byte(descriptor_pt->sercom_pt, *data++);
-        }
-        
-        /* SS high */
-        PORT->Group[descriptor_pt->cs_pin_group].OUTSET.reg = descriptor_pt->cs_pin_mask;
+        /* Program page */
+        dataflash_send_page_program(descriptor_pt, address, data, nb_bytes_to_write);
         
-        /* Increment address */
+        /* Increment address & data pointer */
         address += nb_bytes_to_write;
+        data += nb_bytes_to_write;
         
         /* Compute remaining bytes to write */
         nb_bytes_to_write = W25Q16_PAGE_SIZE;
@@ -106,6 +163,9 @@ void dataflash_write_array_to_memory(spi_flash_descriptor_t* descriptor_pt, uint
 */
 void dataflash_read_data_array(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint32_t length)
 {
+    /* Let a possibly ongoing write finish */
+    dataflash_wait_for_ongoing_write(descriptor_pt);
+    
     /* SS low */
     PORT->Group[descriptor_pt->cs_pin_group].OUTCLR.reg = descriptor_pt->cs_pin_mask;
     
@@ -133,6 +193,9 @@ void dataflash_read_data_array(spi_flash_descriptor_t* descriptor_pt, uint32_t a
 */
 void dataflash_read_data_array_start(spi_flash_descriptor_t* descriptor_pt, uint32_t address)
 {
+    /* Let a possibly ongoing write finish */
+    dataflash_wait_for_ongoing_write(descriptor_pt);
+    
     /* SS low */
     PORT->Group[descriptor_pt->cs_pin_group].OUTCLR.reg = descriptor_pt->cs_pin_mask;
     
@@ -250,6 +313,7 @@ RET_TYPE dataflash_is_busy(spi_flash_descriptor_t* descriptor_pt)
 void dataflash_wait_for_not_busy(spi_flash_descriptor_t* descriptor_pt)
 {
     while(dataflash_is_busy(descriptor_pt) == TRUE);
+    dataflash_write_ongoing = FALSE;
 }
 
 /*! \fn     dataflash_erase_64kb_block(spi_flash_descriptor_t* descriptor_pt, uint32_t address)
@@ -260,9 +324,13 @@ void dataflash_wait_for_not_busy(spi_flash_descriptor_t* descriptor_pt)
 */
 void dataflash_erase_64kb_block(spi_flash_descriptor_t* descriptor_pt, uint32_t address)
 {
+    /* Let a possibly ongoing write finish */
+    dataflash_wait_for_ongoing_write(descriptor_pt);
+    
     uint8_t erase_64kb_cmd[] = {0xD8, (uint8_t)((address >> 16) & 0xFF), (uint8_t)((address >> 8) & 0xFF), (uint8_t)((address >> 0) & 0xFF)};
     dataflash_send_write_enable(descriptor_pt);
     dataflash_send_command(descriptor_pt, erase_64kb_cmd, sizeof(erase_64kb_cmd));
+    dataflash_write_ongoing = TRUE;
 } 
 
 /*! \fn     dataflash_bulk_erase_with_wait(spi_flash_descriptor_t* descriptor_pt)
@@ -271,6 +339,9 @@ void dataflash_erase_64kb_block(spi_flash_descriptor_t* descriptor_pt, uint32_t
 */
 void dataflash_bulk_erase_with_wait(spi_flash_descriptor_t* descriptor_pt)
 {
+    /* Let a possibly ongoing write finish */
+    dataflash_wait_for_ongoing_write(descriptor_pt);
+    
     dataflash_send_write_enable(descriptor_pt);
     dataflash_send_single_byte_command(descriptor_pt, 0xC7);
     dataflash_wait_for_not_busy(descriptor_pt);
@@ -282,8 +353,12 @@ void dataflash_bulk_erase_with_wait(spi_flash_descriptor_t* descriptor_pt)
 */
 void dataflash_bulk_erase_without_wait(spi_flash_descriptor_t* descriptor_pt)
 {
+    /* Let a possibly ongoing write finish */
+    dataflash_wait_for_ongoing_write(descriptor_pt);
+    
     dataflash_send_write_enable(descriptor_pt);
     dataflash_send_single_byte_command(descriptor_pt, 0xC7);
+    dataflash_write_ongoing = TRUE;
 }
 
 /*! \fn     dataflash_check_presence(spi_flash_descriptor_t* descriptor_pt)
@@ -329,6 +404,9 @@ void dataflash_exit_power_down(spi_flash_descriptor_t* descriptor_pt)
 */
 void dataflash_power_down(spi_flash_descriptor_t* descriptor_pt)
 {
+    /* Let a possibly ongoing write finish */
+    dataflash_wait_for_ongoing_write(descriptor_pt);
+    
     uint8_t enter_power_down[] = {0xB9};
     dataflash_send_command(descriptor_pt, enter_power_down, sizeof(enter_power_down));    
 }
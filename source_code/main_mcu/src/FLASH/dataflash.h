@@ -27,8 +27,11 @@
 /* Defines */
 #define W25Q16_PAGE_SIZE    256
 #define W25Q16_FLASH_SIZE   2097152UL
+#define W25Q16_BLOCK_SIZE   65536UL
+#define W25Q16_NB_BLOCKS    (W25Q16_FLASH_SIZE/W25Q16_BLOCK_SIZE)
 
 /* Prototypes */
+void dataflash_write_page_without_wait(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint32_t length);
 void dataflash_write_array_to_memory(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint32_t length);
 void dataflash_read_data_array(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint32_t length);
 void dataflash_read_bytes_from_opened_transfer(spi_flash_descriptor_t* descriptor_pt, uint8_t* data, uint32_t length);
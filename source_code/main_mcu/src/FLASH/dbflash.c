@@ -19,12 +19,13 @@
 *    Created:  10/11/2017
 *    Author:   Mathieu Stephan
 */
+#include <string.h>
 #include "platform_defines.h"
 #include "driver_sercom.h"
+#include "dbflash_cache.h"
 #include "dbflash.h"
 #include "main.h"
 
-
 /*! \fn     dbflash_memory_boundary_error_callblack(void)
 *   \brief  Function called when a memory boundary issue occurs
 */
@@ -89,6 +90,9 @@ void dbflash_enter_ultra_deep_power_down(spi_flash_descriptor_t* descriptor_pt)
 {
     uint8_t enter_ultra_deep_power_down[] = {DBFLASH_OPCODE_UDEEP_PDOWN_ENTER};
     
+    /* Write back cached changes before going to sleep */
+    dbflash_flush_cache(descriptor_pt);
+    
     /* Query JEDEC ID */
     dbflash_send_command(descriptor_pt, enter_ultra_deep_power_down, sizeof(enter_ultra_deep_power_down));    
 }
@@ -222,6 +226,81 @@ void dbflash_wait_for_not_busy(spi_flash_descriptor_t* descriptor_pt)
     PORT->Group[descriptor_pt->cs_pin_group].OUTSET.reg = descriptor_pt->cs_pin_mask;
 }
 
+/*! \fn     dbflash_program_page_through_buffer(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data)
+*   \brief  Program data (or a pattern if data is 0) to a page through the flash internal buffer
+*   \param  descriptor_pt   Pointer to dbflash descriptor
+*   \param  pageNumber      The target page number of flash memory
+*   \param  offset          The starting byte offset to begin writing in pageNumber
+*   \param  dataSize        The number of bytes to write
+*   \param  data            The buffer containing the data to write, or 0 to write pattern
+*   \param  pattern         Pattern to write if data is 0
+*/
+static void dbflash_program_page_through_buffer(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data, uint8_t pattern)
+{
+    // If needed, load the page in the internal buffer
+    if ((offset != 0) || (dataSize != BYTES_PER_PAGE))
+    {
+        dbflash_load_page_to_internal_buffer(descriptor_pt, pageNumber);
+    }
+    
+    // Write the bytes in the buffer, write the buffer to page
+    uint8_t opcode[4] = {DBFLASH_OPCODE_MMP_PROG_TBUF};
+    dbflash_fill_page_read_write_erase_opcode_from_address(pageNumber, offset, &opcode[1]);
+    if (data == 0)
+    {
+        dbflash_send_pattern_data_with_four_bytes_opcode(descriptor_pt, opcode, pattern, dataSize);
+    } 
+    else
+    {
+        dbflash_send_data_with_four_bytes_opcode_no_readback(descriptor_pt, opcode, data, dataSize);
+    }
+    
+    /* Wait until memory is ready */
+    dbflash_wait_for_not_busy(descriptor_pt);
+}
+
+#ifdef DBFLASH_PAGE_CACHE
+/*! \fn     dbflash_write_page_bypassing_cache(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint8_t* data)
+*   \brief  Program a full page, used by the page cache
+*   \param  descriptor_pt   Pointer to dbflash descriptor
+*   \param  pageNumber      The target page number of flash memory
+*   \param  data            BYTES_PER_PAGE bytes to write
+*/
+void dbflash_write_page_bypassing_cache(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint8_t* data)
+{
+    /* Full page write: no need to load the page in the internal buffer */
+    dbflash_program_page_through_buffer(descriptor_pt, pageNumber, 0, BYTES_PER_PAGE, data, 0);
+}
+
+/*! \fn     dbflash_read_data_bypassing_cache(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data)
+*   \brief  Read data from flash memory, used by the page cache
+*   \param  descriptor_pt   Pointer to dbflash descriptor
+*   \param  pageNumber      The target page number of flash memory
+*   \param  offset          The starting byte offset to begin reading in pageNumber
+*   \param  dataSize        The number of bytes to read
+*   \param  data            The buffer used to store the data read from flash
+*/
+void dbflash_read_data_bypassing_cache(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data)
+{
+    uint8_t opcode[4] = {DBFLASH_OPCODE_LOWF_READ};
+    dbflash_fill_page_read_write_erase_opcode_from_address(pageNumber, offset, &opcode[1]);
+    dbflash_send_data_with_four_bytes_opcode(descriptor_pt, opcode, data, dataSize);
+}
+#endif
+
+/*! \fn     dbflash_flush_cache(spi_flash_descriptor_t* descriptor_pt)
+*   \brief  Write all modified cached pages back to flash
+*   \param  descriptor_pt   Pointer to dbflash descriptor
+*/
+void dbflash_flush_cache(spi_flash_descriptor_t* descriptor_pt)
+{
+    #ifdef DBFLASH_PAGE_CACHE
+    dbflash_cache_flush(descriptor_pt);
+    #else
+    (void)descriptor_pt;
+    #endif
+}
+
 /*! \fn     dbflash_sector_zero_erase(spi_flash_descriptor_t* descriptor_pt, uint8_t sectorNumber)
 *   \brief  Erases sector 0a if sectorNumber is DBFLASH_SECTOR_ZERO_A_CODE. Deletes sector 0b if sectorNumber is DBFLASH_SECTOR_ZERO_B_CODE.
 *   \param  descriptor_pt   Pointer to dbflash descriptor
@@ -238,6 +317,17 @@ void dbflash_sector_zero_erase(spi_flash_descriptor_t* descriptor_pt, uint8_t se
         }    
     #endif
     
+    #ifdef DBFLASH_PAGE_CACHE
+    if (sectorNumber == DBFLASH_SECTOR_ZERO_A_CODE)
+    {
+        dbflash_cache_erase_pages(descriptor_pt, 0, DBFLASH_SECTOR_ZER0_A_PAGES);
+    }
+    else
+    {
+        dbflash_cache_erase_pages(descriptor_pt, DBFLASH_SECTOR_ZER0_A_PAGES, PAGE_PER_SECTOR - DBFLASH_SECTOR_ZER0_A_PAGES);
+    }
+    #endif
+    
     uint16_t temp_uint = (uint16_t)sectorNumber << (SECTOR_ERASE_0_SHT_AMT-8);
     uint8_t opcode[4] = {DBFLASH_OPCODE_SECTOR_ERASE, (uint8_t)(temp_uint >> 8), (uint8_t)temp_uint, 0};
     dbflash_send_command(descriptor_pt, opcode, sizeof(opcode));
@@ -262,6 +352,10 @@ void dbflash_sector_erase(spi_flash_descriptor_t* descriptor_pt, uint8_t sectorN
         }
     #endif
     
+    #ifdef DBFLASH_PAGE_CACHE
+    dbflash_cache_erase_pages(descriptor_pt, (uint16_t)sectorNumber * PAGE_PER_SECTOR, PAGE_PER_SECTOR);
+    #endif
+    
     uint16_t temp_uint = (uint16_t)sectorNumber << (SECTOR_ERASE_N_SHT_AMT-8);
     uint8_t opcode[4] = {DBFLASH_OPCODE_SECTOR_ERASE, (uint8_t)(temp_uint >> 8), (uint8_t)temp_uint, 0};
     dbflash_send_command(descriptor_pt, opcode, sizeof(opcode));
@@ -276,6 +370,10 @@ void dbflash_sector_erase(spi_flash_descriptor_t* descriptor_pt, uint8_t sectorN
 */
 void dbflash_chip_erase(spi_flash_descriptor_t* descriptor_pt)
 {
+    #ifdef DBFLASH_PAGE_CACHE
+    dbflash_cache_erase_pages(descriptor_pt, 0, PAGE_COUNT);
+    #endif
+    
     uint8_t opcode[4] = {0xC7, 0x94, 0x80, 0x9A};
     dbflash_send_command(descriptor_pt, opcode, sizeof(opcode));
     
@@ -299,6 +397,10 @@ void dbflash_block_erase(spi_flash_descriptor_t* descriptor_pt, uint16_t blockNu
         }
     #endif
     
+    #ifdef DBFLASH_PAGE_CACHE
+    dbflash_cache_erase_pages(descriptor_pt, blockNumber << (BLOCK_ERASE_SHT_AMT-PAGE_ERASE_SHT_AMT), 1 << (BLOCK_ERASE_SHT_AMT-PAGE_ERASE_SHT_AMT));
+    #endif
+    
     uint16_t temp_uint = blockNumber << (BLOCK_ERASE_SHT_AMT-8);
     uint8_t opcode[4] = {DBFLASH_OPCODE_BLOCK_ERASE, (uint8_t)(temp_uint >> 8), (uint8_t)temp_uint, 0};
     dbflash_send_command(descriptor_pt, opcode, sizeof(opcode));
@@ -323,6 +425,10 @@ void dbflash_page_erase(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumb
         }
     #endif
     
+    #ifdef DBFLASH_PAGE_CACHE
+    dbflash_cache_erase_pages(descriptor_pt, pageNumber, 1);
+    #endif
+    
     uint8_t opcode[4] = {DBFLASH_OPCODE_PAGE_ERASE};
     dbflash_fill_page_read_write_erase_opcode_from_address(pageNumber, 0, &opcode[1]);    // We can add the offset as they're "don't care" in the datasheet
     dbflash_send_command(descriptor_pt, opcode, sizeof(opcode));
@@ -362,6 +468,11 @@ void dbflash_load_page_to_internal_buffer(spi_flash_descriptor_t* descriptor_pt,
         }
     #endif
     
+    #ifdef DBFLASH_PAGE_CACHE
+    // Make sure the flash contents are up to date: the page will be programmed after all cached writes
+    dbflash_flush_cache(descriptor_pt);
+    #endif
+    
     // Load the page in the internal buffer
     uint8_t opcode[4] = {DBFLASH_OPCODE_MAINP_TO_BUF};
     dbflash_fill_page_read_write_erase_opcode_from_address(pageNumber, 0, &opcode[1]);
@@ -378,7 +489,7 @@ void dbflash_load_page_to_internal_buffer(spi_flash_descriptor_t* descriptor_pt,
 *   \param  offset          The starting byte offset to begin writing in pageNumber
 *   \param  dataSize        The number of bytes to write from the data buffer (assuming the data buffer is sufficiently large)
 *   \param  pattern         Pattern to write in memory
-*   \note   Function does not allow crossing page boundaries.
+*   \note   Function does not allow crossing page boundaries. When the page cache is enabled, data only reaches flash on eviction or flush, in write order
 */
 void dbflash_write_data_pattern_to_flash(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, uint8_t pattern)
 {    
@@ -396,19 +507,11 @@ void dbflash_write_data_pattern_to_flash(spi_flash_descriptor_t* descriptor_pt,
         }
     #endif
     
-    // If needed, load the page in the internal buffer
-    if ((offset != 0) || (dataSize != BYTES_PER_PAGE))
-    {
-        dbflash_load_page_to_internal_buffer(descriptor_pt, pageNumber);
-    }
-    
-    // Write the bytes in the buffer, write the buffer to page
-    uint8_t opcode[4] = {DBFLASH_OPCODE_MMP_PROG_TBUF};
-    dbflash_fill_page_read_write_erase_opcode_from_address(pageNumber, offset, &opcode[1]); 
-    dbflash_send_pattern_data_with_four_bytes_opcode(descriptor_pt, opcode, pattern, dataSize);
-    
-    /* Wait until memory is ready */
-    dbflash_wait_for_not_busy(descriptor_pt);
+    #ifdef DBFLASH_PAGE_CACHE
+        dbflash_cache_write_data(descriptor_pt, pageNumber, offset, dataSize, 0, pattern);
+    #else
+        dbflash_program_page_through_buffer(descriptor_pt, pageNumber, offset, dataSize, 0, pattern);
+    #endif
 }
 
 /*! \fn     dbflash_write_data_to_flash(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data)
@@ -418,7 +521,7 @@ void dbflash_write_data_pattern_to_flash(spi_flash_descriptor_t* descriptor_pt,
 *   \param  offset          The starting byte offset to begin writing in pageNumber
 *   \param  dataSize        The number of bytes to write from the data buffer (assuming the data buffer is sufficiently large)
 *   \param  data            The buffer containing the data to write to flash memory
-*   \note   Function does not allow crossing page boundaries.
+*   \note   Function does not allow crossing page boundaries. When the page cache is enabled, data only reaches flash on eviction or flush, in write order
 */
 void dbflash_write_data_to_flash(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data)
 {    
@@ -436,19 +539,11 @@ void dbflash_write_data_to_flash(spi_flash_descriptor_t* descriptor_pt, uint16_t
         }
     #endif
     
-    // If needed, load the page in the internal buffer
-    if ((offset != 0) || (dataSize != BYTES_PER_PAGE))
-    {
-        dbflash_load_page_to_internal_buffer(descriptor_pt, pageNumber);
-    }
-    
-    // Write the bytes in the buffer, write the buffer to page
-    uint8_t opcode[4] = {DBFLASH_OPCODE_MMP_PROG_TBUF};
-    dbflash_fill_page_read_write_erase_opcode_from_address(pageNumber, offset, &opcode[1]); 
-    dbflash_send_data_with_four_bytes_opcode_no_readback(descriptor_pt, opcode, data, dataSize);
-    
-    /* Wait until memory is ready */
-    dbflash_wait_for_not_busy(descriptor_pt);
+    #ifdef DBFLASH_PAGE_CACHE
+        dbflash_cache_write_data(descriptor_pt, pageNumber, offset, dataSize, data, 0);
+    #else
+        dbflash_program_page_through_buffer(descriptor_pt, pageNumber, offset, dataSize, data, 0);
+    #endif
 }
 
 /*! \fn     dbflash_read_data_from_flash(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data)
@@ -485,9 +580,13 @@ void dbflash_read_data_from_flash(spi_flash_descriptor_t* descriptor_pt, uint16_
         }
     #endif
     
-    uint8_t opcode[4] = {DBFLASH_OPCODE_LOWF_READ};
-    dbflash_fill_page_read_write_erase_opcode_from_address(pageNumber, offset, &opcode[1]);
-    dbflash_send_data_with_four_bytes_opcode(descriptor_pt, opcode, data, dataSize);
+    #ifdef DBFLASH_PAGE_CACHE
+        dbflash_cache_read_data(descriptor_pt, pageNumber, offset, dataSize, data);
+    #else
+        uint8_t opcode[4] = {DBFLASH_OPCODE_LOWF_READ};
+        dbflash_fill_page_read_write_erase_opcode_from_address(pageNumber, offset, &opcode[1]);
+        dbflash_send_data_with_four_bytes_opcode(descriptor_pt, opcode, data, dataSize);
+    #endif
 } 
 
 /*! \fn     dbflash_raw_read(spi_flash_descriptor_t* descriptor_pt, uint8_t* datap, uint16_t addr, uint16_t size)
@@ -500,6 +599,9 @@ void dbflash_read_data_from_flash(spi_flash_descriptor_t* descriptor_pt, uint16_
 */
 void dbflash_raw_read(spi_flash_descriptor_t* descriptor_pt, uint8_t* datap, uint16_t addr, uint16_t size)
 {    
+    /* Bypasses the cache: make sure flash is up to date */
+    dbflash_flush_cache(descriptor_pt);
+    
     uint16_t page_number = (addr/BYTES_PER_PAGE);
     uint8_t high_byte = page_number >> (16 - READ_OFFSET_SHT_AMT);
     addr = (page_number << READ_OFFSET_SHT_AMT) | (addr % BYTES_PER_PAGE);
@@ -516,6 +618,7 @@ void dbflash_raw_read(spi_flash_descriptor_t* descriptor_pt, uint8_t* datap, uin
 *   \param  offset offset to start writing to in the internal memory buffer
 *   \param  size the number of bytes to write
 *   \note    if the end of the internal buffer is reached then writing will wrap to the start of the internal buffer.
+*   \note    cache write backs also use the internal buffer: flush the cache before filling the buffer, and do not read or write through the cache until it is written to page
 */
 void dbflash_write_buffer(spi_flash_descriptor_t* descriptor_pt, uint8_t* datap, uint16_t offset, uint16_t size)
 {
@@ -529,9 +632,14 @@ void dbflash_write_buffer(spi_flash_descriptor_t* descriptor_pt, uint8_t* datap,
 *   \brief  write the contents of the internal memory buffer to a page in flash
 *   \param  descriptor_pt   Pointer to dbflash descriptor
 *   \param  page    the page to store the buffer in
+*   \note   the cache must have been flushed before the buffer was filled: nothing is written back here
 */
 void dbflash_flash_write_buffer_to_page(spi_flash_descriptor_t* descriptor_pt, uint16_t page)
 {
+    #ifdef DBFLASH_PAGE_CACHE
+    dbflash_cache_invalidate_pages(page, 1);
+    #endif
+    
     uint8_t op[4] = {DBFLASH_OPCODE_BUF_TO_PAGE};
     dbflash_fill_page_read_write_erase_opcode_from_address(page, 0, &op[1]);
     dbflash_send_data_with_four_bytes_opcode(descriptor_pt, op, op, 0);
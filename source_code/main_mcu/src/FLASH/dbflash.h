@@ -28,7 +28,19 @@
 // Enable boundary checks
 #define DBFLASH_MEMORY_BOUNDARY_CHECKS
 
+/* Typedefs */
+typedef struct
+{
+    uint32_t read_hits;
+    uint32_t read_misses;
+    uint32_t write_hits;
+    uint32_t write_misses;
+    uint32_t page_writes;
+} dbflash_cache_stats_t;
+
 /* Prototypes */
+void dbflash_get_cache_stats(dbflash_cache_stats_t* stats_pt);
+void dbflash_flush_cache(spi_flash_descriptor_t* descriptor_pt);
 void dbflash_write_data_pattern_to_flash(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, uint8_t pattern);
 void dbflash_send_data_with_four_bytes_opcode_no_readback(spi_flash_descriptor_t* descriptor_pt, uint8_t* opcode, uint8_t* buffer, uint16_t buffer_size);
 void dbflash_send_pattern_data_with_four_bytes_opcode(spi_flash_descriptor_t* descriptor_pt, uint8_t* opcode, uint8_t pattern, uint16_t nb_bytes);
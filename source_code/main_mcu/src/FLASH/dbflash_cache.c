@@ -0,0 +1,315 @@
+/*
+ * This file is part of the Mooltipass Project (https://github.com/mooltipass).
+ * Copyright (c) 2019 Stephan Mathieu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/*!  \file     dbflash_cache.c
+*    \brief    Write-back RAM page cache in front of the database flash
+*    Created:  17/10/2026
+*    Author:   Mathieu Stephan
+*
+*    The database code relies on the order of its writes: a node is written before the link pointing to it.
+*    Modified pages are therefore written back in the order they were first modified, and a page which is
+*    modified again after another page was modified first gets written back (with all pages modified
+*    before it) so that its new contents can't reach the flash before the other page.
+*    At any time, the flash contents are the result of a prefix of the write sequence.
+*/
+#include <string.h>
+#include "platform_defines.h"
+#include "dbflash_cache.h"
+#ifdef DBFLASH_PAGE_CACHE
+/* Cached pages */
+dbflash_cache_page_t dbflash_cache_pages[DBFLASH_CACHE_NB_PAGES];
+/* Pages recently read without being cached */
+uint16_t dbflash_cache_recent_misses[DBFLASH_CACHE_NB_RECENT_MISSES];
+uint16_t dbflash_cache_recent_misses_index = 0;
+/* Access counter, used for LRU eviction */
+uint32_t dbflash_cache_access_counter = 0;
+/* Write sequence counter, used for write back ordering */
+uint32_t dbflash_cache_write_seq = 0;
+/* Cache statistics */
+dbflash_cache_stats_t dbflash_cache_stats;
+
+
+/*! \fn     dbflash_cache_write_back_pages(spi_flash_descriptor_t* descriptor_pt, uint32_t max_dirty_seq)
+*   \brief  Write back, in write sequence order, the modified pages first modified before a given sequence number
+*   \param  descriptor_pt   Pointer to dbflash descriptor
+*   \param  max_dirty_seq   Last write sequence number to write back
+*/
+static void dbflash_cache_write_back_pages(spi_flash_descriptor_t* descriptor_pt, uint32_t max_dirty_seq)
+{
+    while (TRUE)
+    {
+        dbflash_cache_page_t* oldest_dirty_page_pt = 0;
+
+        /* Find the oldest modified page */
+        for (uint16_t i = 0; i < DBFLASH_CACHE_NB_PAGES; i++)
+        {
+            if ((dbflash_cache_pages[i].valid != FALSE) && (dbflash_cache_pages[i].dirty_seq != 0) && (dbflash_cache_pages[i].dirty_seq <= max_dirty_seq))
+            {
+                if ((oldest_dirty_page_pt == 0) || (dbflash_cache_pages[i].dirty_seq < oldest_dirty_page_pt->dirty_seq))
+                {
+                    oldest_dirty_page_pt = &dbflash_cache_pages[i];
+                }
+            }
+        }
+
+        if (oldest_dirty_page_pt == 0)
+        {
+            return;
+        }
+
+        dbflash_write_page_bypassing_cache(descriptor_pt, oldest_dirty_page_pt->page_number, oldest_dirty_page_pt->data);
+        dbflash_cache_stats.page_writes++;
+        oldest_dirty_page_pt->dirty_seq = 0;
+    }
+}
+
+/*! \fn     dbflash_cache_find_page(uint16_t pageNumber)
+*   \brief  Find a page in our cache
+*   \param  pageNumber      The page number
+*   \return Pointer to the cached page, 0 if not cached
+*/
+static dbflash_cache_page_t* dbflash_cache_find_page(uint16_t pageNumber)
+{
+    for (uint16_t i = 0; i < DBFLASH_CACHE_NB_PAGES; i++)
+    {
+        if ((dbflash_cache_pages[i].valid != FALSE) && (dbflash_cache_pages[i].page_number == pageNumber))
+        {
+            dbflash_cache_pages[i].last_access = ++dbflash_cache_access_counter;
+            return &dbflash_cache_pages[i];
+        }
+    }
+    return 0;
+}
+
+/*! \fn     dbflash_cache_allocate_page(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, BOOL load_contents)
+*   \brief  Allocate a cache slot for a given page, evicting the least recently used one if needed
+*   \param  descriptor_pt   Pointer to dbflash descriptor
+*   \param  pageNumber      The page number
+*   \param  load_contents   Set to TRUE to read the page contents from flash
+*   \return Pointer to the cached page
+*/
+static dbflash_cache_page_t* dbflash_cache_allocate_page(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, BOOL load_contents)
+{
+    dbflash_cache_page_t* cache_page_pt = &dbflash_cache_pages[0];
+
+    /* Look for a free slot, otherwise the least recently used one */
+    for (uint16_t i = 0; i < DBFLASH_CACHE_NB_PAGES; i++)
+    {
+        if (dbflash_cache_pages[i].valid == FALSE)
+        {
+            cache_page_pt = &dbflash_cache_pages[i];
+            break;
+        }
+        else if (dbflash_cache_pages[i].last_access < cache_page_pt->last_access)
+        {
+            cache_page_pt = &dbflash_cache_pages[i];
+        }
+    }
+
+    /* Evict previous contents, pages modified before it are written back first */
+    if ((cache_page_pt->valid != FALSE) && (cache_page_pt->dirty_seq != 0))
+    {
+        dbflash_cache_write_back_pages(descriptor_pt, cache_page_pt->dirty_seq);
+    }
+    cache_page_pt->valid = TRUE;
+    cache_page_pt->dirty_seq = 0;
+    cache_page_pt->page_number = pageNumber;
+    cache_page_pt->last_access = ++dbflash_cache_access_counter;
+
+    /* Fetch contents */
+    if (load_contents != FALSE)
+    {
+        dbflash_read_data_bypassing_cache(descriptor_pt, pageNumber, 0, BYTES_PER_PAGE, cache_page_pt->data);
+    }
+
+    return cache_page_pt;
+}
+
+/*! \fn     dbflash_cache_is_page_recently_missed(uint16_t pageNumber)
+*   \brief  Check if a page was recently read without being cached, remember it otherwise
+*   \param  pageNumber      The page number
+*   \return TRUE if the page was recently missed
+*   \note   Prevents single pass scans from evicting the whole cache
+*/
+static BOOL dbflash_cache_is_page_recently_missed(uint16_t pageNumber)
+{
+    for (uint16_t i = 0; i < DBFLASH_CACHE_NB_RECENT_MISSES; i++)
+    {
+        if (dbflash_cache_recent_misses[i] == pageNumber)
+        {
+            return TRUE;
+        }
+    }
+
+    dbflash_cache_recent_misses[dbflash_cache_recent_misses_index++] = pageNumber;
+    if (dbflash_cache_recent_misses_index == DBFLASH_CACHE_NB_RECENT_MISSES)
+    {
+        dbflash_cache_recent_misses_index = 0;
+    }
+    return FALSE;
+}
+
+/*! \fn     dbflash_cache_write_data(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data, uint8_t pattern)
+*   \brief  Write data (or a pattern if data is 0) to a cached page, fetching it if needed
+*   \param  descriptor_pt   Pointer to dbflash descriptor
+*   \param  pageNumber      The target page number of flash memory
+*   \param  offset          The starting byte offset to begin writing in pageNumber
+*   \param  dataSize        The number of bytes to write
+*   \param  data            The buffer containing the data to write, or 0 to write pattern
+*   \param  pattern         Pattern to write if data is 0
+*   \note   Function does not allow crossing page boundaries
+*/
+void dbflash_cache_write_data(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data, uint8_t pattern)
+{
+    dbflash_cache_page_t* cache_page_pt = dbflash_cache_find_page(pageNumber);
+    if (cache_page_pt == 0)
+    {
+        cache_page_pt = dbflash_cache_allocate_page(descriptor_pt, pageNumber, (offset != 0) || (dataSize != BYTES_PER_PAGE));
+        dbflash_cache_stats.write_misses++;
+    }
+    else
+    {
+        dbflash_cache_stats.write_hits++;
+
+        /* Another page was modified since this one was: write this one back (and the ones modified before it) to keep the write order */
+        if ((cache_page_pt->dirty_seq != 0) && (cache_page_pt->dirty_seq != dbflash_cache_write_seq))
+        {
+            dbflash_cache_write_back_pages(descriptor_pt, cache_page_pt->dirty_seq);
+        }
+    }
+
+    if (data == 0)
+    {
+        memset(&cache_page_pt->data[offset], pattern, dataSize);
+    }
+    else
+    {
+        memcpy(&cache_page_pt->data[offset], data, dataSize);
+    }
+
+    /* Start of a new run of writes to this page */
+    if (cache_page_pt->dirty_seq == 0)
+    {
+        cache_page_pt->dirty_seq = ++dbflash_cache_write_seq;
+    }
+}
+
+/*! \fn     dbflash_cache_read_data(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data)
+*   \brief  Read data through the cache, pages being served separately
+*   \param  descriptor_pt   Pointer to dbflash descriptor
+*   \param  pageNumber      The target page number of flash memory
+*   \param  offset          The starting byte offset to begin reading in pageNumber
+*   \param  dataSize        The number of bytes to read
+*   \param  data            The buffer used to store the data read
+*   \note   Only pages that are fully read or that are read twice in a short time frame get cached
+*/
+void dbflash_cache_read_data(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data)
+{
+    uint8_t* data_pt = (uint8_t*)data;
+
+    while (dataSize != 0)
+    {
+        while (offset >= BYTES_PER_PAGE)
+        {
+            offset -= BYTES_PER_PAGE;
+            pageNumber++;
+        }
+        uint16_t chunk_size = BYTES_PER_PAGE - offset;
+        if (chunk_size > dataSize)
+        {
+            chunk_size = dataSize;
+        }
+
+        dbflash_cache_page_t* cache_page_pt = dbflash_cache_find_page(pageNumber);
+        if (cache_page_pt != 0)
+        {
+            dbflash_cache_stats.read_hits++;
+        }
+        else
+        {
+            dbflash_cache_stats.read_misses++;
+            if ((chunk_size == BYTES_PER_PAGE) || (dbflash_cache_is_page_recently_missed(pageNumber) != FALSE))
+            {
+                cache_page_pt = dbflash_cache_allocate_page(descriptor_pt, pageNumber, TRUE);
+            }
+        }
+
+        if (cache_page_pt != 0)
+        {
+            memcpy(data_pt, &cache_page_pt->data[offset], chunk_size);
+        }
+        else
+        {
+            dbflash_read_data_bypassing_cache(descriptor_pt, pageNumber, offset, chunk_size, data_pt);
+        }
+
+        data_pt += chunk_size;
+        dataSize -= chunk_size;
+        offset += chunk_size;
+    }
+}
+
+/*! \fn     dbflash_cache_invalidate_pages(uint16_t firstPage, uint16_t nbPages)
+*   \brief  Drop the cached pages in the given range, without writing anything back
+*   \param  firstPage       First page number
+*   \param  nbPages         Number of pages
+*   \note   To be called before a page program from the flash internal buffer, once the cache was flushed
+*/
+void dbflash_cache_invalidate_pages(uint16_t firstPage, uint16_t nbPages)
+{
+    for (uint16_t i = 0; i < DBFLASH_CACHE_NB_PAGES; i++)
+    {
+        if ((dbflash_cache_pages[i].page_number >= firstPage) && (dbflash_cache_pages[i].page_number - firstPage < nbPages))
+        {
+            dbflash_cache_pages[i].valid = FALSE;
+            dbflash_cache_pages[i].dirty_seq = 0;
+        }
+    }
+}
+
+/*! \fn     dbflash_cache_erase_pages(spi_flash_descriptor_t* descriptor_pt, uint16_t firstPage, uint16_t nbPages)
+*   \brief  To be called before a flash erase: drop the cached pages in the given range, write back the other modified pages
+*   \param  descriptor_pt   Pointer to dbflash descriptor
+*   \param  firstPage       First page number
+*   \param  nbPages         Number of pages
+*   \note   Write backs go through the flash internal buffer
+*/
+void dbflash_cache_erase_pages(spi_flash_descriptor_t* descriptor_pt, uint16_t firstPage, uint16_t nbPages)
+{
+    dbflash_cache_invalidate_pages(firstPage, nbPages);
+
+    /* The erase comes after the writes still in the cache */
+    dbflash_cache_write_back_pages(descriptor_pt, UINT32_MAX);
+}
+
+/*! \fn     dbflash_cache_flush(spi_flash_descriptor_t* descriptor_pt)
+*   \brief  Write all modified cached pages back to flash, in write sequence order
+*   \param  descriptor_pt   Pointer to dbflash descriptor
+*/
+void dbflash_cache_flush(spi_flash_descriptor_t* descriptor_pt)
+{
+    dbflash_cache_write_back_pages(descriptor_pt, UINT32_MAX);
+}
+
+/*! \fn     dbflash_get_cache_stats(dbflash_cache_stats_t* stats_pt)
+*   \brief  Get a copy of the page cache statistics
+*   \param  stats_pt        Where to store the statistics
+*/
+void dbflash_get_cache_stats(dbflash_cache_stats_t* stats_pt)
+{
+    memcpy(stats_pt, &dbflash_cache_stats, sizeof(dbflash_cache_stats_t));
+}
+#endif
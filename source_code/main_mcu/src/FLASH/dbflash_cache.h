@@ -0,0 +1,55 @@
+/*
+ * This file is part of the Mooltipass Project (https://github.com/mooltipass).
+ * Copyright (c) 2019 Stephan Mathieu
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/*!  \file     dbflash_cache.h
+*    \brief    Write-back RAM page cache in front of the database flash
+*    Created:  17/10/2026
+*    Author:   Mathieu Stephan
+*/
+
+#ifndef DBFLASH_CACHE_H_
+#define DBFLASH_CACHE_H_
+
+#include "platform_defines.h"
+#include "dbflash.h"
+
+/* Number of cached pages & number of remembered read misses */
+/* RAM use: DBFLASH_CACHE_NB_PAGES * (BYTES_PER_PAGE + 12) + 2 * DBFLASH_CACHE_NB_RECENT_MISSES + 32 bytes, 1152B for 4 264B pages */
+#define DBFLASH_CACHE_NB_PAGES              4
+#define DBFLASH_CACHE_NB_RECENT_MISSES      8
+
+/* Cached page typedef */
+typedef struct
+{
+    uint8_t valid;
+    uint16_t page_number;
+    uint32_t last_access;
+    uint32_t dirty_seq;     // Write sequence number of the first write since the last write back, 0 when clean
+    uint8_t data[BYTES_PER_PAGE];
+} dbflash_cache_page_t;
+
+/* Prototypes */
+void dbflash_cache_write_data(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data, uint8_t pattern);
+void dbflash_cache_read_data(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data);
+void dbflash_cache_erase_pages(spi_flash_descriptor_t* descriptor_pt, uint16_t firstPage, uint16_t nbPages);
+void dbflash_cache_invalidate_pages(uint16_t firstPage, uint16_t nbPages);
+void dbflash_cache_flush(spi_flash_descriptor_t* descriptor_pt);
+
+/* Flash accesses used by the cache, provided by the flash driver */
+void dbflash_read_data_bypassing_cache(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data);
+void dbflash_write_page_bypassing_cache(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint8_t* data);
+
+#endif /* DBFLASH_CACHE_H_ */
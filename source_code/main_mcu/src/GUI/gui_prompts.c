@@ -74,6 +74,9 @@ const uint16_t gui_prompts_notif_popup_anim_length[3] = {INFO_NOTIF_ANIM_LGTH, W
 const uint16_t gui_prompts_notif_popup_anim_bitmap[3] = {BITMAP_INFO_NOTIF_POPUP_ID, BITMAP_WARNING_NOTIF_POPUP_ID, BITMAP_ACTION_NOTIF_POPUP_ID};
 const uint16_t gui_prompts_notif_idle_anim_length[3] = {INFO_NOTIF_IDLE_ANIM_LGTH, WARNING_NOTIF_IDLE_ANIM_LGTH, ACTION_NOTIF_IDLE_ANIM_LGTH};
 const uint16_t gui_prompts_notif_idle_anim_bitmap[3] = {BITMAP_INFO_NOTIF_IDLE_ID, BITMAP_WARNING_NOTIF_IDLE_ID, BITMAP_ACTION_NOTIF_IDLE_ID};
+// Services or logins around the ones currently displayed in a list
+gui_prompts_list_window_entry_t gui_prompts_list_window[LOGIN_SCROLL_WINDOW_SIZE];
+uint32_t gui_prompts_list_window_use_counter;
 
 
 /*! \fn     gui_prompts_display_tutorial(void)
@@ -1903,6 +1906,113 @@ mini_input_yes_no_ret_te gui_prompts_ask_for_confirmation(uint16_t nb_args, conf
     return input_answer;
 }
 
+/*! \fn     gui_prompts_reset_list_window(void)
+*   \brief  Empty the window of decoded list items, to be called when a list screen starts
+*/
+static void gui_prompts_reset_list_window(void)
+{
+    memset(gui_prompts_list_window, 0, sizeof(gui_prompts_list_window));
+    gui_prompts_list_window_use_counter = 0;
+}
+
+/*! \fn     gui_prompts_get_list_window_entry(uint16_t address, BOOL login_list, parent_node_t* temp_node_pt)
+*   \brief  Get a decoded list item, only reading the node if it isn't in the window
+*   \param  address         Parent (service list) or child (login list) node address
+*   \param  login_list      TRUE for a login list
+*   \param  temp_node_pt    Buffer to read the node
+*   \return Pointer to the window entry
+*   \note   The least recently used entry is replaced: as the 3 displayed items and the one scrolling in or out are accessed at each frame, scrolling by one item only decodes one node
+*/
+static gui_prompts_list_window_entry_t* gui_prompts_get_list_window_entry(uint16_t address, BOOL login_list, parent_node_t* temp_node_pt)
+{
+    gui_prompts_list_window_entry_t* entry_pt = &gui_prompts_list_window[0];
+    gui_prompts_list_window_use_counter++;
+    
+    _Static_assert(MEMBER_ARRAY_SIZE(gui_prompts_list_window_entry_t, display_string) >= MEMBER_ARRAY_SIZE(parent_cred_node_t, service), "Display string can't store service");
+    _Static_assert(MEMBER_ARRAY_SIZE(gui_prompts_list_window_entry_t, display_string) >= MEMBER_ARRAY_SIZE(child_cred_node_t, login), "Display string can't store login");
+    
+    for (uint16_t i = 0; i < ARRAY_SIZE(gui_prompts_list_window); i++)
+    {
+        if (gui_prompts_list_window[i].address == address)
+        {
+            gui_prompts_list_window[i].last_use = gui_prompts_list_window_use_counter;
+            return &gui_prompts_list_window[i];
+        }
+        
+        /* Empty slots have a 0 last use */
+        if (gui_prompts_list_window[i].last_use < entry_pt->last_use)
+        {
+            entry_pt = &gui_prompts_list_window[i];
+        }
+    }
+    
+    /* Decode node in the least recently used slot */
+    if (login_list != FALSE)
+    {
+        child_cred_node_t* temp_half_cnode_pt = (child_cred_node_t*)temp_node_pt;
+        nodemgmt_read_cred_child_node_except_pwd(address, temp_half_cnode_pt);
+        utils_strncpy(entry_pt->display_string, temp_half_cnode_pt->login, MEMBER_ARRAY_SIZE(child_cred_node_t, login));
+    }
+    else
+    {
+        nodemgmt_read_parent_node(address, temp_node_pt, TRUE);
+        utils_strncpy(entry_pt->display_string, temp_node_pt->cred_parent.service, MEMBER_ARRAY_SIZE(parent_cred_node_t, service));
+    }
+    entry_pt->address = address;
+    entry_pt->prev_address_fetched = FALSE;
+    entry_pt->next_address_fetched = FALSE;
+    entry_pt->last_use = gui_prompts_list_window_use_counter;
+    return entry_pt;
+}
+
+/*! \fn     gui_prompts_get_list_window_neighbour(uint16_t address, BOOL login_list, BOOL next_item, parent_node_t* temp_node_pt)
+*   \brief  Get the previous or next list item for the current category, only looking for it once per window entry
+*   \param  address         Parent (service list) or child (login list) node address
+*   \param  login_list      TRUE for a login list
+*   \param  next_item       TRUE to get the next item, FALSE to get the previous one
+*   \param  temp_node_pt    Buffer to read the node
+*   \return Address of the item or NODE_ADDR_NULL
+*/
+static uint16_t gui_prompts_get_list_window_neighbour(uint16_t address, BOOL login_list, BOOL next_item, parent_node_t* temp_node_pt)
+{
+    gui_prompts_list_window_entry_t* entry_pt = gui_prompts_get_list_window_entry(address, login_list, temp_node_pt);
+    
+    /* Neighbours depend on the category */
+    if (entry_pt->category_flags != nodemgmt_get_current_category_flags())
+    {
+        entry_pt->category_flags = nodemgmt_get_current_category_flags();
+        entry_pt->prev_address_fetched = FALSE;
+        entry_pt->next_address_fetched = FALSE;
+    }
+    
+    if ((next_item != FALSE) && (entry_pt->next_address_fetched == FALSE))
+    {
+        if (login_list != FALSE)
+        {
+            entry_pt->next_address = nodemgmt_get_next_child_node_for_cur_category(address);
+        }
+        else
+        {
+            entry_pt->next_address = nodemgmt_get_next_parent_node_for_cur_category(address, NODEMGMT_STANDARD_CRED_TYPE_ID);
+        }
+        entry_pt->next_address_fetched = TRUE;
+    }
+    else if ((next_item == FALSE) && (entry_pt->prev_address_fetched == FALSE))
+    {
+        if (login_list != FALSE)
+        {
+            entry_pt->prev_address = nodemgmt_get_prev_child_node_for_cur_category(address);
+        }
+        else
+        {
+            entry_pt->prev_address = nodemgmt_get_prev_parent_node_for_cur_category(address, NODEMGMT_STANDARD_CRED_TYPE_ID);
+        }
+        entry_pt->prev_address_fetched = TRUE;
+    }
+    
+    return (next_item != FALSE)? entry_pt->next_address : entry_pt->prev_address;
+}
+
 /*! \fn     gui_prompts_ask_for_login_select(uint16_t parent_node_addr, uint16_t* chosen_child_node_addr, uint16_t* child_addresses_overwrite)
 *   \brief  Ask for user login selection / approval
 *   \param  parent_node_addr            Address of the parent node
@@ -1952,6 +2062,9 @@ mini_input_yes_no_ret_te gui_prompts_ask_for_login_select(uint16_t parent_node_a
         return NODE_ADDR_NULL;
     }
     
+    /* Logins are decoded once while scrolling */
+    gui_prompts_reset_list_window();
+    
     /* Clear frame buffer */
     #ifdef OLED_INTERNAL_FRAME_BUFFER
     oled_load_transition(&plat_oled_descriptor, OLED_IN_OUT_TRANS);
@@ -2164,12 +2277,12 @@ mini_input_yes_no_ret_te gui_prompts_ask_for_login_select(uint16_t parent_node_a
             oled_set_min_display_y(&plat_oled_descriptor, LOGIN_SCROLL_Y_BAR+1);
             if ((animation_step > 0) && (before_top_of_list_child_addr != NODE_ADDR_NULL))
             {
-                /* Fetch node */
-                nodemgmt_read_cred_child_node_except_pwd(before_top_of_list_child_addr, temp_half_cnode_pt);
+                /* Fetch login */
+                gui_prompts_list_window_entry_t* entry_pt = gui_prompts_get_list_window_entry(before_top_of_list_child_addr, TRUE, &temp_half_cnode);
                 
                 /* Display fading out login */
                 oled_refresh_used_font(&plat_oled_descriptor, FONT_UBUNTU_REGULAR_13_ID);
-                oled_put_centered_string(&plat_oled_descriptor, LOGIN_SCROLL_Y_FLINE-(((LOGIN_SCROLL_Y_TLINE-LOGIN_SCROLL_Y_SLINE)/2)*2)+animation_step, temp_half_cnode_pt->login, TRUE);
+                oled_put_centered_string(&plat_oled_descriptor, LOGIN_SCROLL_Y_FLINE-(((LOGIN_SCROLL_Y_TLINE-LOGIN_SCROLL_Y_SLINE)/2)*2)+animation_step, entry_pt->display_string, TRUE);
             }
             oled_reset_lim_display_y(&plat_oled_descriptor);
             
@@ -2190,16 +2303,18 @@ mini_input_yes_no_ret_te gui_prompts_ask_for_login_select(uint16_t parent_node_a
                     /* Load the right font */
                     oled_refresh_used_font(&plat_oled_descriptor, fonts_to_be_used[i]);
                     
-                    /* Fetch node if needed */
+                    /* Fetch login if needed */
                     if (i > 0)
                     {
-                        nodemgmt_read_cred_child_node_except_pwd(*(address_to_check_to_display[i]), temp_half_cnode_pt);
+                        strings_to_be_displayed[i] = gui_prompts_get_list_window_entry(*(address_to_check_to_display[i]), TRUE, &temp_half_cnode)->display_string;
                     }
                     
                     /* Surround center of list item */
                     if (i == 2)
                     {
+                        utils_strncpy(temp_half_cnode_pt->login, strings_to_be_displayed[i], MEMBER_ARRAY_SIZE(child_cred_node_t, login));
                         utils_surround_text_with_pointers(temp_half_cnode_pt->login, MEMBER_ARRAY_SIZE(child_cred_node_t, login));
+                        strings_to_be_displayed[i] = temp_half_cnode_pt->login;
                     }
                     
                     /* First address: store the "before top address */
@@ -2207,7 +2322,7 @@ mini_input_yes_no_ret_te gui_prompts_ask_for_login_select(uint16_t parent_node_a
                     {
                         if (child_addresses_overwrite == NULLPTR)
                         {
-                            before_top_of_list_child_addr = nodemgmt_get_prev_child_node_for_cur_category(top_of_list_child_addr);
+                            before_top_of_list_child_addr = gui_prompts_get_list_window_neighbour(top_of_list_child_addr, TRUE, FALSE, &temp_half_cnode);
                         } 
                         else
                         {
@@ -2275,7 +2390,7 @@ mini_input_yes_no_ret_te gui_prompts_ask_for_login_select(uint16_t parent_node_a
                         if (child_addresses_overwrite == NULLPTR)
                         {
                             /* Array has an extra slot */
-                            *(address_to_check_to_display[i+1]) = nodemgmt_get_next_child_node_for_cur_category(*(address_to_check_to_display[i]));
+                            *(address_to_check_to_display[i+1]) = gui_prompts_get_list_window_neighbour(*(address_to_check_to_display[i]), TRUE, TRUE, &temp_half_cnode);
                         }
                         else
                         {
@@ -2289,12 +2404,12 @@ mini_input_yes_no_ret_te gui_prompts_ask_for_login_select(uint16_t parent_node_a
                     {
                         if ((animation_step < 0) && (*(address_to_check_to_display[i+1]) != NODE_ADDR_NULL))
                         {
-                            /* Fetch node */
-                            nodemgmt_read_cred_child_node_except_pwd(*(address_to_check_to_display[i+1]), temp_half_cnode_pt);
+                            /* Fetch login */
+                            gui_prompts_list_window_entry_t* entry_pt = gui_prompts_get_list_window_entry(*(address_to_check_to_display[i+1]), TRUE, &temp_half_cnode);
                             
                             /* Display fading out login */
                             oled_refresh_used_font(&plat_oled_descriptor, FONT_UBUNTU_REGULAR_13_ID);
-                            oled_put_centered_string(&plat_oled_descriptor, LOGIN_SCROLL_Y_TLINE+(((LOGIN_SCROLL_Y_SLINE-LOGIN_SCROLL_Y_FLINE)/2)*2)+animation_step, temp_half_cnode_pt->login, TRUE);
+                            oled_put_centered_string(&plat_oled_descriptor, LOGIN_SCROLL_Y_TLINE+(((LOGIN_SCROLL_Y_SLINE-LOGIN_SCROLL_Y_FLINE)/2)*2)+animation_step, entry_pt->display_string, TRUE);
                         }
                     }
                 }
@@ -2383,6 +2498,9 @@ uint16_t gui_prompts_service_selection_screen(uint16_t start_address)
         return NODE_ADDR_NULL;
     }
     
+    /* Services are decoded once while scrolling */
+    gui_prompts_reset_list_window();
+    
     /* Clear frame buffer */
     #ifdef OLED_INTERNAL_FRAME_BUFFER
     oled_load_transition(&plat_oled_descriptor, OLED_IN_OUT_TRANS);
@@ -2392,7 +2510,7 @@ uint16_t gui_prompts_service_selection_screen(uint16_t start_address)
     #endif
     
     /* Temp vars for our main loop */
-    uint16_t top_of_list_parent_addr = nodemgmt_get_prev_parent_node_for_cur_category(start_address, NODEMGMT_STANDARD_CRED_TYPE_ID);
+    uint16_t top_of_list_parent_addr = gui_prompts_get_list_window_neighbour(start_address, FALSE, FALSE, &temp_pnode);
     uint16_t before_top_of_list_parent_addr = NODE_ADDR_NULL;
     uint16_t center_of_list_parent_addr = start_address;
     uint16_t bottom_of_list_parent_addr = NODE_ADDR_NULL;
@@ -2527,7 +2645,7 @@ uint16_t gui_prompts_service_selection_screen(uint16_t start_address)
                 fchar_array[0] = cur_fchar;
                 displaying_service_fchars = TRUE;
                 center_of_list_parent_addr = next_diff_fletter_node_addr;
-                top_of_list_parent_addr = nodemgmt_get_prev_parent_node_for_cur_category(center_of_list_parent_addr, NODEMGMT_STANDARD_CRED_TYPE_ID);
+                top_of_list_parent_addr = gui_prompts_get_list_window_neighbour(center_of_list_parent_addr, FALSE, FALSE, &temp_pnode);
                 animation_just_started = TRUE;
                 
                 /* Only 2 letters */
@@ -2560,7 +2678,7 @@ uint16_t gui_prompts_service_selection_screen(uint16_t start_address)
                 fchar_array[2] = cur_fchar;
                 displaying_service_fchars = TRUE;
                 center_of_list_parent_addr = prev_diff_fletter_node_addr;
-                top_of_list_parent_addr = nodemgmt_get_prev_parent_node_for_cur_category(center_of_list_parent_addr, NODEMGMT_STANDARD_CRED_TYPE_ID);
+                top_of_list_parent_addr = gui_prompts_get_list_window_neighbour(center_of_list_parent_addr, FALSE, FALSE, &temp_pnode);
                 animation_just_started = TRUE;
                 
                 /* Only 2 letters */
@@ -2650,12 +2768,12 @@ uint16_t gui_prompts_service_selection_screen(uint16_t start_address)
             oled_set_min_display_y(&plat_oled_descriptor, LOGIN_SCROLL_Y_BAR+1);
             if ((animation_step > 0) && (before_top_of_list_parent_addr != NODE_ADDR_NULL))
             {
-                /* Fetch node */
-                nodemgmt_read_parent_node(before_top_of_list_parent_addr, &temp_pnode, TRUE);
+                /* Fetch service */
+                gui_prompts_list_window_entry_t* entry_pt = gui_prompts_get_list_window_entry(before_top_of_list_parent_addr, FALSE, &temp_pnode);
                 
                 /* Display fading out service */
                 oled_refresh_used_font(&plat_oled_descriptor, FONT_UBUNTU_REGULAR_13_ID);
-                oled_put_centered_string(&plat_oled_descriptor, LOGIN_SCROLL_Y_FLINE-(((LOGIN_SCROLL_Y_TLINE-LOGIN_SCROLL_Y_SLINE)/2)*2)+animation_step, temp_pnode.cred_parent.service, TRUE);
+                oled_put_centered_string(&plat_oled_descriptor, LOGIN_SCROLL_Y_FLINE-(((LOGIN_SCROLL_Y_TLINE-LOGIN_SCROLL_Y_SLINE)/2)*2)+animation_step, entry_pt->display_string, TRUE);
             }
             oled_reset_lim_display_y(&plat_oled_descriptor);
             
@@ -2676,23 +2794,25 @@ uint16_t gui_prompts_service_selection_screen(uint16_t start_address)
                     /* Load the right font */
                     oled_refresh_used_font(&plat_oled_descriptor, fonts_to_be_used[i]);
                     
-                    /* Fetch node if needed */
+                    /* Fetch service if needed */
                     if (i > 0)
                     {
-                        nodemgmt_read_parent_node(*(address_to_check_to_display[i]), &temp_pnode, TRUE);
+                        strings_to_be_displayed[i] = gui_prompts_get_list_window_entry(*(address_to_check_to_display[i]), FALSE, &temp_pnode)->display_string;
                     }
                     
                     /* Surround center of list item */
                     if (i == 2)
                     {
-                        cur_fchar = temp_pnode.cred_parent.service[0];
+                        cur_fchar = strings_to_be_displayed[i][0];
+                        utils_strncpy(temp_pnode.cred_parent.service, strings_to_be_displayed[i], MEMBER_ARRAY_SIZE(parent_cred_node_t, service));
                         utils_surround_text_with_pointers(temp_pnode.cred_parent.service, MEMBER_ARRAY_SIZE(parent_data_node_t, service));
+                        strings_to_be_displayed[i] = temp_pnode.cred_parent.service;
                     }
                     
                     /* First address: store the "before top address */
                     if (i == 1)
                     {
-                        before_top_of_list_parent_addr = nodemgmt_get_prev_parent_node_for_cur_category(top_of_list_parent_addr, NODEMGMT_STANDARD_CRED_TYPE_ID);
+                        before_top_of_list_parent_addr = gui_prompts_get_list_window_neighbour(top_of_list_parent_addr, FALSE, FALSE, &temp_pnode);
                     }
                     
                     /* Last address: store correct bool */
@@ -2792,7 +2912,7 @@ uint16_t gui_prompts_service_selection_screen(uint16_t start_address)
                     if (i > 0)
                     {
                         /* Array has an extra element */
-                        *(address_to_check_to_display[i+1]) = nodemgmt_get_next_parent_node_for_cur_category(*(address_to_check_to_display[i]), NODEMGMT_STANDARD_CRED_TYPE_ID);
+                        *(address_to_check_to_display[i+1]) = gui_prompts_get_list_window_neighbour(*(address_to_check_to_display[i]), FALSE, TRUE, &temp_pnode);
                     }
                     
                     /* Last item & animation scrolling up: display upcoming item */
@@ -2800,12 +2920,12 @@ uint16_t gui_prompts_service_selection_screen(uint16_t start_address)
                     {
                         if ((animation_step < 0) && (*(address_to_check_to_display[i+1]) != NODE_ADDR_NULL))
                         {
-                            /* Fetch node */
-                            nodemgmt_read_parent_node(*(address_to_check_to_display[i+1]), &temp_pnode, TRUE);
+                            /* Fetch service */
+                            gui_prompts_list_window_entry_t* entry_pt = gui_prompts_get_list_window_entry(*(address_to_check_to_display[i+1]), FALSE, &temp_pnode);
                             
                             /* Display fading out login */
                             oled_refresh_used_font(&plat_oled_descriptor, FONT_UBUNTU_REGULAR_13_ID);
-                            oled_put_centered_string(&plat_oled_descriptor, LOGIN_SCROLL_Y_TLINE+(((LOGIN_SCROLL_Y_SLINE-LOGIN_SCROLL_Y_FLINE)/2)*2)+animation_step, temp_pnode.cred_parent.service, TRUE);
+                            oled_put_centered_string(&plat_oled_descriptor, LOGIN_SCROLL_Y_TLINE+(((LOGIN_SCROLL_Y_SLINE-LOGIN_SCROLL_Y_FLINE)/2)*2)+animation_step, entry_pt->display_string, TRUE);
                         }
                     }
                 }
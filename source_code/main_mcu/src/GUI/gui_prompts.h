@@ -24,6 +24,7 @@
 #ifndef GUI_PROMPTS_H_
 #define GUI_PROMPTS_H_
 
+#include "nodemgmt_defines.h"
 #include "defines.h"
 
 /* Defines */
@@ -118,6 +119,7 @@
 #define LOGIN_SCROLL_Y_SLINE            33
 #define LOGIN_SCROLL_Y_TLINE            49
 #define LOGIN_SCROLL_ANIM_DELAY         15
+#define LOGIN_SCROLL_WINDOW_SIZE        4
 
 // Delay when scrolling a text
 #define SCROLLING_DEL                   33
@@ -132,6 +134,19 @@ typedef struct
     cust_char_t* lines[4];
 } confirmationText_t;
 
+// Decoded service or login kept while scrolling through a list
+typedef struct
+{
+    uint16_t address;                       // Node address, NODE_ADDR_NULL for an empty slot
+    uint16_t prev_address;                  // Previous item for the current category, once fetched
+    uint16_t next_address;                  // Next item for the current category, once fetched
+    uint16_t category_flags;                // Category flags when prev_address / next_address were fetched
+    BOOL prev_address_fetched;              // Set when prev_address is valid
+    BOOL next_address_fetched;              // Set when next_address is valid
+    uint32_t last_use;                      // Window use counter when last accessed
+    cust_char_t display_string[SERVICE_NAME_MAX_LEN];
+} gui_prompts_list_window_entry_t;
+
 /* Prototypes */
 wheel_action_ret_te gui_prompts_render_pin_enter_screen(uint8_t* current_pin, uint16_t selected_digit, uint16_t stringID, int16_t vert_anim_direction, int16_t hor_anim_direction, BOOL six_digit_prompt, BOOL show_pin);
 mini_input_yes_no_ret_te gui_prompts_ask_for_confirmation(uint16_t nb_args, confirmationText_t* text_object, BOOL accept_cancel_message, BOOL parse_aux_messages, BOOL exit_on_power_change);
@@ -25,6 +25,7 @@
 #include "driver_timer.h"
 #include "platform_io.h"
 #include "inputs.h"
+#include "main.h"
 
 #if !defined(PLAT_V5_SETUP) && !defined(PLAT_V6_SETUP) && !defined(PLAT_V7_SETUP) && !defined(V2_PLAT_V1_SETUP)
 // Wheel machine states
@@ -68,6 +69,11 @@ volatile uint16_t inputs_force_reboot_timer = 0;
 */
 void inputs_scan(void)
 {
+    #ifndef BOOTLOADER
+    int16_t wheel_increment_before_scan = inputs_wheel_cur_increment;
+    det_ret_type_te wheel_click_before_scan = inputs_wheel_click_return;
+    #endif
+    
     #if !defined(PLAT_V5_SETUP) && !defined(PLAT_V6_SETUP) && !defined(PLAT_V7_SETUP) && !defined(V2_PLAT_V1_SETUP)
     uint16_t wheel_state, wheel_sm = 0;
     
@@ -303,6 +309,14 @@ void inputs_scan(void)
         }
         inputs_wheel_click_counter = 0;
     }
+    
+    #ifndef BOOTLOADER
+    /* Wake up the main loop on wheel action */
+    if ((wheel_increment_before_scan != inputs_wheel_cur_increment) || (wheel_click_before_scan != inputs_wheel_click_return))
+    {
+        main_post_event(MAIN_EVENT_INPUTS);
+    }
+    #endif
 }
 #endif
 
@@ -23,10 +23,140 @@
 #include "logic_encryption.h"
 #include "logic_database.h"
 #include "gui_dispatcher.h"
+#include "logic_security.h"
 #include "nodemgmt.h"
 #include "utils.h"
+/* Credential ID digests for the children of the last webauthn service we looked into */
+logic_database_webauthn_cred_id_cache_t logic_database_webauthn_cred_id_cache;
+/* First letter index for the service selection screen */
+logic_database_fletter_index_t logic_database_fletter_index;
 
 
+/*! \fn     logic_database_invalidate_fletter_index(void)
+*   \brief  Have the first letter index rebuilt on its next use
+*   \note   Called by the node management code when nodes are created, deleted or externally modified
+*/
+void logic_database_invalidate_fletter_index(void)
+{
+    logic_database_fletter_index.valid = FALSE;
+}
+
+/*! \fn     logic_database_update_fletter_index(uint16_t credential_type_id)
+*   \brief  Build the first letter index for a credential type and the current category, if not up to date
+*   \param  credential_type_id  Credential type ID
+*   \note   Each parent of the current category is read once. The index isn't used in management mode
+*/
+static void logic_database_update_fletter_index(uint16_t credential_type_id)
+{
+    logic_database_fletter_index_t* index_pt = &logic_database_fletter_index;
+    uint16_t category_flags = nodemgmt_get_current_category_flags();
+    parent_node_t temp_pnode;
+    uint16_t nb_parents = 0;
+    
+    /* Still up to date? Nodes can be modified in any way in management mode */
+    if (logic_security_is_management_mode_set() != FALSE)
+    {
+        index_pt->valid = FALSE;
+        return;
+    }
+    if ((index_pt->valid != FALSE) && (index_pt->credential_type_id == credential_type_id) && (index_pt->category_flags == category_flags))
+    {
+        return;
+    }
+    
+    /* Start building the index */
+    index_pt->valid = FALSE;
+    index_pt->too_many_letters = FALSE;
+    index_pt->credential_type_id = credential_type_id;
+    index_pt->category_flags = category_flags;
+    index_pt->nb_entries = 0;
+    
+    /* Go through the parents of the current category once */
+    uint16_t first_parent_addr = nodemgmt_get_starting_parent_addr_for_category(credential_type_id);
+    uint16_t parent_addr = first_parent_addr;
+    while (parent_addr != NODE_ADDR_NULL)
+    {
+        /* Database loop: keep the index valid but unusable, letter jumps will walk the parents */
+        if (nb_parents++ >= NODEMGMT_NB_NODE_SLOTS)
+        {
+            index_pt->too_many_letters = TRUE;
+            break;
+        }
+        
+        nodemgmt_read_parent_node(parent_addr, &temp_pnode, FALSE);
+        
+        if ((index_pt->nb_entries != 0) && (index_pt->entries[index_pt->nb_entries-1].fchar == temp_pnode.cred_parent.service[0]))
+        {
+            /* Same first letter as the previous service */
+            index_pt->entries[index_pt->nb_entries-1].last_address = parent_addr;
+            index_pt->entries[index_pt->nb_entries-1].nb_services++;
+        }
+        else if (index_pt->nb_entries == ARRAY_SIZE(index_pt->entries))
+        {
+            /* Letter jumps will go back to walking the parents */
+            index_pt->too_many_letters = TRUE;
+            break;
+        }
+        else
+        {
+            index_pt->entries[index_pt->nb_entries].fchar = temp_pnode.cred_parent.service[0];
+            index_pt->entries[index_pt->nb_entries].first_address = parent_addr;
+            index_pt->entries[index_pt->nb_entries].last_address = parent_addr;
+            index_pt->entries[index_pt->nb_entries].nb_services = 1;
+            index_pt->nb_entries++;
+        }
+        
+        /* Function loops over at the end of the list */
+        parent_addr = nodemgmt_get_next_parent_node_for_cur_category(parent_addr, credential_type_id);
+        if (parent_addr == first_parent_addr)
+        {
+            break;
+        }
+    }
+    
+    index_pt->valid = TRUE;
+}
+
+/*! \fn     logic_database_get_fletter_index_position(uint16_t service_address, cust_char_t fchar, uint16_t credential_type_id)
+*   \brief  Find the first letter index entry a given service belongs to
+*   \param  service_address     Service address
+*   \param  fchar               Service first letter
+*   \param  credential_type_id  Credential type ID
+*   \return Entry position or -1 if the index can't be used
+*/
+static int16_t logic_database_get_fletter_index_position(uint16_t service_address, cust_char_t fchar, uint16_t credential_type_id)
+{
+    logic_database_fletter_index_t* index_pt = &logic_database_fletter_index;
+    int16_t position = -1;
+    
+    logic_database_update_fletter_index(credential_type_id);
+    if ((index_pt->valid == FALSE) || (index_pt->too_many_letters != FALSE))
+    {
+        return -1;
+    }
+    
+    for (int16_t i = 0; i < (int16_t)index_pt->nb_entries; i++)
+    {
+        if (index_pt->entries[i].fchar == fchar)
+        {
+            /* Service at one end of that entry */
+            if ((index_pt->entries[i].first_address == service_address) || (index_pt->entries[i].last_address == service_address))
+            {
+                return i;
+            }
+            
+            /* Letter found several times (eg case differences), don't know which entry the service belongs to */
+            if (position >= 0)
+            {
+                return -1;
+            }
+            position = i;
+        }
+    }
+    
+    return position;
+}
+
 /*! \fn     logic_database_get_prev_2_fletters_services(uint16_t start_address, cust_char_t start_char, cust_char_t* char_array, uint16_t credential_type_id)
 *   \brief  Get the previous 2 services with different first letters
 *   \param  start_address       Address at which we should start looking
@@ -51,6 +181,73 @@ uint16_t logic_database_get_prev_2_fletters_services(uint16_t start_address, cus
     temp_pnode.cred_parent.prevParentAddress = start_address;
     char_array[0] = ' '; char_array[1] = ' ';
     
+    /* Use the first letter index when possible: same logic as below, one index entry at a time */
+    int16_t start_position = logic_database_get_fletter_index_position(start_address, start_char, credential_type_id);
+    if (start_position >= 0)
+    {
+        logic_database_fletter_index_entry_t* entries = logic_database_fletter_index.entries;
+        int16_t nb_entries = (int16_t)logic_database_fletter_index.nb_entries;
+        
+        /* Services of the current letter before start_address, then the other letters, then the services after start_address */
+        for (int16_t i = 0; i <= nb_entries; i++)
+        {
+            logic_database_fletter_index_entry_t* entry_pt = &entries[(start_position - i + nb_entries) % nb_entries];
+            uint16_t entry_first_address = entry_pt->first_address;
+            
+            if (((i == 0) && (start_address == entry_pt->first_address)) || ((i == nb_entries) && (start_address == entry_pt->last_address)))
+            {
+                continue;
+            }
+            if (i == nb_entries)
+            {
+                /* First service after start_address is unknown, but never returned */
+                entry_first_address = NODE_ADDR_NULL;
+            }
+            
+            if (entry_pt->fchar != cur_char)
+            {
+                if (skip_first_change_bool == FALSE)
+                {
+                    char_array[storage_index--] = cur_char;
+                    
+                    /* First next letter, store address */
+                    if (storage_index == 0)
+                    {
+                        return_value = last_seen_parent_node_that_fits_category;
+                    }
+                    
+                    /* Did we fill the array? */
+                    if (storage_index == -1)
+                    {
+                        return return_value;
+                    }
+                }
+                else
+                {
+                    skip_first_change_bool = FALSE;
+                }
+                
+                cur_char = entry_pt->fchar;
+            }
+            
+            last_seen_parent_node_that_fits_category = entry_first_address;
+        }
+        
+        /* Looped back */
+        if (cur_char != start_char)
+        {
+            char_array[storage_index--] = cur_char;
+            
+            /* First next letter, store address */
+            if (storage_index == 0)
+            {
+                return_value = last_seen_parent_node_that_fits_category;
+            }
+        }
+        
+        return return_value;
+    }
+    
     while(TRUE)
     {
         /* Update current node address */
@@ -145,6 +342,46 @@ uint16_t logic_database_get_next_2_fletters_services(uint16_t start_address, cus
     temp_pnode.cred_parent.nextParentAddress = start_address;
     char_array[0] = ' '; char_array[1] = ' ';
     
+    /* Use the first letter index when possible: same logic as below, one index entry at a time */
+    int16_t start_position = logic_database_get_fletter_index_position(start_address, cur_char, credential_type_id);
+    if (start_position >= 0)
+    {
+        logic_database_fletter_index_entry_t* entries = logic_database_fletter_index.entries;
+        int16_t nb_entries = (int16_t)logic_database_fletter_index.nb_entries;
+        
+        /* The other letters, then the services of the current letter before start_address */
+        for (int16_t i = 1; i <= nb_entries; i++)
+        {
+            logic_database_fletter_index_entry_t* entry_pt = &entries[(start_position + i) % nb_entries];
+            
+            if ((i == nb_entries) && (start_address == entry_pt->first_address))
+            {
+                break;
+            }
+            
+            if (entry_pt->fchar != cur_char)
+            {
+                /* Store node */
+                char_array[storage_index++] = entry_pt->fchar;
+                cur_char = entry_pt->fchar;
+                
+                /* First next letter, store address */
+                if (storage_index == 1)
+                {
+                    return_value = entry_pt->first_address;
+                }
+                
+                /* Did we fill the array? */
+                if (storage_index == 2)
+                {
+                    break;
+                }
+            }
+        }
+        
+        return return_value;
+    }
+    
     while(TRUE)
     {
         /* Check for credential loop */
@@ -265,6 +502,7 @@ uint16_t logic_database_search_for_next_data_parent_after_addr(uint16_t node_add
 *   \param  category_id             Credential/Data category ID
 *   \return Address of the found node, NODE_ADDR_NULL otherwise
 *   \note   Full 8Mb database search has been timed at 581ms
+*   \note   The walk starts from the parent given by the service index, close to the searched service
 */
 uint16_t logic_database_search_service(cust_char_t* name, service_compare_mode_te compare_type, BOOL cred_type, uint16_t category_id)
 {
@@ -309,6 +547,13 @@ uint16_t logic_database_search_service(cust_char_t* name, service_compare_mode_t
     }
     else
     {
+        /* Skip the parents that are known to be before the provided name */
+        uint16_t index_start_addr = nodemgmt_get_service_index_start_addr(name, (cred_type != FALSE)? FALSE : TRUE, category_id, mult_domain_possible);
+        if (index_start_addr != NODE_ADDR_NULL)
+        {
+            next_node_addr = index_start_addr;
+        }
+        
         /* Start going through the nodes */
         do
         {
@@ -445,50 +690,149 @@ uint16_t logic_database_search_webauthn_userhandle_in_service(uint16_t parent_ad
     return NODE_ADDR_NULL;
 }
 
-/*! \fn     logic_database_search_webauthn_credential_id_in_service(uint16_t parent_addr, uint8_t* credential_id)
-*   \brief  Find a given credential id for a given parent
-*   \param  parent_addr Parent node address
-*   \param  credential_id Credential ID
-*   \return Address of the found node, NODE_ADDR_NULL otherwise
+/*! \fn     logic_database_get_credential_id_digest(uint8_t* credential_id)
+*   \brief  Compute the digest of a credential ID
+*   \param  credential_id   Credential ID
+*   \return The digest
+*   \note   Credential IDs are random: folding them is enough
 */
-uint16_t logic_database_search_webauthn_credential_id_in_service(uint16_t parent_addr, uint8_t* credential_id)
+static inline uint32_t logic_database_get_credential_id_digest(uint8_t* credential_id)
 {
+    uint32_t credential_id_words[FIDO2_CREDENTIAL_ID_LENGTH/sizeof(uint32_t)];
+    uint32_t digest = 0;
+    
+    memcpy(credential_id_words, credential_id, sizeof(credential_id_words));
+    for (uint16_t i = 0; i < ARRAY_SIZE(credential_id_words); i++)
+    {
+        digest ^= credential_id_words[i];
+    }
+    return digest;
+}
+
+/*! \fn     logic_database_search_webauthn_credential_ids_in_service(uint16_t parent_addr, uint8_t credential_ids[][FIDO2_CREDENTIAL_ID_LENGTH], uint16_t nb_credential_ids, uint16_t* child_addresses, uint16_t* lnode_used_addr)
+*   \brief  Find the children matching a list of credential ids for a given parent
+*   \param  parent_addr         Parent node address
+*   \param  credential_ids      Credential IDs
+*   \param  nb_credential_ids   Number of credential IDs
+*   \param  child_addresses     Where to store the address of the node matching each credential ID, NODE_ADDR_NULL if not found
+*   \param  lnode_used_addr     Where to store the address of the child node that was last used for that parent, or 0
+*   \return Number of credential IDs found
+*   \note   Children are read once for all the credential IDs. Their credential ID digests are kept so that following searches in the same service only read the matching nodes
+*/
+uint16_t logic_database_search_webauthn_credential_ids_in_service(uint16_t parent_addr, uint8_t credential_ids[][FIDO2_CREDENTIAL_ID_LENGTH], uint16_t nb_credential_ids, uint16_t* child_addresses, uint16_t* lnode_used_addr)
+{
+    logic_database_webauthn_cred_id_cache_t* cache_pt = &logic_database_webauthn_cred_id_cache;
+    BOOL management_mode = logic_security_is_management_mode_set();
     child_webauthn_node_t* temp_half_cnode_pt;
     parent_node_t temp_pnode;
     uint16_t next_node_addr;
+    uint16_t nb_found = 0;
+    
+    _Static_assert(FIDO2_CREDENTIAL_ID_LENGTH == MEMBER_SIZE(child_webauthn_node_t, credential_id), "Invalid credential ID length");
     
     /* Dirty trick */
     temp_half_cnode_pt = (child_webauthn_node_t*)&temp_pnode;
     
+    /* Nothing found yet */
+    for (uint16_t i = 0; i < nb_credential_ids; i++)
+    {
+        child_addresses[i] = NODE_ADDR_NULL;
+    }
+    
     /* Read parent node and get first child address */
     nodemgmt_read_parent_node(parent_addr, &temp_pnode, TRUE);
     next_node_addr = temp_pnode.cred_parent.nextChildAddress;
+    if (lnode_used_addr != 0)
+    {
+        *lnode_used_addr = temp_pnode.cred_parent.last_cnode_used_addr;
+    }
     
-    /* Check that there's actually a child node */
-    if (next_node_addr == NODE_ADDR_NULL)
+    /* Digests still valid for that service? Nodes can be modified in any way in management mode */
+    if ((cache_pt->valid != FALSE) && (cache_pt->parent_address == parent_addr) && (cache_pt->first_child_address == next_node_addr) && (cache_pt->node_slots_change_counter == nodemgmt_get_node_slots_change_counter()) && (management_mode == FALSE))
     {
-        return NODE_ADDR_NULL;
+        for (uint16_t i = 0; i < nb_credential_ids; i++)
+        {
+            uint32_t digest = logic_database_get_credential_id_digest(credential_ids[i]);
+            
+            for (uint16_t j = 0; j < cache_pt->nb_entries; j++)
+            {
+                if (cache_pt->credential_id_digests[j] == digest)
+                {
+                    /* Digest match, confirm with the full credential id */
+                    nodemgmt_read_webauthn_child_node_except_display_name(cache_pt->child_addresses[j], temp_half_cnode_pt, FALSE);
+                    if (memcmp(temp_half_cnode_pt->credential_id, credential_ids[i], MEMBER_SIZE(child_webauthn_node_t, credential_id)) == 0)
+                    {
+                        child_addresses[i] = cache_pt->child_addresses[j];
+                        nb_found++;
+                        break;
+                    }
+                }
+            }
+        }
+        
+        return nb_found;
     }
     
-    /* Start going through the nodes */
-    do
+    /* Start building the digests for that service */
+    cache_pt->valid = FALSE;
+    cache_pt->parent_address = parent_addr;
+    cache_pt->first_child_address = next_node_addr;
+    cache_pt->nb_entries = 0;
+    BOOL all_digests_stored = TRUE;
+    
+    /* Go through the nodes once */
+    while (next_node_addr != NODE_ADDR_NULL)
     {
         /* Read child node */
         nodemgmt_read_webauthn_child_node_except_display_name(next_node_addr, temp_half_cnode_pt, FALSE);
         
-        /* Compare with provided credential id */
-        if (memcmp(temp_half_cnode_pt->credential_id, credential_id, MEMBER_SIZE(child_webauthn_node_t, credential_id)) == 0)
+        /* Compare with all the provided credential ids */
+        for (uint16_t i = 0; i < nb_credential_ids; i++)
         {
-            return next_node_addr;
+            if ((child_addresses[i] == NODE_ADDR_NULL) && (memcmp(temp_half_cnode_pt->credential_id, credential_ids[i], MEMBER_SIZE(child_webauthn_node_t, credential_id)) == 0))
+            {
+                child_addresses[i] = next_node_addr;
+                nb_found++;
+            }
+        }
+        
+        /* Store digest */
+        if (cache_pt->nb_entries < ARRAY_SIZE(cache_pt->child_addresses))
+        {
+            cache_pt->credential_id_digests[cache_pt->nb_entries] = logic_database_get_credential_id_digest(temp_half_cnode_pt->credential_id);
+            cache_pt->child_addresses[cache_pt->nb_entries++] = next_node_addr;
+        }
+        else
+        {
+            all_digests_stored = FALSE;
         }
         
         /* Go to next one */
         next_node_addr = temp_half_cnode_pt->nextChildAddress;
     }
-    while (next_node_addr != NODE_ADDR_NULL);
     
-    /* We didn't find the credential id */
-    return NODE_ADDR_NULL;
+    /* Digests can only be used if we have them all */
+    if ((all_digests_stored != FALSE) && (management_mode == FALSE))
+    {
+        cache_pt->node_slots_change_counter = nodemgmt_get_node_slots_change_counter();
+        cache_pt->valid = TRUE;
+    }
+    
+    return nb_found;
+}
+
+/*! \fn     logic_database_search_webauthn_credential_id_in_service(uint16_t parent_addr, uint8_t* credential_id)
+*   \brief  Find a given credential id for a given parent
+*   \param  parent_addr Parent node address
+*   \param  credential_id Credential ID
+*   \return Address of the found node, NODE_ADDR_NULL otherwise
+*/
+uint16_t logic_database_search_webauthn_credential_id_in_service(uint16_t parent_addr, uint8_t* credential_id)
+{
+    uint16_t child_address;
+    
+    logic_database_search_webauthn_credential_ids_in_service(parent_addr, (uint8_t (*)[FIDO2_CREDENTIAL_ID_LENGTH])credential_id, 1, &child_address, 0);
+    return child_address;
 }
 
 /*! \fn     logic_database_search_login_in_service(uint16_t parent_addr, cust_char_t* login, BOOL category_filter)
@@ -845,8 +1189,9 @@ void logic_database_update_webauthn_credential(uint16_t child_address, cust_char
     temp_cnode.dateCreated = nodemgmt_get_current_date();
     temp_cnode.dateLastUsed = nodemgmt_get_current_date();
 
-    /* Then write node */
+    /* Then write node, its credential id changed */
     nodemgmt_write_child_node_block_to_flash(child_address, (child_node_t*)&temp_cnode, FALSE);
+    logic_database_webauthn_cred_id_cache.valid = FALSE;
     nodemgmt_user_db_changed_actions(FALSE);
 }
 
@@ -24,10 +24,48 @@
 #ifndef LOGIC_DATABASE_H_
 #define LOGIC_DATABASE_H_
 
+#include "fido2_values_defines.h"
 #include "comms_hid_msgs.h"
 #include "nodemgmt.h"
 #include "defines.h"
 
+/* Defines */
+#define LOGIC_DATABASE_WEBAUTHN_CRED_ID_CACHE_SIZE  32
+#define LOGIC_DATABASE_FLETTER_INDEX_SIZE           64
+
+/* Typedefs */
+// Credential ID digests for the children of a webauthn service
+typedef struct
+{
+    BOOL valid;                             // Set when the arrays below list all the children of parent_address
+    uint16_t parent_address;                // Webauthn service address
+    uint16_t first_child_address;           // First child address when the digests were computed
+    uint16_t node_slots_change_counter;     // Node slots change counter when the digests were computed
+    uint16_t nb_entries;                    // Number of children
+    uint16_t child_addresses[LOGIC_DATABASE_WEBAUTHN_CRED_ID_CACHE_SIZE];
+    uint32_t credential_id_digests[LOGIC_DATABASE_WEBAUTHN_CRED_ID_CACHE_SIZE];
+} logic_database_webauthn_cred_id_cache_t;
+
+// Consecutive services sharing the same first letter, for a given credential type and category
+typedef struct
+{
+    cust_char_t fchar;                      // First letter
+    uint16_t first_address;                 // Address of the first service starting with that letter
+    uint16_t last_address;                  // Address of the last service starting with that letter
+    uint16_t nb_services;                   // Number of services starting with that letter
+} logic_database_fletter_index_entry_t;
+
+// First letter index for a credential type, used by the service selection screen letter jumps
+typedef struct
+{
+    BOOL valid;                             // Set when the entries below describe the services for credential_type_id & category_flags
+    BOOL too_many_letters;                  // Set when the entries array wasn't big enough or the parent list loops: index can't be used
+    uint16_t credential_type_id;            // Credential type ID when the index was built
+    uint16_t category_flags;                // Current category flags when the index was built
+    uint16_t nb_entries;                    // Number of entries
+    logic_database_fletter_index_entry_t entries[LOGIC_DATABASE_FLETTER_INDEX_SIZE];
+} logic_database_fletter_index_t;
+
 
 /* Prototypes */
 RET_TYPE logic_database_add_webauthn_credential_for_service(uint16_t service_addr, uint8_t* user_handle, uint8_t user_handle_len, cust_char_t* user_name, cust_char_t* display_name, uint8_t* private_key,  uint8_t* ctr, uint8_t* credential_id, uint8_t keyType);
@@ -38,6 +76,7 @@ uint16_t logic_database_fill_get_cred_message_answer(uint16_t child_node_addr, h
 RET_TYPE logic_database_add_credential_for_service(uint16_t service_addr, cust_char_t* login, cust_char_t* desc, cust_char_t* third, uint8_t* password, uint8_t* ctr);
 uint16_t logic_database_get_prev_2_fletters_services(uint16_t start_address, cust_char_t start_char, cust_char_t* char_array, uint16_t credential_type_id);
 uint16_t logic_database_get_next_2_fletters_services(uint16_t start_address, cust_char_t cur_char, cust_char_t* char_array, uint16_t credential_type_id);
+void logic_database_invalidate_fletter_index(void);
 RET_TYPE logic_database_add_TOTP_credential_for_service(uint16_t service_addr, cust_char_t* login, TOTPcredentials_t const *TOTPcreds, uint8_t *ctr);
 uint16_t logic_database_get_number_of_creds_for_service(uint16_t parent_addr, uint16_t* fnode_addr, uint16_t* lnode_used_addr, BOOL category_filter);
 uint16_t logic_database_search_for_next_data_parent_after_addr(uint16_t node_addr, nodemgmt_data_category_te data_type, cust_char_t* service_name);
@@ -50,6 +89,7 @@ void logic_database_get_webauthn_userhandle_for_address(uint16_t child_addr, uin
 RET_TYPE logic_database_update_TOTP_credentials(uint16_t child_addr, TOTPcredentials_t const *TOTPcreds, uint8_t* ctr);
 uint16_t logic_database_add_service(cust_char_t* service, service_type_te cred_type, uint16_t data_category_id);
 uint16_t logic_database_search_login_in_service(uint16_t parent_addr, cust_char_t* login, BOOL category_filter);
+uint16_t logic_database_search_webauthn_credential_ids_in_service(uint16_t parent_addr, uint8_t credential_ids[][FIDO2_CREDENTIAL_ID_LENGTH], uint16_t nb_credential_ids, uint16_t* child_addresses, uint16_t* lnode_used_addr);
 uint16_t logic_database_search_webauthn_credential_id_in_service(uint16_t parent_addr, uint8_t* credential_id);
 void logic_database_get_webauthn_username_for_address(uint16_t child_addr, cust_char_t* user_name);
 void logic_database_get_login_for_address(uint16_t child_addr, cust_char_t** login);
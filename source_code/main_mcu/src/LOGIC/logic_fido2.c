@@ -122,24 +122,31 @@ static uint32_t logic_fido2_cbor_encode_public_key(uint8_t* buf, uint32_t bufLen
     return output_data_length;
 }
 
-/*! \fn     logic_fido2_process_exclude_list_item(fido2_auth_cred_req_message_t* request)
-*   \brief  Process Exclude list check from aux_mcu.
-*           Checks if tag already exists. Returns 1 if credential exists or 0
-*           otherwise. If tag exists prompt the user and wait for user ack.
-*   \param  incoming messsage request
-*   \return void
+/*! \fn     logic_fido2_check_exclude_list_credential_ids(uint8_t* rpID, uint8_t credential_ids[][FIDO2_CREDENTIAL_ID_LENGTH], uint16_t nb_credential_ids)
+*   \brief  Check if one of the given credential IDs already exists for a given rpID and answer aux MCU.
+*           If one exists prompt the user and wait for user ack.
+*   \param  rpID                UTF8 rpID, FIDO2_RPID_LEN long, will be zero terminated
+*   \param  credential_ids      Credential IDs to look for
+*   \param  nb_credential_ids   Number of credential IDs, at most FIDO2_ALLOW_LIST_MAX_SIZE
+*   \note   rpID and credential_ids may point to the received message, which gets overwritten when prompting the user
 */
-void logic_fido2_process_exclude_list_item(fido2_auth_cred_req_message_t* request)
+static void logic_fido2_check_exclude_list_credential_ids(uint8_t* rpID, uint8_t credential_ids[][FIDO2_CREDENTIAL_ID_LENGTH], uint16_t nb_credential_ids)
 {
+    uint16_t child_addresses[FIDO2_ALLOW_LIST_MAX_SIZE];
     fido2_credential_ID_t cred_ID_copy;
+    uint16_t child_address = NODE_ADDR_NULL;
 
     /* Input sanitation & buffer for UTF8 to Unicode BMP conversion */
     cust_char_t rp_id_copy[MEMBER_ARRAY_SIZE(parent_data_node_t, service)];
-    request->rpID[MEMBER_SIZE(fido2_auth_cred_req_message_t, rpID)-1] = 0;
+    rpID[FIDO2_RPID_LEN-1] = 0;
     memset(rp_id_copy, 0, sizeof(rp_id_copy));
+    if (nb_credential_ids > FIDO2_ALLOW_LIST_MAX_SIZE)
+    {
+        nb_credential_ids = FIDO2_ALLOW_LIST_MAX_SIZE;
+    }
     
     /* Try to convert to unicode BMP */
-    int16_t rpid_conv_length = utils_utf8_string_to_bmp_string(request->rpID, rp_id_copy, MEMBER_SIZE(fido2_auth_cred_req_message_t, rpID), ARRAY_SIZE(rp_id_copy));
+    int16_t rpid_conv_length = utils_utf8_string_to_bmp_string(rpID, rp_id_copy, FIDO2_RPID_LEN, ARRAY_SIZE(rp_id_copy));
     
     /* Did the conversion go badly? */
     if (rpid_conv_length < 0)
@@ -164,8 +171,22 @@ void logic_fido2_process_exclude_list_item(fido2_auth_cred_req_message_t* reques
         return;
     }
     
-    /* Look for credential ID */
-    uint16_t child_address = logic_database_search_webauthn_credential_id_in_service(parent_address, request->cred_ID.tag);
+    /* Look for all credential IDs in a single pass over the children, keep the first one found */
+    if (logic_database_search_webauthn_credential_ids_in_service(parent_address, credential_ids, nb_credential_ids, child_addresses, 0) != 0)
+    {
+        for (uint16_t i = 0; i < nb_credential_ids; i++)
+        {
+            if (child_addresses[i] != NODE_ADDR_NULL)
+            {
+                /* gui_prompts_ask_for_confirmation() reuses buffer that contains the request. Make a copy
+                 * of the credential ID since we are using this value afterwards
+                 */
+                memcpy(cred_ID_copy.tag, credential_ids[i], sizeof(cred_ID_copy.tag));
+                child_address = child_addresses[i];
+                break;
+            }
+        }
+    }
     
     /* Static asserts */
     _Static_assert(MEMBER_SIZE(fido2_auth_cred_rsp_message_t, user_handle) >= MEMBER_SIZE(child_webauthn_node_t, user_handle), "user handle size not big enough");
@@ -181,11 +202,6 @@ void logic_fido2_process_exclude_list_item(fido2_auth_cred_req_message_t* reques
     }
     else
     {
-        /* gui_prompts_ask_for_confirmation() reuses buffer that contains the "request" object. Make a copy
-         * of the request->cred_ID since we are using this value afterwards
-         */
-        memcpy(&cred_ID_copy, &request->cred_ID, sizeof(cred_ID_copy));
-
         /* Wait for user ACK */
         cust_char_t* display_cred_prompt_text;
         custom_fs_get_string_from_file(CRED_ALREAD_PRESENT_TEXT_ID, &display_cred_prompt_text, TRUE);
@@ -206,6 +222,32 @@ void logic_fido2_process_exclude_list_item(fido2_auth_cred_req_message_t* reques
     }
 }
 
+/*! \fn     logic_fido2_process_exclude_list_item(fido2_auth_cred_req_message_t* request)
+*   \brief  Process Exclude list check from aux_mcu.
+*           Checks if tag already exists. Returns 1 if credential exists or 0
+*           otherwise. If tag exists prompt the user and wait for user ack.
+*   \param  incoming messsage request
+*   \return void
+*/
+void logic_fido2_process_exclude_list_item(fido2_auth_cred_req_message_t* request)
+{
+    _Static_assert(MEMBER_SIZE(fido2_auth_cred_req_message_t, rpID) == FIDO2_RPID_LEN, "Invalid rpID length");
+    logic_fido2_check_exclude_list_credential_ids(request->rpID, (uint8_t (*)[FIDO2_CREDENTIAL_ID_LENGTH])request->cred_ID.tag, 1);
+}
+
+/*! \fn     logic_fido2_process_exclude_list(fido2_exclude_list_req_message_t* request)
+*   \brief  Process a batch of exclude list credential IDs from aux_mcu.
+*           Checks if one of the tags already exists. Returns 1 if a credential exists or 0
+*           otherwise. If a tag exists prompt the user and wait for user ack.
+*   \param  incoming messsage request
+*   \return void
+*/
+void logic_fido2_process_exclude_list(fido2_exclude_list_req_message_t* request)
+{
+    _Static_assert(MEMBER_SIZE(fido2_exclude_list_req_message_t, rpID) == FIDO2_RPID_LEN, "Invalid rpID length");
+    logic_fido2_check_exclude_list_credential_ids(request->rpID, request->exclude_list.tag, request->exclude_list.len);
+}
+
 /*! \fn     logic_fido2_process_make_credential(fido2_make_credential_req_message_t* request)
 *   \brief  Make a new credential. This essentially creates the key pair and stores the new record in the DB
 *   \param  incoming request message
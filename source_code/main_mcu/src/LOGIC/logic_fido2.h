@@ -47,5 +47,6 @@ typedef enum
 void logic_fido2_process_make_credential(fido2_make_credential_req_message_t* request);
 void logic_fido2_process_get_assertion(fido2_get_assertion_req_message_t* request);
 void logic_fido2_process_exclude_list_item(fido2_auth_cred_req_message_t* request);
+void logic_fido2_process_exclude_list(fido2_exclude_list_req_message_t* request);
 
 #endif /* FIDO2_H_ */
@@ -39,6 +39,7 @@
 #include "logic_power.h"
 #include "logic_user.h"
 #include "custom_fs.h"
+#include "dbflash.h"
 #include "text_ids.h"
 #include "inputs.h"
 #include "utils.h"
@@ -319,6 +320,7 @@ void logic_power_power_down_actions(void)
     memcpy((void*)&logic_power_consumption_log_copy, (void*)&logic_power_consumption_log, sizeof(logic_power_consumption_log_copy));
     cpu_irq_leave_critical();
     custom_fs_store_power_consumption_log_and_calib_data((power_consumption_log_t*)&logic_power_consumption_log_copy, &current_time_calibration_data);
+    dbflash_flush_cache(&dbflash_descriptor);
 }
 
 /*! \fn     logic_power_get_lifetime_log(lifetime_log_t* lifetime_log_pt)
@@ -25,6 +25,7 @@
 #include "smartcard_lowlevel.h"
 #include "logic_encryption.h"
 #include "logic_smartcard.h"
+#include "comms_hid_msgs.h"
 #include "gui_dispatcher.h"
 #include "logic_security.h"
 #include "logic_aux_mcu.h"
@@ -38,7 +39,9 @@
 #include "nodemgmt.h"
 #include "text_ids.h"
 #include "bearssl.h"
+#include "dbflash.h"
 #include "utils.h"
+#include "main.h"
 
 
 /*! \fn     logic_smartcard_ask_for_new_pin(uint16_t* new_pin, uint16_t message_id)
@@ -80,8 +83,14 @@ void logic_smartcard_handle_removed(void)
     platform_io_smc_remove_function();
     logic_security_clear_security_bools();
     
+    /* Write back pending database changes */
+    dbflash_flush_cache(&dbflash_descriptor);
+    
     /* Delete encryption context */
     logic_encryption_delete_context();
+    
+    /* Clear decrypted data buffered by an ongoing file export */
+    comms_hid_msgs_end_file_stream();
 }
 
 /*! \fn     logic_smartcard_handle_inserted(void)
@@ -1422,11 +1422,11 @@ RET_TYPE logic_user_store_TOTP_credential(cust_char_t* service, cust_char_t* log
 */
 fido2_return_code_te logic_user_get_webauthn_credential_key_for_rp(cust_char_t* rp_id, uint8_t* user_handle, uint8_t *user_handle_len, uint8_t* credential_id, uint8_t* private_key, uint32_t* count, uint8_t credential_id_allow_list[FIDO2_ALLOW_LIST_MAX_SIZE][FIDO2_CREDENTIAL_ID_LENGTH], uint16_t credential_id_allow_list_length, uint8_t flags, uint8_t *keyType)
 {
+    _Static_assert(0 == NODE_ADDR_NULL, "Invalid node addr null value");
+    uint16_t allowed_child_addresses[FIDO2_ALLOW_LIST_MAX_SIZE+1];
     uint8_t temp_cred_ctr[MEMBER_SIZE(child_webauthn_node_t, ctr)];
     uint16_t last_used_child_address_for_service;
-    
-    /* TODO2: allow an allow list that has more than 1, which requires extra code on the GUI as it isn't as simple as listing all children nodes */
-    /* However, I'm not sure why this would happen, as the RP would need to keep track of all aliases of a given user... */
+    uint16_t nb_logins_for_cred;
     
     /* Copy strings locally */
     cust_char_t temp_user_name[MEMBER_ARRAY_SIZE(child_webauthn_node_t, user_name)+1];
@@ -1450,26 +1450,54 @@ fido2_return_code_te logic_user_get_webauthn_credential_key_for_rp(cust_char_t*
         return FIDO2_NO_CREDENTIALS;
     }
     
-    /* See how many credentials there are for this service */
-    uint16_t nb_logins_for_cred = logic_database_get_number_of_creds_for_service(parent_address, &child_address, &last_used_child_address_for_service, FALSE);
-    
-    /* Check if wanted credential id has been specified or if there's only one credential for that service */
-    if ((credential_id_allow_list_length == 1) || (nb_logins_for_cred == 1))
+    /* Credential allow list present? */
+    memset(allowed_child_addresses, 0, sizeof(allowed_child_addresses));
+    if (credential_id_allow_list_length != 0)
     {
-        /* Login specified? look for it */
-        if (credential_id_allow_list_length != 0)
+        uint16_t matching_child_addresses[FIDO2_ALLOW_LIST_MAX_SIZE];
+        
+        /* Input sanitizing */
+        if (credential_id_allow_list_length >= FIDO2_ALLOW_LIST_MAX_SIZE)
         {
-            child_address = logic_database_search_webauthn_credential_id_in_service(parent_address, credential_id_allow_list[0]);
-            
-            /* Check for existing login */
-            if (child_address == NODE_ADDR_NULL)
+            credential_id_allow_list_length = FIDO2_ALLOW_LIST_MAX_SIZE;
+        }
+        
+        /* Look for all the allowed credential ids at once */
+        logic_database_search_webauthn_credential_ids_in_service(parent_address, credential_id_allow_list, credential_id_allow_list_length, matching_child_addresses, &last_used_child_address_for_service);
+        
+        /* List the matching child addresses, an allow list may contain the same credential id several times */
+        nb_logins_for_cred = 0;
+        for (uint16_t i = 0; i < credential_id_allow_list_length; i++)
+        {
+            if (matching_child_addresses[i] != NODE_ADDR_NULL)
             {
-                /* From 1s to 3s */
-                timer_delay_ms(1000 + (rng_get_random_uint16_t()&0x07FF));
-                return FIDO2_NO_CREDENTIALS;
+                BOOL already_listed = FALSE;
+                for (uint16_t j = 0; j < nb_logins_for_cred; j++)
+                {
+                    if (allowed_child_addresses[j] == matching_child_addresses[i])
+                    {
+                        already_listed = TRUE;
+                    }
+                }
+                if (already_listed == FALSE)
+                {
+                    allowed_child_addresses[nb_logins_for_cred++] = matching_child_addresses[i];
+                }
             }
         }
         
+        /* Default to the first allowed credential */
+        child_address = allowed_child_addresses[0];
+    }
+    else
+    {
+        /* See how many credentials there are for this service */
+        nb_logins_for_cred = logic_database_get_number_of_creds_for_service(parent_address, &child_address, &last_used_child_address_for_service, FALSE);
+    }
+    
+    /* Check if there's only one allowed credential for that service */
+    if (nb_logins_for_cred == 1)
+    {
         /* Fetch username for that credential id, username is already 0 terminated by code above */
         logic_database_get_webauthn_username_for_address(child_address, temp_user_name);
         
@@ -1554,38 +1582,18 @@ fido2_return_code_te logic_user_get_webauthn_credential_key_for_rp(cust_char_t*
                 } 
                 else
                 {
-                    _Static_assert(0 == NODE_ADDR_NULL, "Invalid node addr null value");
-                    uint16_t child_addresses[FIDO2_ALLOW_LIST_MAX_SIZE+1];
-                    memset(child_addresses, 0, sizeof(child_addresses));
-                    
-                    /* Input sanitizing */
-                    if (credential_id_allow_list_length >= FIDO2_ALLOW_LIST_MAX_SIZE)
-                    {
-                        credential_id_allow_list_length = FIDO2_ALLOW_LIST_MAX_SIZE;
-                    }
-                    
-                    /* Populate the child addresses */
-                    uint16_t populating_index = 0;
+                    /* If one of the allowed credentials was the last used one, select it by default */
                     uint16_t suggested_child_address = NODE_ADDR_NULL;
-                    for (uint16_t i = 0; i < credential_id_allow_list_length; i++)
+                    for (uint16_t i = 0; i < nb_logins_for_cred; i++)
                     {
-                        /* Look for child address that has that credential id */
-                        child_address = logic_database_search_webauthn_credential_id_in_service(parent_address, credential_id_allow_list[i]);
-                        if (child_address != NODE_ADDR_NULL)
-                        {
-                            child_addresses[populating_index] = child_address;
-                            populating_index++;
-                        }
-                        
-                        /* If that child address is identical to the one that was last used, select it by default */
-                        if (child_address == last_used_child_address_for_service)
+                        if (allowed_child_addresses[i] == last_used_child_address_for_service)
                         {
-                            suggested_child_address = child_address;
+                            suggested_child_address = allowed_child_addresses[i];
                         }
                     }
                     
                     /* Ask user to select credential */
-                    mini_input_yes_no_ret_te display_prompt_return = gui_prompts_ask_for_login_select(parent_address, &suggested_child_address, child_addresses);
+                    mini_input_yes_no_ret_te display_prompt_return = gui_prompts_ask_for_login_select(parent_address, &suggested_child_address, allowed_child_addresses);
                     if (display_prompt_return != MINI_INPUT_RET_YES)
                     {
                         child_address = NODE_ADDR_NULL;
@@ -1607,7 +1615,7 @@ fido2_return_code_te logic_user_get_webauthn_credential_key_for_rp(cust_char_t*
             }
             
             /* Fetch webauthn data
-             * If this is a silent request we don't prompt above. We instead just select the first credential (already in "child_address" according to above comment and send that
+             * If this is a silent request we don't prompt above. We instead just select the first allowed credential (already in "child_address" according to above comment and send that
              * back. The credential is not used for login anyway. It is just to check that the authenticator has credentials for this RPID.
              * No need to check for child_address == NULL since either it is a silent assertion (and child_address is already populated) OR we returned above if the user backed out of the prompt.
              */
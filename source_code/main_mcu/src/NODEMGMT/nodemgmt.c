@@ -23,6 +23,7 @@
 #include <string.h>
 #include <stddef.h>
 #include "comms_hid_msgs_debug.h"
+#include "logic_database.h"
 #include "logic_device.h"
 #include "driver_timer.h"
 #include "nodemgmt.h"
@@ -217,6 +218,103 @@ void nodemgmt_check_address_validity_and_lock(uint16_t node_addr)
     }
 }
 
+/*! \fn     nodemgmt_get_node_slot_index(uint16_t page, uint16_t node)
+*   \brief  Get the node usage bitmap index for a given node slot
+*   \param  page    Page number (>= PAGE_PER_SECTOR)
+*   \param  node    Node number inside the page
+*   \return Bit index inside the node usage bitmap
+*/
+static inline uint16_t nodemgmt_get_node_slot_index(uint16_t page, uint16_t node)
+{
+    return ((page - PAGE_PER_SECTOR) * NODEMGMT_NODES_PER_PAGE) + node;
+}
+
+/*! \fn     nodemgmt_is_node_slot_taken(uint16_t page, uint16_t node)
+*   \brief  Check in the node usage bitmap if a given node slot is taken
+*   \param  page    Page number (>= PAGE_PER_SECTOR)
+*   \param  node    Node number inside the page
+*   \return TRUE if the slot is taken
+*/
+static inline BOOL nodemgmt_is_node_slot_taken(uint16_t page, uint16_t node)
+{
+    uint16_t slot_index = nodemgmt_get_node_slot_index(page, node);
+
+    if ((nodemgmt_current_handle.nodeUsageBitmap[slot_index >> 3] & (1 << (slot_index & 0x07))) != 0)
+    {
+        return TRUE;
+    }
+    else
+    {
+        return FALSE;
+    }
+}
+
+/*! \fn     nodemgmt_set_node_slot_usage(uint16_t node_addr, uint16_t flags)
+*   \brief  Update the node usage bitmap for a given node slot
+*   \param  node_addr   Node address
+*   \param  flags       Flags that were just written at the beginning of the node slot
+*/
+static void nodemgmt_set_node_slot_usage(uint16_t node_addr, uint16_t flags)
+{
+    uint16_t page_addr = nodemgmt_page_from_address(node_addr);
+
+    /* Only keep track of the node slots (no user profiles) */
+    if (nodemgmt_check_address_validity(node_addr) != RETURN_OK)
+    {
+        return;
+    }
+
+    uint16_t slot_index = nodemgmt_get_node_slot_index(page_addr, nodemgmt_node_from_address(node_addr));
+    uint8_t previous_bitmap_byte = nodemgmt_current_handle.nodeUsageBitmap[slot_index >> 3];
+
+    if (validBitFromFlags(flags) == NODEMGMT_VBIT_VALID)
+    {
+        nodemgmt_current_handle.nodeUsageBitmap[slot_index >> 3] |= (1 << (slot_index & 0x07));
+    }
+    else
+    {
+        nodemgmt_current_handle.nodeUsageBitmap[slot_index >> 3] &= ~(1 << (slot_index & 0x07));
+    }
+    
+    /* Node slot taken or freed: a node was created or deleted */
+    if (nodemgmt_current_handle.nodeUsageBitmap[slot_index >> 3] != previous_bitmap_byte)
+    {
+        nodemgmt_current_handle.nodeSlotsChangeCounter++;
+        logic_database_invalidate_fletter_index();
+    }
+}
+
+/*! \fn     nodemgmt_erase_node_slot(uint16_t node_addr)
+*   \brief  Erase a node slot (base node size) and mark it as free
+*   \param  node_addr   Node address
+*/
+static void nodemgmt_erase_node_slot(uint16_t node_addr)
+{
+    dbflash_write_data_pattern_to_flash(&dbflash_descriptor, nodemgmt_page_from_address(node_addr), BASE_NODE_SIZE * nodemgmt_node_from_address(node_addr), BASE_NODE_SIZE, 0xFF);
+    nodemgmt_set_node_slot_usage(node_addr, UINT16_MAX);
+}
+
+/*! \fn     nodemgmt_build_node_usage_bitmap(void)
+*   \brief  Scan the node flags in flash to build the node usage bitmap
+*   \note   Only done once at login, the bitmap is then kept up to date by the write & delete functions
+*/
+static void nodemgmt_build_node_usage_bitmap(void)
+{
+    uint16_t node_flags;
+
+    memset(nodemgmt_current_handle.nodeUsageBitmap, 0, sizeof(nodemgmt_current_handle.nodeUsageBitmap));
+
+    for (uint16_t page = PAGE_PER_SECTOR; page < PAGE_COUNT; page++)
+    {
+        for (uint16_t node = 0; node < NODEMGMT_NODES_PER_PAGE; node++)
+        {
+            // read node flags (2 bytes - fixed size)
+            dbflash_read_data_from_flash(&dbflash_descriptor, page, BASE_NODE_SIZE*node, sizeof(node_flags), &node_flags);
+            nodemgmt_set_node_slot_usage(constructAddress(page, node), node_flags);
+        }
+    }
+}
+
 /*! \fn     nodemgmt_check_user_permission(uint16_t node_addr, node_type_te* node_type)
 *   \brief  Check that the user has the right to read/write a node
 *   \param  node_addr   Node address
@@ -268,6 +366,7 @@ void nodemgmt_write_parent_node_data_block_to_flash(uint16_t address, parent_nod
     nodemgmt_check_address_validity_and_lock(address);
     nodemgmt_user_id_to_flags(&(parent_node->cred_parent.flags), nodemgmt_current_handle.currentUserId);
     dbflash_write_data_to_flash(&dbflash_descriptor, nodemgmt_page_from_address(address), BASE_NODE_SIZE * nodemgmt_node_from_address(address), BASE_NODE_SIZE, (void*)parent_node->node_as_bytes);
+    nodemgmt_set_node_slot_usage(address, parent_node->cred_parent.flags);
 }
 
 /*! \fn     nodemgmt_write_child_node_block_to_flash(uint16_t address, child_node_t* child_node, BOOL write_category)
@@ -296,6 +395,119 @@ void nodemgmt_write_child_node_block_to_flash(uint16_t address, child_node_t* ch
     nodemgmt_check_address_validity_and_lock(address);
     dbflash_write_data_to_flash(&dbflash_descriptor, nodemgmt_page_from_address(address), BASE_NODE_SIZE * nodemgmt_node_from_address(address), BASE_NODE_SIZE, (void*)child_node->node_as_bytes);
     dbflash_write_data_to_flash(&dbflash_descriptor, nodemgmt_page_from_address(nodemgmt_get_incremented_address(address)), BASE_NODE_SIZE * nodemgmt_node_from_address(nodemgmt_get_incremented_address(address)), BASE_NODE_SIZE, (void*)(&child_node->node_as_bytes[BASE_NODE_SIZE]));
+    
+    /* Update node usage for both halves */
+    nodemgmt_set_node_slot_usage(address, child_node->cred_child.flags);
+    nodemgmt_set_node_slot_usage(nodemgmt_get_incremented_address(address), child_node->cred_child.fakeFlags);
+}
+
+/*! \fn     nodemgmt_write_node_blocks_to_flash(uint16_t nb_nodes, uint16_t* addresses, uint16_t* lengths, uint8_t** nodes)
+*   \brief  Write several parent / child node data blocks to flash, one write per flash page
+*   \param  nb_nodes    Number of nodes to write
+*   \param  addresses   Where to write each node
+*   \param  lengths     Length of each node: BASE_NODE_SIZE for parent nodes, 2*BASE_NODE_SIZE for child nodes
+*   \param  nodes       Pointers to the nodes contents
+*   \return RETURN_OK if the nodes were written, RETURN_NOK if there were too many node slots to write
+*   \note   User permissions should be checked by the caller, as for the single node write functions
+*/
+RET_TYPE nodemgmt_write_node_blocks_to_flash(uint16_t nb_nodes, uint16_t* addresses, uint16_t* lengths, uint8_t** nodes)
+{
+    uint8_t* slot_contents[NODEMGMT_MAX_SLOTS_PER_BATCH_WRITE];
+    uint16_t slot_addresses[NODEMGMT_MAX_SLOTS_PER_BATCH_WRITE];
+    uint16_t slot_flags[NODEMGMT_MAX_SLOTS_PER_BATCH_WRITE];
+    BOOL slot_written[NODEMGMT_MAX_SLOTS_PER_BATCH_WRITE];
+    uint16_t nb_slots = 0;
+    
+    /* Enforce user ID and list the node slots to write */
+    for (uint16_t i = 0; i < nb_nodes; i++)
+    {
+        generic_node_t* node_pt = (generic_node_t*)nodes[i];
+        
+        if (lengths[i] == BASE_NODE_SIZE)
+        {
+            if (nb_slots + 1 > NODEMGMT_MAX_SLOTS_PER_BATCH_WRITE)
+            {
+                return RETURN_NOK;
+            }
+            nodemgmt_user_id_to_flags(&(node_pt->cred_parent.flags), nodemgmt_current_handle.currentUserId);
+            slot_flags[nb_slots] = node_pt->cred_parent.flags;
+            slot_contents[nb_slots] = nodes[i];
+            slot_addresses[nb_slots++] = addresses[i];
+        }
+        else if (lengths[i] == 2*BASE_NODE_SIZE)
+        {
+            if (nb_slots + 2 > NODEMGMT_MAX_SLOTS_PER_BATCH_WRITE)
+            {
+                return RETURN_NOK;
+            }
+            nodemgmt_user_id_to_flags(&(node_pt->cred_child.flags), nodemgmt_current_handle.currentUserId);
+            nodemgmt_user_id_to_flags(&(node_pt->cred_child.fakeFlags), nodemgmt_current_handle.currentUserId);
+            node_pt->cred_child.fakeFlags |= (NODEMGMT_VBIT_INVALID << NODEMGMT_CORRECT_FLAGS_BIT_BITSHIFT);
+            slot_flags[nb_slots] = node_pt->cred_child.flags;
+            slot_contents[nb_slots] = nodes[i];
+            slot_addresses[nb_slots++] = addresses[i];
+            slot_flags[nb_slots] = node_pt->cred_child.fakeFlags;
+            slot_contents[nb_slots] = &nodes[i][BASE_NODE_SIZE];
+            slot_addresses[nb_slots++] = nodemgmt_get_incremented_address(addresses[i]);
+        }
+        else
+        {
+            return RETURN_NOK;
+        }
+    }
+    
+    /* Check all addresses before writing anything */
+    for (uint16_t i = 0; i < nb_slots; i++)
+    {
+        nodemgmt_check_address_validity_and_lock(slot_addresses[i]);
+        slot_written[i] = FALSE;
+    }
+    
+    /* Group the slots by flash page */
+    for (uint16_t i = 0; i < nb_slots; i++)
+    {
+        uint16_t page_number = nodemgmt_page_from_address(slot_addresses[i]);
+        uint16_t page_nodes_bitmask = 0;
+        
+        if (slot_written[i] != FALSE)
+        {
+            continue;
+        }
+        
+        /* Which nodes of that page are we writing? */
+        for (uint16_t j = i; j < nb_slots; j++)
+        {
+            if (nodemgmt_page_from_address(slot_addresses[j]) == page_number)
+            {
+                page_nodes_bitmask |= (1 << nodemgmt_node_from_address(slot_addresses[j]));
+            }
+        }
+        
+        /* Cache write backs go through the flash internal buffer we're about to fill */
+        dbflash_flush_cache(&dbflash_descriptor);
+        
+        /* Only load the page contents if it isn't completely overwritten */
+        if (page_nodes_bitmask != ((1 << NODEMGMT_NODES_PER_PAGE) - 1))
+        {
+            dbflash_load_page_to_internal_buffer(&dbflash_descriptor, page_number);
+        }
+        
+        /* Fill the internal buffer, later slots for the same address take precedence */
+        for (uint16_t j = i; j < nb_slots; j++)
+        {
+            if (nodemgmt_page_from_address(slot_addresses[j]) == page_number)
+            {
+                dbflash_write_buffer(&dbflash_descriptor, slot_contents[j], BASE_NODE_SIZE * nodemgmt_node_from_address(slot_addresses[j]), BASE_NODE_SIZE);
+                nodemgmt_set_node_slot_usage(slot_addresses[j], slot_flags[j]);
+                slot_written[j] = TRUE;
+            }
+        }
+        
+        /* Single page program */
+        dbflash_flash_write_buffer_to_page(&dbflash_descriptor, page_number);
+    }
+    
+    return RETURN_OK;
 }
 
 /*! \fn     nodemgmt_read_parent_node_data_block_from_flash(uint16_t address, parent_node_t* parent_node)
@@ -1165,6 +1377,148 @@ uint16_t nodemgmt_check_for_logins_with_category_in_parent_node(uint16_t start_c
     return NODE_ADDR_NULL;
 }
 
+/*! \fn     nodemgmt_get_category_cache_position(uint16_t parent_addr)
+*   \brief  Binary search in the category cache
+*   \param  parent_addr     Parent node address
+*   \return Position of the first entry whose address is greater or equal to parent_addr
+*/
+static uint16_t nodemgmt_get_category_cache_position(uint16_t parent_addr)
+{
+    uint16_t upper_bound = nodemgmt_current_handle.categoryCacheNbEntries;
+    uint16_t lower_bound = 0;
+    
+    while (lower_bound < upper_bound)
+    {
+        uint16_t middle = (lower_bound + upper_bound) / 2;
+        
+        if (nodemgmt_current_handle.categoryCacheAddresses[middle] < parent_addr)
+        {
+            lower_bound = middle + 1;
+        }
+        else
+        {
+            upper_bound = middle;
+        }
+    }
+    
+    return lower_bound;
+}
+
+/*! \fn     nodemgmt_add_to_category_cache(uint16_t parent_addr)
+*   \brief  Add a credential parent to the category cache
+*   \param  parent_addr     Credential parent node address
+*/
+static void nodemgmt_add_to_category_cache(uint16_t parent_addr)
+{
+    /* Already there? */
+    uint16_t position = nodemgmt_get_category_cache_position(parent_addr);
+    if ((position < nodemgmt_current_handle.categoryCacheNbEntries) && (nodemgmt_current_handle.categoryCacheAddresses[position] == parent_addr))
+    {
+        return;
+    }
+    
+    /* Too many parents: give up on the cache */
+    if (nodemgmt_current_handle.categoryCacheNbEntries == ARRAY_SIZE(nodemgmt_current_handle.categoryCacheAddresses))
+    {
+        nodemgmt_current_handle.categoryCacheValid = FALSE;
+        return;
+    }
+    
+    memmove(&nodemgmt_current_handle.categoryCacheAddresses[position+1], &nodemgmt_current_handle.categoryCacheAddresses[position], (nodemgmt_current_handle.categoryCacheNbEntries - position) * sizeof(nodemgmt_current_handle.categoryCacheAddresses[0]));
+    nodemgmt_current_handle.categoryCacheAddresses[position] = parent_addr;
+    nodemgmt_current_handle.categoryCacheNbEntries++;
+}
+
+/*! \fn     nodemgmt_build_category_cache(uint16_t category_flags)
+*   \brief  Walk through the credential parents and their children to list the parents having children in a given category
+*   \param  category_flags  Category flags, non 0
+*   \note   On database inconsistency or if there are too many parents the cache is disabled and navigation goes back to walking the children lists
+*/
+static void nodemgmt_build_category_cache(uint16_t category_flags)
+{
+    uint16_t node_read_buffer[4];
+    uint16_t nb_nodes_read = 0;
+    
+    /* Same buffer to read parent & child flags and addresses */
+    _Static_assert(6 == offsetof(parent_cred_node_t, nextChildAddress), "Incorrect buffer for flags & addr read");
+    _Static_assert(4 == offsetof(parent_cred_node_t, nextParentAddress), "Incorrect buffer for flags & addr read");
+    _Static_assert(4 == offsetof(child_cred_node_t, nextChildAddress), "Incorrect buffer for flags & addr read");
+    _Static_assert(0 == offsetof(child_cred_node_t, flags), "Incorrect buffer for flags & addr read");
+    
+    nodemgmt_current_handle.categoryCacheFlags = category_flags;
+    nodemgmt_current_handle.categoryCacheNbEntries = 0;
+    nodemgmt_current_handle.categoryCacheValid = TRUE;
+    
+    for (uint16_t type_id = 0; type_id < MEMBER_ARRAY_SIZE(nodemgmtHandle_t, firstCredParentNodes); type_id++)
+    {
+        uint16_t next_parent_addr = nodemgmt_current_handle.firstCredParentNodes[type_id];
+        
+        while (next_parent_addr != NODE_ADDR_NULL)
+        {
+            // Read flags and addresses, check for database loops
+            if ((nodemgmt_check_address_validity(next_parent_addr) != RETURN_OK) || (nb_nodes_read++ >= NODEMGMT_NB_NODE_SLOTS))
+            {
+                nodemgmt_current_handle.categoryCacheValid = FALSE;
+                return;
+            }
+            dbflash_read_data_from_flash(&dbflash_descriptor, nodemgmt_page_from_address(next_parent_addr), BASE_NODE_SIZE*nodemgmt_node_from_address(next_parent_addr), sizeof(node_read_buffer), &node_read_buffer);
+            uint16_t parent_addr = next_parent_addr;
+            uint16_t next_child_addr = node_read_buffer[offsetof(parent_cred_node_t, nextChildAddress)/sizeof(uint16_t)];
+            next_parent_addr = node_read_buffer[offsetof(parent_cred_node_t, nextParentAddress)/sizeof(uint16_t)];
+            
+            // Stop at the first child in the category
+            while (next_child_addr != NODE_ADDR_NULL)
+            {
+                if ((nodemgmt_check_address_validity(next_child_addr) != RETURN_OK) || (nb_nodes_read++ >= NODEMGMT_NB_NODE_SLOTS))
+                {
+                    nodemgmt_current_handle.categoryCacheValid = FALSE;
+                    return;
+                }
+                dbflash_read_data_from_flash(&dbflash_descriptor, nodemgmt_page_from_address(next_child_addr), BASE_NODE_SIZE*nodemgmt_node_from_address(next_child_addr), sizeof(node_read_buffer), &node_read_buffer);
+                if (categoryFromFlags(node_read_buffer[offsetof(child_cred_node_t, flags)/sizeof(uint16_t)]) == category_flags)
+                {
+                    nodemgmt_add_to_category_cache(parent_addr);
+                    break;
+                }
+                next_child_addr = node_read_buffer[offsetof(child_cred_node_t, nextChildAddress)/sizeof(uint16_t)];
+            }
+            
+            // Cache may have been disabled
+            if (nodemgmt_current_handle.categoryCacheValid == FALSE)
+            {
+                return;
+            }
+        }
+    }
+}
+
+/*! \fn     nodemgmt_check_for_logins_with_cur_category_in_parent(uint16_t parent_addr, uint16_t first_child_addr)
+ *  \brief  See if a credential parent has children in the current category, using the category cache when possible
+ *  \param  parent_addr         Parent node address
+ *  \param  first_child_addr    Address of its first child, used when the cache can't be used
+ *  \return TRUE if so
+ *  \note   The category cache is built for the current category on first use
+ */
+static BOOL nodemgmt_check_for_logins_with_cur_category_in_parent(uint16_t parent_addr, uint16_t first_child_addr)
+{
+    /* No category selected: any child matches, only one read needed */
+    if (nodemgmt_current_handle.currentCategoryFlags != 0)
+    {
+        if (nodemgmt_current_handle.categoryCacheFlags != nodemgmt_current_handle.currentCategoryFlags)
+        {
+            nodemgmt_build_category_cache(nodemgmt_current_handle.currentCategoryFlags);
+        }
+        
+        if (nodemgmt_current_handle.categoryCacheValid != FALSE)
+        {
+            uint16_t position = nodemgmt_get_category_cache_position(parent_addr);
+            return ((position < nodemgmt_current_handle.categoryCacheNbEntries) && (nodemgmt_current_handle.categoryCacheAddresses[position] == parent_addr))? TRUE : FALSE;
+        }
+    }
+    
+    return (nodemgmt_check_for_logins_with_category_in_parent_node(first_child_addr, nodemgmt_current_handle.currentCategoryFlags) != NODE_ADDR_NULL)? TRUE : FALSE;
+}
+
 /*! \fn     nodemgmt_get_prev_parent_node_for_cur_category(uint16_t search_start_parent_addr, uint16_t credential_type_id)
  *  \brief  Gets the prev parent node for the current category
  *  \param  search_start_parent_addr    The parent address from which to start looking.
@@ -1205,7 +1559,7 @@ uint16_t nodemgmt_get_prev_parent_node_for_cur_category(uint16_t search_start_pa
         /* Check if the last node could work */
         nodemgmt_check_address_validity_and_lock(search_start_parent_addr);
         dbflash_read_data_from_flash(&dbflash_descriptor, nodemgmt_page_from_address(search_start_parent_addr), BASE_NODE_SIZE*nodemgmt_node_from_address(search_start_parent_addr), sizeof(parent_read_buffer), &parent_read_buffer);
-        if (nodemgmt_check_for_logins_with_category_in_parent_node(parent_node_pt->nextChildAddress, nodemgmt_current_handle.currentCategoryFlags) != NODE_ADDR_NULL)
+        if (nodemgmt_check_for_logins_with_cur_category_in_parent(search_start_parent_addr, parent_node_pt->nextChildAddress) != FALSE)
         {
                 return search_start_parent_addr;
         }
@@ -1224,7 +1578,7 @@ uint16_t nodemgmt_get_prev_parent_node_for_cur_category(uint16_t search_start_pa
         dbflash_read_data_from_flash(&dbflash_descriptor, nodemgmt_page_from_address(prev_parent_node_addr_to_scan), BASE_NODE_SIZE*nodemgmt_node_from_address(prev_parent_node_addr_to_scan), sizeof(parent_read_buffer), &parent_read_buffer);
 
         /* Check for logins with desired category */
-        if (nodemgmt_check_for_logins_with_category_in_parent_node(parent_node_pt->nextChildAddress, nodemgmt_current_handle.currentCategoryFlags) != NODE_ADDR_NULL)
+        if (nodemgmt_check_for_logins_with_cur_category_in_parent(prev_parent_node_addr_to_scan, parent_node_pt->nextChildAddress) != FALSE)
         {
             return prev_parent_node_addr_to_scan;
         }
@@ -1283,7 +1637,7 @@ uint16_t nodemgmt_get_next_parent_node_for_cur_category(uint16_t search_start_pa
         next_parent_node_addr_to_scan = parent_node_pt->nextParentAddress;
         
         /* Check that the provided parent node actually belongs to the current category.... */
-        if (nodemgmt_check_for_logins_with_category_in_parent_node(parent_node_pt->nextChildAddress, nodemgmt_current_handle.currentCategoryFlags) == NODE_ADDR_NULL)
+        if (nodemgmt_check_for_logins_with_cur_category_in_parent(search_start_parent_addr, parent_node_pt->nextChildAddress) == FALSE)
         {
             return NODE_ADDR_NULL;
         }
@@ -1303,7 +1657,7 @@ uint16_t nodemgmt_get_next_parent_node_for_cur_category(uint16_t search_start_pa
         dbflash_read_data_from_flash(&dbflash_descriptor, nodemgmt_page_from_address(next_parent_node_addr_to_scan), BASE_NODE_SIZE*nodemgmt_node_from_address(next_parent_node_addr_to_scan), sizeof(parent_read_buffer), &parent_read_buffer);
 
         /* Check for logins with desired category */
-        if (nodemgmt_check_for_logins_with_category_in_parent_node(parent_node_pt->nextChildAddress, nodemgmt_current_handle.currentCategoryFlags) != NODE_ADDR_NULL)
+        if (nodemgmt_check_for_logins_with_cur_category_in_parent(next_parent_node_addr_to_scan, parent_node_pt->nextChildAddress) != FALSE)
         {
             /* Check for single credential */
             if (next_parent_node_addr_to_scan == search_start_parent_addr)
@@ -1822,13 +2176,13 @@ void nodemgmt_set_category_string(uint16_t category_id, cust_char_t* string_pt)
 *   \param  startPage       Page where to start the scanning
 *   \param  startNode       Scan start node address inside the start page
 *   \return the number of nodes found
+*   \note   Uses the node usage bitmap built at login, doesn't access the flash
 */
 uint16_t nodemgmt_find_free_nodes(uint16_t nbParentNodes, uint16_t* parentNodeArray, uint16_t nbChildtNodes, uint16_t* childNodeArray, uint16_t startPage, uint16_t startNode)
 {
     uint16_t prevFreeAddressFound = NODE_ADDR_NULL;
     uint16_t nbParentNodesFound = 0;
     uint16_t nbChildNodesFound = 0;
-    uint16_t nodeFlags;
     uint16_t pageItr;
     uint16_t nodeItr;
     
@@ -1849,11 +2203,8 @@ uint16_t nodemgmt_find_free_nodes(uint16_t nbParentNodes, uint16_t* parentNodeAr
         // for each possible parent node in the page (changes per flash chip)
         for(nodeItr = startNode; nodeItr < BYTES_PER_PAGE/BASE_NODE_SIZE; nodeItr++)
         {
-            // read node flags (2 bytes - fixed size)
-            dbflash_read_data_from_flash(&dbflash_descriptor, pageItr, BASE_NODE_SIZE*nodeItr, sizeof(nodeFlags), &nodeFlags);
-            
             // If this slot is OK
-            if(validBitFromFlags(nodeFlags) == NODEMGMT_VBIT_INVALID)
+            if(nodemgmt_is_node_slot_taken(pageItr, nodeItr) == FALSE)
             {
                 // fill parent nodes first (only one block)
                 if (nbParentNodesFound != nbParentNodes)
@@ -1898,6 +2249,374 @@ uint16_t nodemgmt_find_free_nodes(uint16_t nbParentNodes, uint16_t* parentNodeAr
     return nbChildNodesFound+nbParentNodesFound;
 }
 
+/*! \fn     nodemgmt_get_service_index_key(cust_char_t* service)
+*   \brief  Get the service index key for a given service name
+*   \param  service     Service name
+*   \return The key, ordered like utils_custchar_strncmp would order the services
+*/
+static inline uint32_t nodemgmt_get_service_index_key(cust_char_t* service)
+{
+    if (service[0] == 0)
+    {
+        return 0;
+    }
+    else
+    {
+        return ((uint32_t)service[0] << 16) | service[1];
+    }
+}
+
+/*! \fn     nodemgmt_get_service_index_list_id(BOOL data_parent, uint16_t type_id)
+*   \brief  Get the service index list ID for a given parent type
+*   \param  data_parent     TRUE for data parents
+*   \param  type_id         Credential / Data type ID
+*   \return The list ID
+*/
+static inline uint16_t nodemgmt_get_service_index_list_id(BOOL data_parent, uint16_t type_id)
+{
+    if (data_parent == FALSE)
+    {
+        return type_id;
+    }
+    else
+    {
+        return MEMBER_ARRAY_SIZE(nodemgmtHandle_t, firstCredParentNodes) + type_id;
+    }
+}
+
+/*! \fn     nodemgmt_is_short_mult_domain_parent(uint16_t list_id, uint16_t flags, cust_char_t* service)
+*   \brief  Check if a parent is a multiple domain credential parent with a service shorter than the index key
+*   \param  list_id     List ID
+*   \param  flags       Parent node flags
+*   \param  service     Parent node service
+*   \return TRUE if so
+*/
+static inline BOOL nodemgmt_is_short_mult_domain_parent(uint16_t list_id, uint16_t flags, cust_char_t* service)
+{
+    if ((list_id < MEMBER_ARRAY_SIZE(nodemgmtHandle_t, firstCredParentNodes)) && ((flags & NODEMGMT_MULT_DOMAIN_FLAG) != 0) && ((service[0] == 0) || (service[1] == 0)))
+    {
+        return TRUE;
+    }
+    else
+    {
+        return FALSE;
+    }
+}
+
+/*! \fn     nodemgmt_get_service_index_position(uint16_t list_id, uint32_t key)
+*   \brief  Binary search in the service index
+*   \param  list_id     List ID
+*   \param  key         Service key
+*   \return Position of the first entry that is greater or equal to (list_id, key)
+*/
+static uint16_t nodemgmt_get_service_index_position(uint16_t list_id, uint32_t key)
+{
+    uint16_t upper_bound = nodemgmt_current_handle.serviceIndexNbEntries;
+    uint16_t lower_bound = 0;
+    
+    while (lower_bound < upper_bound)
+    {
+        uint16_t middle = (lower_bound + upper_bound) / 2;
+        nodemgmt_service_index_entry_t* entry_pt = &nodemgmt_current_handle.serviceIndex[middle];
+        
+        if ((entry_pt->list_id < list_id) || ((entry_pt->list_id == list_id) && (entry_pt->key < key)))
+        {
+            lower_bound = middle + 1;
+        }
+        else
+        {
+            upper_bound = middle;
+        }
+    }
+    
+    return lower_bound;
+}
+
+/*! \fn     nodemgmt_decimate_service_index(void)
+*   \brief  Remove one sampled entry out of two in each list of the service index
+*   \note   Heads of lists and short multiple domain services are always kept
+*/
+static void nodemgmt_decimate_service_index(void)
+{
+    uint16_t nb_sampled_in_list = 0;
+    uint16_t current_list_id = UINT16_MAX;
+    uint16_t nb_kept_entries = 0;
+    
+    for (uint16_t i = 0; i < nodemgmt_current_handle.serviceIndexNbEntries; i++)
+    {
+        nodemgmt_service_index_entry_t* entry_pt = &nodemgmt_current_handle.serviceIndex[i];
+        BOOL keep_entry = FALSE;
+        
+        /* New list? */
+        if (entry_pt->list_id != current_list_id)
+        {
+            current_list_id = entry_pt->list_id;
+            nb_sampled_in_list = 0;
+        }
+        
+        if ((entry_pt->flags & NODEMGMT_SERVICE_INDEX_SHORT_MULT_DOM) != 0)
+        {
+            keep_entry = TRUE;
+        }
+        else
+        {
+            keep_entry = ((nb_sampled_in_list++ & 0x01) == 0)? TRUE : FALSE;
+        }
+        
+        if (keep_entry != FALSE)
+        {
+            nodemgmt_current_handle.serviceIndex[nb_kept_entries++] = *entry_pt;
+        }
+    }
+    
+    /* Nothing could be removed: give up on the index */
+    if (nb_kept_entries == nodemgmt_current_handle.serviceIndexNbEntries)
+    {
+        nodemgmt_current_handle.serviceIndexValid = FALSE;
+    }
+    
+    nodemgmt_current_handle.serviceIndexNbEntries = nb_kept_entries;
+    nodemgmt_current_handle.serviceIndexSampling *= 2;
+}
+
+/*! \fn     nodemgmt_add_to_service_index(uint16_t list_id, uint16_t address, uint16_t flags, cust_char_t* service)
+*   \brief  Add a parent node to the service index
+*   \param  list_id     List ID
+*   \param  address     Parent node address
+*   \param  flags       Parent node flags
+*   \param  service     Parent node service, at least 2 characters long
+*/
+static void nodemgmt_add_to_service_index(uint16_t list_id, uint16_t address, uint16_t flags, cust_char_t* service)
+{
+    uint32_t key = nodemgmt_get_service_index_key(service);
+    uint8_t entry_flags = 0;
+    
+    if (nodemgmt_current_handle.serviceIndexValid == FALSE)
+    {
+        return;
+    }
+    
+    /* Multiple domain services shorter than the key: the search walk may have to start before the key position for them */
+    if (nodemgmt_is_short_mult_domain_parent(list_id, flags, service) != FALSE)
+    {
+        entry_flags |= NODEMGMT_SERVICE_INDEX_SHORT_MULT_DOM;
+    }
+    
+    /* Make room if needed */
+    if (nodemgmt_current_handle.serviceIndexNbEntries == ARRAY_SIZE(nodemgmt_current_handle.serviceIndex))
+    {
+        nodemgmt_decimate_service_index();
+        
+        if (nodemgmt_current_handle.serviceIndexValid == FALSE)
+        {
+            return;
+        }
+    }
+    
+    /* Insert after the entries having the same key: services are unique, ordering between them doesn't matter */
+    uint16_t position = nodemgmt_get_service_index_position(list_id, key);
+    while ((position < nodemgmt_current_handle.serviceIndexNbEntries) && (nodemgmt_current_handle.serviceIndex[position].list_id == list_id) && (nodemgmt_current_handle.serviceIndex[position].key == key))
+    {
+        position++;
+    }
+    memmove(&nodemgmt_current_handle.serviceIndex[position+1], &nodemgmt_current_handle.serviceIndex[position], (nodemgmt_current_handle.serviceIndexNbEntries - position) * sizeof(nodemgmt_current_handle.serviceIndex[0]));
+    nodemgmt_current_handle.serviceIndex[position].key = key;
+    nodemgmt_current_handle.serviceIndex[position].address = address;
+    nodemgmt_current_handle.serviceIndex[position].list_id = (uint8_t)list_id;
+    nodemgmt_current_handle.serviceIndex[position].flags = entry_flags;
+    nodemgmt_current_handle.serviceIndexNbEntries++;
+}
+
+/*! \fn     nodemgmt_remove_from_service_index(uint16_t address)
+*   \brief  Remove a parent node from the service index
+*   \param  address     Parent node address
+*/
+static void nodemgmt_remove_from_service_index(uint16_t address)
+{
+    for (uint16_t i = 0; i < nodemgmt_current_handle.serviceIndexNbEntries; i++)
+    {
+        if (nodemgmt_current_handle.serviceIndex[i].address == address)
+        {
+            memmove(&nodemgmt_current_handle.serviceIndex[i], &nodemgmt_current_handle.serviceIndex[i+1], (nodemgmt_current_handle.serviceIndexNbEntries - i - 1) * sizeof(nodemgmt_current_handle.serviceIndex[0]));
+            nodemgmt_current_handle.serviceIndexNbEntries--;
+            return;
+        }
+    }
+}
+
+/*! \fn     nodemgmt_read_parent_node_start(uint16_t address, parent_node_start_t* node_start)
+*   \brief  Read the flags, addresses and first two service characters of a parent node
+*   \param  address     Parent node address
+*   \param  node_start  Where to store the node start
+*   \return RETURN_OK if the address is valid and the node belongs to the current user
+*/
+static RET_TYPE nodemgmt_read_parent_node_start(uint16_t address, parent_node_start_t* node_start)
+{
+    _Static_assert(sizeof(parent_node_start_t) == offsetof(parent_cred_node_t, service) + 2*sizeof(cust_char_t), "Incorrect parent node start structure");
+    _Static_assert(offsetof(parent_node_start_t, service) == offsetof(parent_cred_node_t, service), "Incorrect parent node start structure");
+    _Static_assert(offsetof(parent_node_start_t, nextParentAddress) == offsetof(parent_cred_node_t, nextParentAddress), "Incorrect parent node start structure");
+    _Static_assert(offsetof(parent_cred_node_t, service) == offsetof(parent_data_node_t, service), "Incorrect reuse of parent node structure");
+    _Static_assert(offsetof(parent_cred_node_t, nextParentAddress) == offsetof(parent_data_node_t, nextParentAddress), "Incorrect reuse of parent node structure");
+    
+    if (nodemgmt_check_address_validity(address) != RETURN_OK)
+    {
+        return RETURN_NOK;
+    }
+    
+    dbflash_read_data_from_flash(&dbflash_descriptor, nodemgmt_page_from_address(address), BASE_NODE_SIZE*nodemgmt_node_from_address(address), sizeof(parent_node_start_t), node_start);
+    
+    /* Check ownership, validity and node type */
+    if ((nodemgmt_check_user_perm_from_flags(node_start->flags) != RETURN_OK) || ((nodeTypeFromFlags(node_start->flags) != NODE_TYPE_PARENT) && (nodeTypeFromFlags(node_start->flags) != NODE_TYPE_PARENT_DATA)))
+    {
+        return RETURN_NOK;
+    }
+    
+    return RETURN_OK;
+}
+
+/*! \fn     nodemgmt_build_service_index(void)
+*   \brief  Walk through all the parent lists to build the service index
+*   \note   On database inconsistency the index is disabled and searches go back to walking the full lists
+*/
+static void nodemgmt_build_service_index(void)
+{
+    parent_node_start_t parent_node_start;
+    _Static_assert(MEMBER_ARRAY_SIZE(nodemgmtHandle_t, firstCredParentNodes) + MEMBER_ARRAY_SIZE(nodemgmtHandle_t, firstDataParentNodes) <= UINT8_MAX, "Service index list ID doesn't fit in uint8_t");
+    
+    nodemgmt_current_handle.serviceIndexNbEntries = 0;
+    nodemgmt_current_handle.serviceIndexSampling = 1;
+    nodemgmt_current_handle.serviceIndexValid = TRUE;
+    
+    for (uint16_t list_id = 0; list_id < MEMBER_ARRAY_SIZE(nodemgmtHandle_t, firstCredParentNodes) + MEMBER_ARRAY_SIZE(nodemgmtHandle_t, firstDataParentNodes); list_id++)
+    {
+        uint16_t next_parent_addr;
+        uint32_t last_key = 0;
+        uint16_t nb_parents = 0;
+        
+        // Get the list head
+        if (list_id < MEMBER_ARRAY_SIZE(nodemgmtHandle_t, firstCredParentNodes))
+        {
+            next_parent_addr = nodemgmt_current_handle.firstCredParentNodes[list_id];
+        }
+        else
+        {
+            next_parent_addr = nodemgmt_current_handle.firstDataParentNodes[list_id - MEMBER_ARRAY_SIZE(nodemgmtHandle_t, firstCredParentNodes)];
+        }
+        
+        while (next_parent_addr != NODE_ADDR_NULL)
+        {
+            // Read start of the node, check for database loops
+            if ((nodemgmt_read_parent_node_start(next_parent_addr, &parent_node_start) != RETURN_OK) || (nodemgmt_get_service_index_key(parent_node_start.service) < last_key) || (nb_parents >= NODEMGMT_NB_NODE_SLOTS))
+            {
+                nodemgmt_current_handle.serviceIndexValid = FALSE;
+                return;
+            }
+            last_key = nodemgmt_get_service_index_key(parent_node_start.service);
+            
+            // Sample parent, short multiple domain parents are always stored
+            if (((nb_parents++ % nodemgmt_current_handle.serviceIndexSampling) == 0) || (nodemgmt_is_short_mult_domain_parent(list_id, parent_node_start.flags, parent_node_start.service) != FALSE))
+            {
+                nodemgmt_add_to_service_index(list_id, next_parent_addr, parent_node_start.flags, parent_node_start.service);
+            }
+            
+            // Index may have been disabled
+            if (nodemgmt_current_handle.serviceIndexValid == FALSE)
+            {
+                return;
+            }
+            
+            next_parent_addr = parent_node_start.nextParentAddress;
+        }
+    }
+}
+
+/*! \fn     nodemgmt_invalidate_service_index(void)
+*   \brief  Stop using the service index until it is rebuilt
+*   \note   To be called when the parent lists are externally modified (management mode)
+*/
+void nodemgmt_invalidate_service_index(void)
+{
+    nodemgmt_current_handle.serviceIndexValid = FALSE;
+}
+
+/*! \fn     nodemgmt_invalidate_category_cache(void)
+*   \brief  Have the category cache rebuilt on its next use
+*   \note   To be called when nodes are externally modified (management mode)
+*/
+void nodemgmt_invalidate_category_cache(void)
+{
+    nodemgmt_current_handle.categoryCacheFlags = 0;
+    
+    /* The first letter index is built from the same parent lists */
+    logic_database_invalidate_fletter_index();
+}
+
+/*! \fn     nodemgmt_get_node_slots_change_counter(void)
+*   \brief  Get the node slots change counter
+*   \return Counter incremented every time a node is created or deleted, or when the database may have been changed by other means
+*   \note   Allows caches built from a given parent children list to check that they are still up to date
+*/
+uint16_t nodemgmt_get_node_slots_change_counter(void)
+{
+    return nodemgmt_current_handle.nodeSlotsChangeCounter;
+}
+
+/*! \fn     nodemgmt_get_service_index_start_addr(cust_char_t* name, BOOL data_parent, uint16_t type_id, BOOL mult_domain_possible)
+*   \brief  Use the service index to find where a sorted parent list walk looking for a service can start
+*   \param  name                    Service name
+*   \param  data_parent             TRUE for data parents
+*   \param  type_id                 Credential / Data type ID
+*   \param  mult_domain_possible    TRUE if multiple domain parents may match the service name
+*   \return Address of a parent node whose service is before name, NODE_ADDR_NULL to start from the list head
+*   \note   The returned node ownership & key are checked with a short read
+*/
+uint16_t nodemgmt_get_service_index_start_addr(cust_char_t* name, BOOL data_parent, uint16_t type_id, BOOL mult_domain_possible)
+{
+    parent_node_start_t parent_node_start;
+    
+    /* Boundary checks */
+    if (((data_parent == FALSE) && (type_id >= MEMBER_ARRAY_SIZE(nodemgmtHandle_t, firstCredParentNodes))) || ((data_parent != FALSE) && (type_id >= MEMBER_ARRAY_SIZE(nodemgmtHandle_t, firstDataParentNodes))))
+    {
+        return NODE_ADDR_NULL;
+    }
+    
+    if (nodemgmt_current_handle.serviceIndexValid == FALSE)
+    {
+        return NODE_ADDR_NULL;
+    }
+    
+    /* Find the last indexed parent whose key is strictly lower than the name key */
+    uint16_t list_id = nodemgmt_get_service_index_list_id(data_parent, type_id);
+    uint16_t position = nodemgmt_get_service_index_position(list_id, nodemgmt_get_service_index_key(name));
+    if ((position == 0) || (nodemgmt_current_handle.serviceIndex[position-1].list_id != list_id))
+    {
+        return NODE_ADDR_NULL;
+    }
+    position--;
+    
+    /* Multiple domain parents with a service shorter than the key sort before the name but may still match it */
+    if (mult_domain_possible != FALSE)
+    {
+        for (int16_t i = position; (i >= 0) && (nodemgmt_current_handle.serviceIndex[i].list_id == list_id); i--)
+        {
+            if (((nodemgmt_current_handle.serviceIndex[i].flags & NODEMGMT_SERVICE_INDEX_SHORT_MULT_DOM) != 0) && ((nodemgmt_current_handle.serviceIndex[i].key == 0) || ((nodemgmt_current_handle.serviceIndex[i].key >> 16) == name[0])))
+            {
+                position = i;
+            }
+        }
+    }
+    
+    /* Confirm the index is in line with what is stored in flash */
+    uint16_t start_addr = nodemgmt_current_handle.serviceIndex[position].address;
+    if ((nodemgmt_read_parent_node_start(start_addr, &parent_node_start) != RETURN_OK) || (nodemgmt_get_service_index_key(parent_node_start.service) != nodemgmt_current_handle.serviceIndex[position].key))
+    {
+        nodemgmt_current_handle.serviceIndexValid = FALSE;
+        return NODE_ADDR_NULL;
+    }
+    
+    return start_addr;
+}
+
 /*! \fn     nodemgmt_trigger_db_ext_changed_actions(void)
 *   \brief  Function called to perform actions needed when db was externally changed
 */
@@ -1905,6 +2624,15 @@ void nodemgmt_trigger_db_ext_changed_actions(void)
 {
     // Scan last parent nodes
     nodemgmt_scan_for_last_parent_nodes();
+    
+    // Parent lists may have changed, rebuild service index
+    nodemgmt_build_service_index();
+    
+    // Children and their categories may have changed as well
+    nodemgmt_invalidate_category_cache();
+    
+    // Any node may have changed
+    nodemgmt_current_handle.nodeSlotsChangeCounter++;
 }
 
 /*! \fn     nodemgmt_scan_node_usage(void)
@@ -2223,6 +2951,16 @@ void nodemgmt_init_context(uint16_t userIdNum, uint16_t* userSecFlags, uint16_t*
     // Scan for last parent nodes
     nodemgmt_scan_for_last_parent_nodes();
     
+    // Build node usage bitmap, only time we scan all the node flags in flash
+    nodemgmt_build_node_usage_bitmap();
+    nodemgmt_current_handle.nodeSlotsChangeCounter++;
+    
+    // Build service index
+    nodemgmt_build_service_index();
+    
+    // Category cache for category filtered navigation is built on first use
+    nodemgmt_invalidate_category_cache();
+    
     // scan for next free parent and child nodes from the start of the memory
     nodemgmt_scan_node_usage();
     
@@ -2325,7 +3063,8 @@ void nodemgmt_delete_data_parent_and_its_children(uint16_t parent_address, uint1
     }
     
     // Delete parent data block
-    dbflash_write_data_pattern_to_flash(&dbflash_descriptor, nodemgmt_page_from_address(parent_address), BASE_NODE_SIZE * nodemgmt_node_from_address(parent_address), BASE_NODE_SIZE, 0xFF);
+    nodemgmt_erase_node_slot(parent_address);
+    nodemgmt_remove_from_service_index(parent_address);
     
     // Delete the children (evil laugh)
     nodemgmt_delete_children_list(first_child_address, TRUE);
@@ -2366,8 +3105,8 @@ void nodemgmt_delete_children_list(uint16_t first_children_addr, BOOL data_child
         }
         
         // Delete child data block
-        dbflash_write_data_pattern_to_flash(&dbflash_descriptor, nodemgmt_page_from_address(next_child_addr), BASE_NODE_SIZE * nodemgmt_node_from_address(next_child_addr), BASE_NODE_SIZE, 0xFF);
-        dbflash_write_data_pattern_to_flash(&dbflash_descriptor, nodemgmt_page_from_address(nodemgmt_get_incremented_address(next_child_addr)), BASE_NODE_SIZE * nodemgmt_node_from_address(nodemgmt_get_incremented_address(next_child_addr)), BASE_NODE_SIZE, 0xFF);
+        nodemgmt_erase_node_slot(next_child_addr);
+        nodemgmt_erase_node_slot(nodemgmt_get_incremented_address(next_child_addr));
         
         // Set correct next address
         next_child_addr = temp_address;
@@ -2396,6 +3135,10 @@ void nodemgmt_delete_current_user_from_flash(void)
     // Delete user profile memory
     nodemgmt_format_user_profile(nodemgmt_current_handle.currentUserId, 0, 0, 0, 0);
     
+    // Empty service index & category cache
+    nodemgmt_current_handle.serviceIndexNbEntries = 0;
+    nodemgmt_current_handle.categoryCacheNbEntries = 0;
+    
     // Then browse through all the credentials to delete them
     for (uint16_t i = 0; i < MEMBER_ARRAY_SIZE(nodemgmtHandle_t, firstCredParentNodes) + MEMBER_ARRAY_SIZE(nodemgmtHandle_t, firstDataParentNodes); i++)
     {
@@ -2423,7 +3166,7 @@ void nodemgmt_delete_current_user_from_flash(void)
             temp_address = parent_node_pt->nextParentAddress;
             
             // Delete parent data block
-            dbflash_write_data_pattern_to_flash(&dbflash_descriptor, nodemgmt_page_from_address(next_parent_addr), BASE_NODE_SIZE * nodemgmt_node_from_address(next_parent_addr), BASE_NODE_SIZE, 0xFF);
+            nodemgmt_erase_node_slot(next_parent_addr);
             
             // Set correct next address
             next_parent_addr = temp_address;
@@ -2602,11 +3345,12 @@ RET_TYPE nodemgmt_store_data_node(child_data_node_t* node, uint16_t* storedAddre
     return RETURN_OK;
 }
 
-/*! \fn     nodemgmt_create_generic_node(generic_node_t* g, node_type_te node_type, uint16_t firstNodeAddress, uint16_t* newFirstNodeAddress, uint16_t* storedAddress, uint16_t* newLastNodeAddress)
+/*! \fn     nodemgmt_create_generic_node(generic_node_t* g, node_type_te node_type, uint16_t firstNodeAddress, uint16_t walkStartAddress, uint16_t* newFirstNodeAddress, uint16_t* storedAddress, uint16_t* newLastNodeAddress)
  *  \brief  Writes a generic node to memory (next free via handle) (in alphabetical order)
  *  \param  g                       The node to write to memory (nextFreeParentNode)
  *  \param  node_type               The node type (see enum)
  *  \param  firstNodeAddress        Address of the first node of its kind
+ *  \param  walkStartAddress        Address of a node sorted before g from which the list walk can start, NODE_ADDR_NULL to start from firstNodeAddress
  *  \param  newFirstNodeAddress     If the firstNodeAddress changed, this var will store the new value
  *  \param  storedAddress           Where to store the address at which the node was stored
  *  \param  newLastNodeAddress     If the lastNodeAddress changed, this var will store the new value
@@ -2614,7 +3358,7 @@ RET_TYPE nodemgmt_store_data_node(child_data_node_t* node, uint16_t* storedAddre
  *  \note   Handles necessary doubly linked list management
  *  \note   Not called for child data node
  */
-RET_TYPE nodemgmt_create_generic_node(generic_node_t* g, node_type_te node_type, uint16_t firstNodeAddress, uint16_t* newFirstNodeAddress, uint16_t* storedAddress, uint16_t* newLastNodeAddress)
+RET_TYPE nodemgmt_create_generic_node(generic_node_t* g, node_type_te node_type, uint16_t firstNodeAddress, uint16_t walkStartAddress, uint16_t* newFirstNodeAddress, uint16_t* storedAddress, uint16_t* newLastNodeAddress)
 {
     /* Sanity checks */
     _Static_assert(offsetof(parent_cred_node_t, prevParentAddress) == offsetof(parent_data_node_t, prevParentAddress), "Next / Prev fields do not match across parent & child nodes");
@@ -2703,8 +3447,15 @@ RET_TYPE nodemgmt_create_generic_node(generic_node_t* g, node_type_te node_type,
     }
     else
     {        
-        // set first node address
-        addr = firstNodeAddress;
+        // set first node address, or closer node if provided
+        if (walkStartAddress != NODE_ADDR_NULL)
+        {
+            addr = walkStartAddress;
+        }
+        else
+        {
+            addr = firstNodeAddress;
+        }
         while(addr != NODE_ADDR_NULL)
         {
             // read node: use read parent node function as all the fields always are in the first 264B
@@ -2828,7 +3579,7 @@ RET_TYPE nodemgmt_create_generic_node(generic_node_t* g, node_type_te node_type,
  */
 RET_TYPE nodemgmt_create_parent_node(parent_node_t* p, service_type_te type, uint16_t* storedAddress, uint16_t typeId)
 {
-    uint16_t first_parent_addr, last_parent_addr, potential_new_fparent, potential_new_lparent;
+    uint16_t first_parent_addr, last_parent_addr, potential_new_fparent, potential_new_lparent, walk_start_addr;
     RET_TYPE temprettype;
     
     // Set the first parent address depending on the type
@@ -2856,14 +3607,17 @@ RET_TYPE nodemgmt_create_parent_node(parent_node_t* p, service_type_te type, uin
     // This is particular to parent nodes...
     p->cred_parent.nextChildAddress = NODE_ADDR_NULL;
     
+    // Use the service index to skip the parents sorted before the new one
+    walk_start_addr = nodemgmt_get_service_index_start_addr(p->cred_parent.service, (type == SERVICE_CRED_TYPE)? FALSE : TRUE, typeId, FALSE);
+    
     // Call nodemgmt_create_generic_node to add a node
     if (type == SERVICE_CRED_TYPE)
     {
-        temprettype = nodemgmt_create_generic_node((generic_node_t*)p, NODE_TYPE_PARENT, first_parent_addr, &potential_new_fparent, storedAddress, &potential_new_lparent);
+        temprettype = nodemgmt_create_generic_node((generic_node_t*)p, NODE_TYPE_PARENT, first_parent_addr, walk_start_addr, &potential_new_fparent, storedAddress, &potential_new_lparent);
     }
     else
     {
-        temprettype = nodemgmt_create_generic_node((generic_node_t*)p, NODE_TYPE_PARENT_DATA, first_parent_addr, &potential_new_fparent, storedAddress, &potential_new_lparent);
+        temprettype = nodemgmt_create_generic_node((generic_node_t*)p, NODE_TYPE_PARENT_DATA, first_parent_addr, walk_start_addr, &potential_new_fparent, storedAddress, &potential_new_lparent);
     }
     
     // If the return is ok & we changed the first node address
@@ -2879,6 +3633,12 @@ RET_TYPE nodemgmt_create_parent_node(parent_node_t* p, service_type_te type, uin
         }
     }
     
+    // If the return is ok, add the new parent to the service index
+    if (temprettype == RETURN_OK)
+    {
+        nodemgmt_add_to_service_index(nodemgmt_get_service_index_list_id((type == SERVICE_CRED_TYPE)? FALSE : TRUE, typeId), *storedAddress, p->cred_parent.flags, p->cred_parent.service);
+    }
+    
     // If the return is ok & we changed the last node address
     if ((temprettype == RETURN_OK) && (last_parent_addr != potential_new_lparent) && (potential_new_lparent != NODE_ADDR_NULL))
     {
@@ -2917,7 +3677,7 @@ RET_TYPE nodemgmt_create_child_node(uint16_t pAddr, child_cred_node_t* c, uint16
     childFirstAddress = nodemgmt_current_handle.temp_parent_node.cred_parent.nextChildAddress;
     
     // Call nodemgmt_create_generic_node to add a node
-    temprettype = nodemgmt_create_generic_node((generic_node_t*)c, NODE_TYPE_CHILD, childFirstAddress, &temp_address, storedAddress, &temp_address2);
+    temprettype = nodemgmt_create_generic_node((generic_node_t*)c, NODE_TYPE_CHILD, childFirstAddress, NODE_ADDR_NULL, &temp_address, storedAddress, &temp_address2);
     
     // If the return is ok & we changed the first child address
     if ((temprettype == RETURN_OK) && (childFirstAddress != temp_address))
@@ -2927,5 +3687,11 @@ RET_TYPE nodemgmt_create_child_node(uint16_t pAddr, child_cred_node_t* c, uint16
         nodemgmt_write_parent_node_data_block_to_flash(pAddr, &nodemgmt_current_handle.temp_parent_node);
     }
     
+    // Child was written with the current category
+    if ((temprettype == RETURN_OK) && (nodemgmt_current_handle.currentCategoryFlags != 0) && (nodemgmt_current_handle.categoryCacheFlags == nodemgmt_current_handle.currentCategoryFlags) && (nodemgmt_current_handle.categoryCacheValid != FALSE))
+    {
+        nodemgmt_add_to_category_cache(pAddr);
+    }
+    
     return temprettype;
 }  
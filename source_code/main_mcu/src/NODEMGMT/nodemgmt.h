@@ -71,6 +71,13 @@ typedef enum    {NODE_TYPE_PARENT = 0, NODE_TYPE_CHILD = 1, NODE_TYPE_PARENT_DAT
 #define NODEMGMT_CAT_MASK_FINAL                     0x000F
 #define NODEMGMT_CAT_MASK                           0x000F
 #define NODEMGMT_CAT_BITSHIFT                       0
+#define NODEMGMT_NODES_PER_PAGE                     (BYTES_PER_PAGE/BASE_NODE_SIZE)
+#define NODEMGMT_NB_NODE_SLOTS                      ((PAGE_COUNT-PAGE_PER_SECTOR)*NODEMGMT_NODES_PER_PAGE)
+#define NODEMGMT_NODE_USAGE_BITMAP_SIZE             ((NODEMGMT_NB_NODE_SLOTS+7)/8)
+#define NODEMGMT_SERVICE_INDEX_SIZE                 128
+#define NODEMGMT_SERVICE_INDEX_SHORT_MULT_DOM       0x01
+#define NODEMGMT_CATEGORY_CACHE_SIZE                128
+#define NODEMGMT_MAX_SLOTS_PER_BATCH_WRITE          4
 
 /* User security settings flags */
 #define USER_SEC_FLG_LOGIN_CONF             0x01
@@ -133,6 +140,16 @@ typedef struct
     uint8_t startDataCtr[3];                    // Encryption counter
 } parent_data_node_t;
 
+// First bytes of a parent node (credential or data), used for short reads
+typedef struct
+{
+    uint16_t flags;
+    uint16_t prevParentAddress;                 // Previous parent node address (Alphabetically)
+    uint16_t nextParentAddress;                 // Next parent node address (Alphabetically)
+    uint16_t nextChildAddress;                  // Parent node first child address
+    cust_char_t service[2];                     // First two service characters
+} parent_node_start_t;
+
 // Child data node, see: https://mooltipass.github.io/minible/database_model
 typedef struct
 {
@@ -331,6 +348,15 @@ typedef struct
     cust_char_t category_strings[4][33];
 } nodemgmt_user_category_strings_t;
 
+// Service index entry: sampled parent node, sorted by list then service prefix
+typedef struct
+{
+    uint32_t key;                           // First two service characters, see nodemgmt_get_service_index_key()
+    uint16_t address;                       // Parent node address
+    uint8_t list_id;                        // Credential type ID, or number of credential types + data type ID
+    uint8_t flags;                          // NODEMGMT_SERVICE_INDEX_xxx flags
+} nodemgmt_service_index_entry_t;
+
 // Node management handle
 typedef struct
 {
@@ -350,6 +376,16 @@ typedef struct
     uint16_t currentCategoryFlags;          // Current category flags
     uint16_t lastCredParentNodes[10];       // The address of the users last cred parent node (read from flash. eg cache)
     uint16_t lastDataParentNodes[7];        // The addresses of the users last data parent nodes (read from flash. eg cache)
+    uint8_t nodeUsageBitmap[NODEMGMT_NODE_USAGE_BITMAP_SIZE];   // One bit per node slot, set when the slot is taken (built at login, updated on writes)
+    BOOL serviceIndexValid;                 // Boolean to indicate if the service index below can be used
+    uint16_t serviceIndexNbEntries;         // Number of entries in the service index
+    uint16_t serviceIndexSampling;          // One parent node out of serviceIndexSampling is stored in the service index
+    nodemgmt_service_index_entry_t serviceIndex[NODEMGMT_SERVICE_INDEX_SIZE];   // Service index (built at login, updated on parent creation & deletion)
+    uint16_t nodeSlotsChangeCounter;        // Incremented when a node slot is taken or freed, at login and when the DB was externally changed
+    uint16_t categoryCacheFlags;            // Category flags the category cache below was built for, 0 when it needs to be rebuilt
+    BOOL categoryCacheValid;                // Boolean to indicate if the category cache below can be used (no overflow or database inconsistency)
+    uint16_t categoryCacheNbEntries;        // Number of credential parents in the category cache
+    uint16_t categoryCacheAddresses[NODEMGMT_CATEGORY_CACHE_SIZE];  // Addresses of the credential parents having children in the category, sorted (built on first use, updated on child creation)
 } nodemgmtHandle_t;
 
 /* Inlines */
@@ -425,12 +461,14 @@ static inline node_type_te nodeTypeFromFlags(uint16_t flags)
 }
 
 /* Prototypes */
-RET_TYPE nodemgmt_create_generic_node(generic_node_t* g, node_type_te node_type, uint16_t firstNodeAddress, uint16_t* newFirstNodeAddress, uint16_t* storedAddress, uint16_t* newLastNodeAddress);
+RET_TYPE nodemgmt_create_generic_node(generic_node_t* g, node_type_te node_type, uint16_t firstNodeAddress, uint16_t walkStartAddress, uint16_t* newFirstNodeAddress, uint16_t* storedAddress, uint16_t* newLastNodeAddress);
 void nodemgmt_get_prev_favorite_and_category_index(int16_t category_index, int16_t favorite_index, int16_t* new_cat_index, int16_t* new_fav_index, BOOL navigate_across_categories);
 void nodemgmt_get_next_favorite_and_category_index(int16_t category_index, int16_t favorite_index, int16_t* new_cat_index, int16_t* new_fav_index, BOOL navigate_across_categories);
 RET_TYPE nodemgmt_get_bluetooth_bonding_information_for_mac_addr(uint8_t address_resolv_type, uint8_t* mac_address, nodemgmt_bluetooth_bonding_information_t* bonding_information);
 uint16_t nodemgmt_find_free_nodes(uint16_t nbParentNodes, uint16_t* parentNodeArray, uint16_t nbChildtNodes, uint16_t* childNodeArray, uint16_t startPage, uint16_t startNode);
 void nodemgmt_read_webauthn_child_node_except_display_name(uint16_t address, child_webauthn_node_t* child_node, BOOL update_date_and_increment_preinc_count);
+RET_TYPE nodemgmt_write_node_blocks_to_flash(uint16_t nb_nodes, uint16_t* addresses, uint16_t* lengths, uint8_t** nodes);
+uint16_t nodemgmt_get_service_index_start_addr(cust_char_t* name, BOOL data_parent, uint16_t type_id, BOOL mult_domain_possible);
 void nodemgmt_init_context(uint16_t userIdNum, uint16_t* userSecFlags, uint16_t* userLanguage, uint16_t* userLayout, uint16_t* userBLELayout);
 RET_TYPE nodemgmt_get_bluetooth_bonding_information_for_irk(uint8_t* irk_key, nodemgmt_bluetooth_bonding_information_t* bonding_information);
 void nodemgmt_format_user_profile(uint16_t uid, uint16_t secPreferences, uint16_t languageId, uint16_t keyboardId, uint16_t bleKeyboardId);
@@ -521,5 +559,8 @@ void nodemgmt_set_profile_ctr(void* buf);
 uint16_t nodemgmt_get_current_date(void);
 uint16_t nodemgmt_get_user_layout(void);
 void nodemgmt_scan_node_usage(void);
+void nodemgmt_invalidate_service_index(void);
+void nodemgmt_invalidate_category_cache(void);
+uint16_t nodemgmt_get_node_slots_change_counter(void);
 
 #endif /* NODEMGMT_H_ */
@@ -100,6 +100,7 @@
     #define oled_check_for_flush_and_terminate                        sh1122_check_for_flush_and_terminate
     #define oled_flush_frame_buffer_y_window                          sh1122_flush_frame_buffer_y_window
     #define oled_flush_frame_buffer_window                            sh1122_flush_frame_buffer_window
+    #define oled_mark_frame_buffer_dirty                              sh1122_mark_frame_buffer_dirty
     #define oled_clear_y_frame_buffer                                 sh1122_clear_y_frame_buffer
     #define oled_flush_frame_buffer                                   sh1122_flush_frame_buffer
     #define oled_clear_frame_buffer                                   sh1122_clear_frame_buffer
@@ -178,6 +179,7 @@
     #ifdef OLED_INTERNAL_FRAME_BUFFER
     #define oled_check_for_flush_and_terminate                        ssd1363_check_for_flush_and_terminate
     #define oled_flush_frame_buffer_window                            ssd1363_flush_frame_buffer_window
+    #define oled_mark_frame_buffer_dirty                              ssd1363_mark_frame_buffer_dirty
     #define oled_flush_frame_buffer                                   ssd1363_flush_frame_buffer
     #define oled_clear_frame_buffer                                   ssd1363_clear_frame_buffer
     #endif
@@ -243,6 +243,9 @@ void sh1122_set_row_address(oled_descriptor_t* oled_descriptor, uint8_t start)
 void sh1122_move_display_start_line(oled_descriptor_t* oled_descriptor, int16_t offset)
 {   
     sh1122_write_single_command(oled_descriptor, SH1122_CMD_SET_DISPLAY_START_LINE | (uint8_t)offset);
+    #ifdef OLED_INTERNAL_FRAME_BUFFER
+    sh1122_mark_frame_buffer_dirty(oled_descriptor, 0, 0, SH1122_OLED_WIDTH, SH1122_OLED_HEIGHT);
+    #endif
 }
 
 /*! \fn     sh1122_is_oled_on(oled_descriptor_t* oled_descriptor)
@@ -449,6 +452,9 @@ void sh1122_set_screen_invert(oled_descriptor_t* oled_descriptor, BOOL screen_in
         sh1122_write_single_command(oled_descriptor, SH1122_CMD_SET_SCAN_DIRECTION);
     }
     oled_descriptor->screen_inverted = screen_inverted;
+    #ifdef OLED_INTERNAL_FRAME_BUFFER
+    sh1122_mark_frame_buffer_dirty(oled_descriptor, 0, 0, SH1122_OLED_WIDTH, SH1122_OLED_HEIGHT);
+    #endif
 }
 
 /*! \fn     sh1122_prevent_partial_text_y_draw(oled_descriptor_t* oled_descriptor)
@@ -500,6 +506,11 @@ void sh1122_fill_screen(oled_descriptor_t* oled_descriptor, uint16_t color)
     }   
     sercom_spi_wait_for_transmit_complete(oled_descriptor->sercom_pt);
     sh1122_stop_data_sending(oled_descriptor);
+    
+    /* Screen contents don't match our frame buffer anymore */
+    #ifdef OLED_INTERNAL_FRAME_BUFFER
+    sh1122_mark_frame_buffer_dirty(oled_descriptor, 0, 0, SH1122_OLED_WIDTH, SH1122_OLED_HEIGHT);
+    #endif
 }
 
 /*! \fn     sh1122_clear_current_screen(oled_descriptor_t* oled_descriptor)
@@ -532,6 +543,7 @@ void sh1122_clear_frame_buffer(oled_descriptor_t* oled_descriptor)
 {
     sh1122_check_for_flush_and_terminate(oled_descriptor);
     memset((void*)oled_descriptor->frame_buffer, 0x00, sizeof(oled_descriptor->frame_buffer));
+    sh1122_mark_frame_buffer_dirty(oled_descriptor, 0, 0, SH1122_OLED_WIDTH, SH1122_OLED_HEIGHT);
 }
 
 /*! \fn     sh1122_clear_y_frame_buffer(oled_descriptor_t* oled_descriptor)
@@ -549,6 +561,70 @@ void sh1122_clear_y_frame_buffer(oled_descriptor_t* oled_descriptor, uint16_t ys
     
     sh1122_check_for_flush_and_terminate(oled_descriptor);
     memset((void*)&oled_descriptor->frame_buffer[ystart][0], 0x00, (yend-ystart)*SH1122_OLED_WIDTH/2);
+    sh1122_mark_frame_buffer_dirty(oled_descriptor, 0, ystart, SH1122_OLED_WIDTH, yend-ystart);
+}
+
+/*! \fn     sh1122_mark_frame_buffer_dirty(oled_descriptor_t* oled_descriptor, int16_t x, int16_t y, int16_t width, int16_t height)
+*   \brief  Add a region to the frame buffer area that may differ from the screen contents
+*   \param  oled_descriptor     Pointer to a sh1122 descriptor struct
+*   \param  x                   Region X
+*   \param  y                   Region Y
+*   \param  width               Region width
+*   \param  height              Region height
+*   \note   To be called by anything modifying the frame buffer or writing directly to the screen
+*/
+void sh1122_mark_frame_buffer_dirty(oled_descriptor_t* oled_descriptor, int16_t x, int16_t y, int16_t width, int16_t height)
+{
+    int32_t xstart = x < 0 ? 0 : x;
+    int32_t ystart = y < 0 ? 0 : y;
+    int32_t xend = (int32_t)x + width;
+    int32_t yend = (int32_t)y + height;
+    
+    /* Clip to screen */
+    if (xend > SH1122_OLED_WIDTH)
+    {
+        xend = SH1122_OLED_WIDTH;
+    }
+    if (yend > SH1122_OLED_HEIGHT)
+    {
+        yend = SH1122_OLED_HEIGHT;
+    }
+    if ((xend <= xstart) || (yend <= ystart))
+    {
+        return;
+    }
+    
+    /* Convert to frame buffer columns */
+    xstart = xstart/2;
+    xend = (xend+1)/2;
+    
+    /* Grow the dirty region */
+    if (oled_descriptor->dirty_ystart >= oled_descriptor->dirty_yend)
+    {
+        oled_descriptor->dirty_xstart = (uint16_t)xstart;
+        oled_descriptor->dirty_xend = (uint16_t)xend;
+        oled_descriptor->dirty_ystart = (uint16_t)ystart;
+        oled_descriptor->dirty_yend = (uint16_t)yend;
+    } 
+    else
+    {
+        if (xstart < oled_descriptor->dirty_xstart)
+        {
+            oled_descriptor->dirty_xstart = (uint16_t)xstart;
+        }
+        if (xend > oled_descriptor->dirty_xend)
+        {
+            oled_descriptor->dirty_xend = (uint16_t)xend;
+        }
+        if (ystart < oled_descriptor->dirty_ystart)
+        {
+            oled_descriptor->dirty_ystart = (uint16_t)ystart;
+        }
+        if (yend > oled_descriptor->dirty_yend)
+        {
+            oled_descriptor->dirty_yend = (uint16_t)yend;
+        }
+    }
 }
 
 /*! \fn     sh1122_check_for_flush_and_terminate(oled_descriptor_t* oled_descriptor)
@@ -662,26 +738,69 @@ void sh1122_flush_frame_buffer(oled_descriptor_t* oled_descriptor)
     sh1122_check_for_flush_and_terminate(oled_descriptor);
     
     if (oled_descriptor->loaded_transition == OLED_TRANS_NONE)
-    {        
-        /* Set pixel write window */
-        sh1122_set_row_address(oled_descriptor, 0);
-        sh1122_set_column_address(oled_descriptor, 0);
+    {
+        uint16_t xstart = oled_descriptor->dirty_xstart;
+        uint16_t xend = oled_descriptor->dirty_xend;
+        uint16_t ystart = oled_descriptor->dirty_ystart;
+        uint16_t yend = oled_descriptor->dirty_yend;
         
-        /* Start filling the SSD1322 RAM */
-        sh1122_start_data_sending(oled_descriptor);
+        /* Nothing changed since last flush */
+        if (ystart >= yend)
+        {
+            return;
+        }
         
-        /* Send buffer! */
-        #ifdef OLED_DMA_TRANSFER        
-            dma_oled_init_transfer(oled_descriptor->sercom_pt, (void*)&oled_descriptor->frame_buffer[0][0], sizeof(oled_descriptor->frame_buffer), oled_descriptor->dma_trigger_id);
-            oled_descriptor->frame_buffer_flush_in_progress = TRUE;
-        #else
-            for (uint32_t y = 0; y < SH1122_OLED_HEIGHT; y++) 
-            {
-                for (uint32_t x = 0; x < SH1122_OLED_WIDTH/2; x++) {
-                    sercom_spi_send_single_byte_without_receive_wait(oled_descriptor->sercom_pt, oled_descriptor->frame_buffer[y][x]);
+        if ((xend - xstart) > SH1122_PARTIAL_FLUSH_MAX_COLUMNS)
+        {
+            /* Set pixel write window */
+            sh1122_set_row_address(oled_descriptor, ystart);
+            sh1122_set_column_address(oled_descriptor, 0);
+            
+            /* Start filling the SSD1322 RAM */
+            sh1122_start_data_sending(oled_descriptor);
+            
+            /* Send the dirty rows! */
+            #ifdef OLED_DMA_TRANSFER        
+                dma_oled_init_transfer(oled_descriptor->sercom_pt, (void*)&oled_descriptor->frame_buffer[ystart][0], (yend-ystart)*SH1122_OLED_WIDTH/2, oled_descriptor->dma_trigger_id);
+                oled_descriptor->frame_buffer_flush_in_progress = TRUE;
+            #else
+                for (uint32_t y = ystart; y < yend; y++) 
+                {
+                    for (uint32_t x = 0; x < SH1122_OLED_WIDTH/2; x++) {
+                        sercom_spi_send_single_byte_without_receive_wait(oled_descriptor->sercom_pt, oled_descriptor->frame_buffer[y][x]);
+                    }
                 }
+            #endif
+        }
+        else
+        {
+            /* Narrow region: only send the dirty columns of each dirty row */
+            for (uint16_t y = ystart; y < yend; y++)
+            {
+                /* Set pixel write window */
+                sh1122_set_row_address(oled_descriptor, y);
+                sh1122_set_column_address(oled_descriptor, xstart);
+                
+                /* Start filling the SSD1322 RAM */
+                sh1122_start_data_sending(oled_descriptor);
+                
+                #ifdef OLED_DMA_TRANSFER
+                    dma_oled_init_transfer(oled_descriptor->sercom_pt, (void*)&oled_descriptor->frame_buffer[y][xstart], xend-xstart, oled_descriptor->dma_trigger_id);
+                    while(dma_oled_check_and_clear_dma_transfer_flag() == FALSE);
+                #else
+                    for (uint32_t x = xstart; x < xend; x++)
+                    {
+                        sercom_spi_send_single_byte_without_receive_wait(oled_descriptor->sercom_pt, oled_descriptor->frame_buffer[y][x]);
+                    }
+                #endif
+                
+                /* Wait for spi buffer to be sent */
+                sercom_spi_wait_for_transmit_complete(oled_descriptor->sercom_pt);
+                
+                /* Stop sending data */
+                sh1122_stop_data_sending(oled_descriptor);
             }
-        #endif
+        }
     }
     else if (oled_descriptor->loaded_transition == OLED_LEFT_RIGHT_TRANS)
     {
@@ -820,18 +939,38 @@ void sh1122_flush_frame_buffer(oled_descriptor_t* oled_descriptor)
         }
     }
     
+    /* Screen now matches our frame buffer */
+    oled_descriptor->dirty_ystart = 0;
+    oled_descriptor->dirty_yend = 0;
+    
     /* Reset transition */
     oled_descriptor->loaded_transition = OLED_TRANS_NONE;
     emu_oled_flush();
 }
 #endif
 
+/*! \fn     sh1122_invalidate_glyph_cache(oled_descriptor_t* oled_descriptor)
+*   \brief  Invalidate cached glyphs, to be called when the current font changes
+*   \param  oled_descriptor     Pointer to a sh1122 descriptor struct
+*/
+static void sh1122_invalidate_glyph_cache(oled_descriptor_t* oled_descriptor)
+{
+    #ifdef OLED_GLYPH_CACHE
+    memset(oled_descriptor->glyph_cache_status, SH1122_GLYPH_CACHE_UNKNOWN, sizeof(oled_descriptor->glyph_cache_status));
+    memset(oled_descriptor->glyph_bitmap_cache, 0, sizeof(oled_descriptor->glyph_bitmap_cache));
+    oled_descriptor->glyph_bitmap_cache_counter = 0;
+    #else
+    (void)oled_descriptor;
+    #endif
+}
+
 /*! \fn     sh1122_set_emergency_font(void)
 *   \brief  Use the flash-stored emergency font (ascii only)
 *   \param  oled_descriptor     Pointer to a sh1122 descriptor struct
 */
 void sh1122_set_emergency_font(oled_descriptor_t* oled_descriptor)
 {
+    sh1122_invalidate_glyph_cache(oled_descriptor);
     oled_descriptor->currentFontAddress = CUSTOM_FS_EMERGENCY_FONT_FILE_ADDR;
     custom_fs_read_from_flash((uint8_t*)&oled_descriptor->current_font_header, oled_descriptor->currentFontAddress, sizeof(oled_descriptor->current_font_header));
     custom_fs_read_from_flash((uint8_t*)&oled_descriptor->current_unicode_inters, oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header), sizeof(oled_descriptor->current_unicode_inters));
@@ -845,6 +984,9 @@ void sh1122_set_emergency_font(oled_descriptor_t* oled_descriptor)
 */
 RET_TYPE sh1122_refresh_used_font(oled_descriptor_t* oled_descriptor, uint16_t font_id)
 {
+    /* Cached glyphs belong to the previous font */
+    sh1122_invalidate_glyph_cache(oled_descriptor);
+    
     if (custom_fs_get_file_address(font_id, &oled_descriptor->currentFontAddress, CUSTOM_FS_FONTS_TYPE) != RETURN_OK)
     {
         oled_descriptor->currentFontAddress = 0;
@@ -994,6 +1136,7 @@ void sh1122_draw_vertical_line(oled_descriptor_t* oled_descriptor, int16_t x, in
     ystart = ystart<0?0:ystart;
     
     #ifdef OLED_INTERNAL_FRAME_BUFFER
+    sh1122_mark_frame_buffer_dirty(oled_descriptor, x, ystart, 1, yend-ystart+1);
     if (write_to_buffer != FALSE)
     {
         for (int16_t y=ystart; y<=yend; y++)
@@ -1076,6 +1219,16 @@ void sh1122_display_horizontal_pixel_line(oled_descriptor_t* oled_descriptor, in
 #ifdef OLED_INTERNAL_FRAME_BUFFER
     if (write_to_buffer != FALSE)
     {
+        /* Negative or wrapping X: mark the complete line. Not done when sending frame buffer contents (flushes, transitions) */
+        if ((x < 0) || (x + width > SH1122_OLED_WIDTH))
+        {
+            sh1122_mark_frame_buffer_dirty(oled_descriptor, 0, y, SH1122_OLED_WIDTH, 1);
+        }
+        else
+        {
+            sh1122_mark_frame_buffer_dirty(oled_descriptor, x, y, width, 1);
+        }
+        
         /* Previous pixels in case we are shifted */
         uint8_t prev_pixels = 0x00;
         
@@ -1268,6 +1421,7 @@ void sh1122_draw_rectangle(oled_descriptor_t* oled_descriptor, int16_t x, int16_
     uint16_t xoff = x - (x / 2) * 2;
 
     #ifdef OLED_INTERNAL_FRAME_BUFFER
+    sh1122_mark_frame_buffer_dirty(oled_descriptor, x, y, width, height);
     if (write_to_buffer != FALSE)
     {
         for (uint16_t yind = 0; yind < height; yind++)
@@ -1390,6 +1544,9 @@ void sh1122_draw_full_screen_image_from_bitstream(oled_descriptor_t* oled_descri
     #ifdef OLED_INTERNAL_FRAME_BUFFER
     /* Wait for a possible ongoing previous flush */
     sh1122_check_for_flush_and_terminate(oled_descriptor);
+    
+    /* Screen contents won't match our frame buffer anymore */
+    sh1122_mark_frame_buffer_dirty(oled_descriptor, 0, 0, SH1122_OLED_WIDTH, SH1122_OLED_HEIGHT);
     #endif
 
     /* Set pixel write window */
@@ -1559,6 +1716,9 @@ void sh1122_draw_image_from_bitstream(oled_descriptor_t* oled_descriptor, int16_
         #ifdef OLED_INTERNAL_FRAME_BUFFER
         /* Wait for a possible ongoing previous flush */
         sh1122_check_for_flush_and_terminate(oled_descriptor);
+        
+        /* Screen contents won't match our frame buffer on these lines */
+        sh1122_mark_frame_buffer_dirty(oled_descriptor, 0, y, SH1122_OLED_WIDTH, bitstream->height);
         #endif
 
         /* Trigger first buffer fill: if we asked more data, the bitstream will return 0s */
@@ -1606,6 +1766,11 @@ void sh1122_draw_image_from_bitstream(oled_descriptor_t* oled_descriptor, int16_
     #endif
     else
     {
+        #ifdef OLED_INTERNAL_FRAME_BUFFER
+        /* Screen contents won't match our frame buffer on these lines */
+        sh1122_mark_frame_buffer_dirty(oled_descriptor, 0, y, SH1122_OLED_WIDTH, bitstream->height);
+        #endif
+        
         /* Negative X */
         if ((x < 0) && (oled_descriptor->screen_wrapping_allowed != FALSE))
         {
@@ -1786,84 +1951,182 @@ uint16_t sh1122_get_string_width(oled_descriptor_t* oled_descriptor, const cust_
     return width;    
 }
 
-/*! \fn     sh1122_get_glyph_width(oled_descriptor_t* oled_descriptor, char ch, uint16_t* glyph_height)
-*   \brief  Return the width of the specified character in the current font
+/*! \fn     sh1122_read_glyph_from_flash(oled_descriptor_t* oled_descriptor, cust_char_t ch, font_glyph_t* glyph)
+*   \brief  Read the glyph header of a given char in the current font, or the '?' one if not supported
 *   \param  oled_descriptor     Pointer to a sh1122 descriptor struct
 *   \param  ch                  Character
-*   \param  glyph_height        Where to store the glyph height (added bonus)
-*   \return width of the glyph
+*   \param  glyph               Where to store the glyph header
+*   \return RETURN_OK if the char (or '?') is supported by the current font
 */
-uint16_t sh1122_get_glyph_width(oled_descriptor_t* oled_descriptor, cust_char_t ch, uint16_t* glyph_height)
+static RET_TYPE sh1122_read_glyph_from_flash(oled_descriptor_t* oled_descriptor, cust_char_t ch, font_glyph_t* glyph)
 {
-    uint16_t glyph_desc_pt_offset = 0;
-    uint16_t interval_start = 0;
-    font_glyph_t glyph;
-    uint16_t gind;
+    uint16_t glyph_desc_pt_offset = 0;  // Offset to the pointer of the glyph descriptor
+    uint16_t interval_start = 0;        // Unicode code of the first char of the current unicode support interval
+    uint16_t gind;                      // Glyph index
     
-    /* Set default value */
-    *glyph_height = 0;
+    /* Check that support for this char is described */
+    BOOL char_support_described = FALSE;
+    for (uint16_t i=0; i < sizeof(oled_descriptor->current_unicode_inters)/sizeof(oled_descriptor->current_unicode_inters[0]); i++)
+    {
+        /* Check if char is within this interval */
+        if ((oled_descriptor->current_unicode_inters[i].interval_start != 0xFFFF) && (oled_descriptor->current_unicode_inters[i].interval_start <= ch) && (oled_descriptor->current_unicode_inters[i].interval_end >= ch))
+        {
+            interval_start = oled_descriptor->current_unicode_inters[i].interval_start;
+            char_support_described = TRUE;
+            break;
+        }
+        
+        /* Add offset to descriptor */
+        glyph_desc_pt_offset += oled_descriptor->current_unicode_inters[i].interval_end - oled_descriptor->current_unicode_inters[i].interval_start + 1;
+    }
     
-    /* Check that a font was actually chosen */
-    if (oled_descriptor->currentFontAddress != 0)
+    /* Support not described, check if we could switch with ? */
+    if (char_support_described == FALSE)
     {
-        /* Check that support for this char is described */
-        BOOL char_support_described = FALSE;
-        for (uint16_t i=0; i < sizeof(oled_descriptor->current_unicode_inters)/sizeof(oled_descriptor->current_unicode_inters[0]); i++)
+        if (oled_descriptor->question_mark_support_described != FALSE)
         {
-            /* Check if char is within this interval */
-            if ((oled_descriptor->current_unicode_inters[i].interval_start != 0xFFFF) && (oled_descriptor->current_unicode_inters[i].interval_start <= ch) && (oled_descriptor->current_unicode_inters[i].interval_end >= ch))
-            {
-                interval_start = oled_descriptor->current_unicode_inters[i].interval_start;
-                char_support_described = TRUE;
-                break;
-            }
-            
-            /* Add offset to descriptor */
-            glyph_desc_pt_offset += oled_descriptor->current_unicode_inters[i].interval_end - oled_descriptor->current_unicode_inters[i].interval_start + 1;
+            interval_start = oled_descriptor->current_unicode_inters[0].interval_start;
+            glyph_desc_pt_offset = 0;
+            ch = '?';
+        }
+        else
+        {
+            return RETURN_NOK;
+        }
+    }
+    
+    /* Convert character to glyph index */
+    custom_fs_read_from_flash((uint8_t*)&gind, oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header) + sizeof(oled_descriptor->current_unicode_inters) + glyph_desc_pt_offset*sizeof(gind) + (ch - interval_start)*sizeof(gind), sizeof(gind));
+
+    /* Check that we know this glyph */
+    if(gind == 0xFFFF)
+    {
+        // If we don't know this character, try again with '?'
+        if (oled_descriptor->question_mark_support_described == FALSE)
+        {
+            return RETURN_NOK;
+        }
+        else
+        {
+            ch = '?';
         }
+        custom_fs_read_from_flash((uint8_t*)&gind, oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header) + sizeof(oled_descriptor->current_unicode_inters) + glyph_desc_pt_offset*sizeof(gind) + (ch - interval_start)*sizeof(gind), sizeof(gind));
         
-        /* Support not described, check if we could switch with ? */
-        if (char_support_described == FALSE)
+        // If we still don't know it, return 0
+        if (gind == 0xFFFF)
         {
-            if (oled_descriptor->question_mark_support_described != FALSE)
+            return RETURN_NOK;
+        }
+    }
+    
+    /* Read glyph data */
+    custom_fs_read_from_flash((uint8_t*)glyph, oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header) + sizeof(oled_descriptor->current_unicode_inters) + (oled_descriptor->current_font_header.described_chr_count)*sizeof(gind) + gind*sizeof(font_glyph_t), sizeof(font_glyph_t));
+    return RETURN_OK;
+}
+
+/*! \fn     sh1122_get_glyph(oled_descriptor_t* oled_descriptor, cust_char_t ch, font_glyph_t* glyph)
+*   \brief  Get the glyph header of a given char in the current font, or the '?' one if not supported
+*   \param  oled_descriptor     Pointer to a sh1122 descriptor struct
+*   \param  ch                  Character
+*   \param  glyph               Where to store the glyph header
+*   \return RETURN_OK if the char (or '?') is supported by the current font
+*   \note   Printable ASCII chars are served from the glyph cache once looked up
+*/
+static RET_TYPE sh1122_get_glyph(oled_descriptor_t* oled_descriptor, cust_char_t ch, font_glyph_t* glyph)
+{
+    #ifdef OLED_GLYPH_CACHE
+    if ((ch >= SH1122_GLYPH_CACHE_FIRST_CHR) && (ch <= SH1122_GLYPH_CACHE_LAST_CHR))
+    {
+        uint16_t cache_index = ch - SH1122_GLYPH_CACHE_FIRST_CHR;
+        
+        /* First lookup for this char: fetch it from flash */
+        if (oled_descriptor->glyph_cache_status[cache_index] == SH1122_GLYPH_CACHE_UNKNOWN)
+        {
+            if (sh1122_read_glyph_from_flash(oled_descriptor, ch, &oled_descriptor->glyph_cache[cache_index]) == RETURN_OK)
             {
-                interval_start = oled_descriptor->current_unicode_inters[0].interval_start;
-                glyph_desc_pt_offset = 0;
-                ch = '?';
+                oled_descriptor->glyph_cache_status[cache_index] = SH1122_GLYPH_CACHE_SUPPORTED;
             } 
             else
             {
-                return 0;
+                oled_descriptor->glyph_cache_status[cache_index] = SH1122_GLYPH_CACHE_NOT_SUPPORTED;
             }
         }
         
-        /* Convert character to glyph index */
-        custom_fs_read_from_flash((uint8_t*)&gind, oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header) + sizeof(oled_descriptor->current_unicode_inters) + glyph_desc_pt_offset*sizeof(gind) + (ch - interval_start)*sizeof(gind), sizeof(gind));
-
-        /* Check that we know this glyph */
-        if(gind == 0xFFFF)
+        if (oled_descriptor->glyph_cache_status[cache_index] == SH1122_GLYPH_CACHE_SUPPORTED)
         {
-            // If we don't know this character, try again with '?'
-            if (oled_descriptor->question_mark_support_described == FALSE)
-            {
-                return 0;
-            }
-            else
-            {
-                ch = '?';
-            }            
-            custom_fs_read_from_flash((uint8_t*)&gind, oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header) + sizeof(oled_descriptor->current_unicode_inters) + glyph_desc_pt_offset*sizeof(gind) + (ch - interval_start)*sizeof(gind), sizeof(gind));
-            
-            // If we still don't know it, return 0
-            if (gind == 0xFFFF)
-            {
-                return 0;
-            }
+            memcpy(glyph, &oled_descriptor->glyph_cache[cache_index], sizeof(font_glyph_t));
+            return RETURN_OK;
+        } 
+        else
+        {
+            return RETURN_NOK;
         }
+    }
+    #endif
+    
+    return sh1122_read_glyph_from_flash(oled_descriptor, ch, glyph);
+}
 
-        // Read the beginning of the glyph
-        custom_fs_read_from_flash((uint8_t*)&glyph, oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header) + sizeof(oled_descriptor->current_unicode_inters) + (oled_descriptor->current_font_header.described_chr_count)*sizeof(gind) + gind*sizeof(glyph), sizeof(glyph));
+#ifdef OLED_GLYPH_CACHE
+/*! \fn     sh1122_get_glyph_bitmap_from_cache(oled_descriptor_t* oled_descriptor, cust_char_t ch, font_glyph_t* glyph, custom_fs_address_t gaddr)
+*   \brief  Get a glyph bitmap from the bitmap cache, fetching it if it isn't there
+*   \param  oled_descriptor     Pointer to a sh1122 descriptor struct
+*   \param  ch                  Character
+*   \param  glyph               Pointer to the glyph header
+*   \param  gaddr               Glyph data address
+*   \return Pointer to the glyph data, 0 if the glyph is too big to be cached
+*   \note   The least recently drawn glyph is evicted
+*/
+static uint8_t* sh1122_get_glyph_bitmap_from_cache(oled_descriptor_t* oled_descriptor, cust_char_t ch, font_glyph_t* glyph, custom_fs_address_t gaddr)
+{
+    glyph_bitmap_cache_slot_t* slot_pt = &oled_descriptor->glyph_bitmap_cache[0];
+    uint16_t glyph_data_size = ((glyph->xrect*oled_descriptor->current_font_header.depth+7)/8) * glyph->yrect;
+    
+    /* Check that it fits */
+    if (glyph_data_size > SH1122_GLYPH_BITMAP_CACHE_SLOT_SIZE)
+    {
+        return 0;
+    }
+    
+    /* Look for this char, keep track of the least recently used slot */
+    for (uint16_t i = 0; i < SH1122_GLYPH_BITMAP_CACHE_NB_SLOTS; i++)
+    {
+        if (oled_descriptor->glyph_bitmap_cache[i].chr == ch)
+        {
+            oled_descriptor->glyph_bitmap_cache[i].last_use = ++oled_descriptor->glyph_bitmap_cache_counter;
+            return oled_descriptor->glyph_bitmap_cache[i].data;
+        }
+        if (oled_descriptor->glyph_bitmap_cache[i].last_use < slot_pt->last_use)
+        {
+            slot_pt = &oled_descriptor->glyph_bitmap_cache[i];
+        }
+    }
+    
+    /* Fetch glyph bitmap */
+    custom_fs_read_from_flash(slot_pt->data, gaddr, glyph_data_size);
+    slot_pt->chr = ch;
+    slot_pt->last_use = ++oled_descriptor->glyph_bitmap_cache_counter;
+    return slot_pt->data;
+}
+#endif
 
+/*! \fn     sh1122_get_glyph_width(oled_descriptor_t* oled_descriptor, char ch, uint16_t* glyph_height)
+*   \brief  Return the width of the specified character in the current font
+*   \param  oled_descriptor     Pointer to a sh1122 descriptor struct
+*   \param  ch                  Character
+*   \param  glyph_height        Where to store the glyph height (added bonus)
+*   \return width of the glyph
+*/
+uint16_t sh1122_get_glyph_width(oled_descriptor_t* oled_descriptor, cust_char_t ch, uint16_t* glyph_height)
+{
+    font_glyph_t glyph;
+    
+    /* Set default value */
+    *glyph_height = 0;
+    
+    /* Check that a font was actually chosen and that we know this glyph */
+    if ((oled_descriptor->currentFontAddress != 0) && (sh1122_get_glyph(oled_descriptor, ch, &glyph) == RETURN_OK))
+    {
         if (glyph.glyph_data_offset == 0xFFFFFFFF)
         {
             // If there's no glyph data, it is the space!
@@ -1892,12 +2155,9 @@ uint16_t sh1122_get_glyph_width(oled_descriptor_t* oled_descriptor, cust_char_t
  */
 uint16_t sh1122_glyph_draw(oled_descriptor_t* oled_descriptor, int16_t x, int16_t y, cust_char_t ch, BOOL write_to_buffer)
 {
-    uint16_t glyph_desc_pt_offset = 0;  // Offset to the pointer of the glyph descriptor
-    uint16_t interval_start = 0;        // Unicode code of the first char of the current unicode support interval
     bitstream_bitmap_t bs;              // Character bitstream
     uint8_t glyph_width;                // Glyph width
     font_glyph_t glyph;                 // Glyph header
-    uint16_t gind;                      // Glyph index
 
     /* Check for selected font */
     if (oled_descriptor->currentFontAddress == 0)
@@ -1905,63 +2165,11 @@ uint16_t sh1122_glyph_draw(oled_descriptor_t* oled_descriptor, int16_t x, int16_
         return 0;
     }
     
-    /* Check that support for this char is described */
-    BOOL char_support_described = FALSE;
-    for (uint16_t i=0; i < sizeof(oled_descriptor->current_unicode_inters)/sizeof(oled_descriptor->current_unicode_inters[0]); i++)
-    {
-        /* Check if char is within this interval */
-        if ((oled_descriptor->current_unicode_inters[i].interval_start != 0xFFFF) && (oled_descriptor->current_unicode_inters[i].interval_start <= ch) && (oled_descriptor->current_unicode_inters[i].interval_end >= ch))
-        {
-            interval_start = oled_descriptor->current_unicode_inters[i].interval_start;
-            char_support_described = TRUE;
-            break;
-        }
-        
-        /* Add offset to descriptor */
-        glyph_desc_pt_offset += oled_descriptor->current_unicode_inters[i].interval_end - oled_descriptor->current_unicode_inters[i].interval_start + 1;
-    }
-    
-    /* Support not described, check if we could switch with ? */
-    if (char_support_described == FALSE)
-    {
-        if (oled_descriptor->question_mark_support_described != FALSE)
-        {
-            interval_start = oled_descriptor->current_unicode_inters[0].interval_start;
-            glyph_desc_pt_offset = 0;
-            ch = '?';
-        }
-        else
-        {
-            return 0;
-        }
-    }
-    
-    /* Convert character to glyph index */
-    custom_fs_read_from_flash((uint8_t*)&gind, oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header) + sizeof(oled_descriptor->current_unicode_inters) + glyph_desc_pt_offset*sizeof(gind) + (ch - interval_start)*sizeof(gind), sizeof(gind));
-
-    /* Check that we know this glyph */
-    if(gind == 0xFFFF)
+    /* Fetch glyph header */
+    if (sh1122_get_glyph(oled_descriptor, ch, &glyph) != RETURN_OK)
     {
-        // If we don't know this character, try again with '?'
-        if (oled_descriptor->question_mark_support_described == FALSE)
-        {
-            return 0;
-        }
-        else
-        {
-            ch = '?';
-        }
-        custom_fs_read_from_flash((uint8_t*)&gind, oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header) + sizeof(oled_descriptor->current_unicode_inters) + glyph_desc_pt_offset*sizeof(gind) + (ch - interval_start)*sizeof(gind), sizeof(gind));
-        
-        // If we still don't know it, return 0
-        if (gind == 0xFFFF)
-        {
-            return 0;
-        }
+        return 0;
     }
-    
-    /* Read glyph data */
-    custom_fs_read_from_flash((uint8_t*)&glyph, oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header) + sizeof(oled_descriptor->current_unicode_inters) + (oled_descriptor->current_font_header.described_chr_count)*sizeof(gind) + gind*sizeof(glyph), sizeof(glyph));
 
     if (glyph.glyph_data_offset == 0xFFFFFFFF)
     {
@@ -1977,10 +2185,24 @@ uint16_t sh1122_glyph_draw(oled_descriptor_t* oled_descriptor, int16_t x, int16_
         y += glyph.yoffset;
         
         /* Compute glyph data address */
-        custom_fs_address_t gaddr = oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header) + sizeof(oled_descriptor->current_unicode_inters) + (oled_descriptor->current_font_header.described_chr_count)*sizeof(gind) + (oled_descriptor->current_font_header.chr_count)*sizeof(glyph) + glyph.glyph_data_offset;
+        custom_fs_address_t gaddr = oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header) + sizeof(oled_descriptor->current_unicode_inters) + (oled_descriptor->current_font_header.described_chr_count)*sizeof(uint16_t) + (oled_descriptor->current_font_header.chr_count)*sizeof(glyph) + glyph.glyph_data_offset;
         
-        // Initialize bitstream & draw the character
+        // Initialize bitstream, from the glyph bitmap cache if possible
+        #ifdef OLED_GLYPH_CACHE
+        uint8_t* glyph_bitmap_pt = sh1122_get_glyph_bitmap_from_cache(oled_descriptor, ch, &glyph, gaddr);
+        if (glyph_bitmap_pt != 0)
+        {
+            bitstream_glyph_bitmap_init_from_ram(&bs, &oled_descriptor->current_font_header, &glyph, glyph_bitmap_pt);
+        }
+        else
+        {
+            bitstream_glyph_bitmap_init(&bs, &oled_descriptor->current_font_header, &glyph, gaddr, TRUE);
+        }
+        #else
         bitstream_glyph_bitmap_init(&bs, &oled_descriptor->current_font_header, &glyph, gaddr, TRUE);
+        #endif
+        
+        // Draw the character
         sh1122_draw_image_from_bitstream(oled_descriptor, x, y, &bs, write_to_buffer);
     }
     
@@ -67,6 +67,19 @@
 /* Transition defines */
 #define SH1122_TRANSITION_PIXEL     0x03
 
+/* Partial flush: dirty regions narrower than this number of frame buffer columns are sent row by row */
+#define SH1122_PARTIAL_FLUSH_MAX_COLUMNS    (SH1122_OLED_WIDTH/4)
+
+/* Glyph cache defines */
+#define SH1122_GLYPH_CACHE_FIRST_CHR            ' '
+#define SH1122_GLYPH_CACHE_LAST_CHR             '~'
+#define SH1122_GLYPH_CACHE_NB_CHRS              (SH1122_GLYPH_CACHE_LAST_CHR - SH1122_GLYPH_CACHE_FIRST_CHR + 1)
+#define SH1122_GLYPH_CACHE_UNKNOWN              0
+#define SH1122_GLYPH_CACHE_SUPPORTED            1
+#define SH1122_GLYPH_CACHE_NOT_SUPPORTED        2
+#define SH1122_GLYPH_BITMAP_CACHE_NB_SLOTS      12
+#define SH1122_GLYPH_BITMAP_CACHE_SLOT_SIZE     64
+
 /* Enums */
 typedef enum {OLED_TRANS_NONE, OLED_LEFT_RIGHT_TRANS, OLED_RIGHT_LEFT_TRANS, OLED_TOP_BOT_TRANS, OLED_BOT_TOP_TRANS, OLED_IN_OUT_TRANS, OLED_OUT_IN_TRANS} oled_transition_te;
 typedef enum {OLED_SCROLL_NONE = 0, OLED_SCROLL_UP = 1, OLED_SCROLL_DOWN = 2, OLED_SCROLL_FLIP = 3} oled_scroll_te;
@@ -87,6 +100,13 @@ typedef struct
     uint8_t pixels;
 } gddram_px_t;
 
+typedef struct
+{
+    cust_char_t chr;                                    // Cached char, 0 if slot is empty
+    uint32_t last_use;                                  // Last use counter value
+    uint8_t data[SH1122_GLYPH_BITMAP_CACHE_SLOT_SIZE];  // Glyph bitmap data
+} glyph_bitmap_cache_slot_t;
+
 typedef struct
 {
     Sercom* sercom_pt;
@@ -100,6 +120,12 @@ typedef struct
     font_header_t current_font_header;                  // Current font header
     unicode_interval_desc_t current_unicode_inters[15]; // Current unicode interval descriptors
     BOOL question_mark_support_described;               // If this font describes '?' support
+    #ifdef OLED_GLYPH_CACHE
+    uint8_t glyph_cache_status[SH1122_GLYPH_CACHE_NB_CHRS];                             // Glyph cache status for printable ASCII chars
+    font_glyph_t glyph_cache[SH1122_GLYPH_CACHE_NB_CHRS];                               // Glyph headers for printable ASCII chars
+    glyph_bitmap_cache_slot_t glyph_bitmap_cache[SH1122_GLYPH_BITMAP_CACHE_NB_SLOTS];   // Bitmaps of the most recently drawn glyphs
+    uint32_t glyph_bitmap_cache_counter;                                                // Glyph bitmap cache use counter
+    #endif
     BOOL screen_wrapping_allowed;                       // If we are allowing screen wrapping
     BOOL carriage_return_allowed;                       // If we are allowing \r
     BOOL line_feed_allowed;                             // If we are allowing \n
@@ -120,6 +146,10 @@ typedef struct
     #ifdef OLED_INTERNAL_FRAME_BUFFER
     uint8_t frame_buffer[SH1122_OLED_HEIGHT][SH1122_OLED_WIDTH/(8/SH1122_OLED_BPP)];
     BOOL frame_buffer_flush_in_progress;
+    uint16_t dirty_xstart;                              // First frame buffer column (2 pixels) that may differ from the screen
+    uint16_t dirty_xend;                                // Last frame buffer column that may differ from the screen (exclusive)
+    uint16_t dirty_ystart;                              // First frame buffer row that may differ from the screen
+    uint16_t dirty_yend;                                // Last frame buffer row that may differ from the screen (exclusive)
     #endif
 } oled_descriptor_t;
 
@@ -188,6 +218,7 @@ void sh1122_oled_on(oled_descriptor_t* oled_descriptor);
 
 /* Depending on enabled features */
 #ifdef OLED_INTERNAL_FRAME_BUFFER
+    void sh1122_mark_frame_buffer_dirty(oled_descriptor_t* oled_descriptor, int16_t x, int16_t y, int16_t width, int16_t height);
     void sh1122_flush_frame_buffer_window(oled_descriptor_t* oled_descriptor, uint16_t x, uint16_t y, uint16_t width, uint16_t height);
     void sh1122_flush_frame_buffer_y_window(oled_descriptor_t* oled_descriptor, uint16_t ystart, uint16_t yend);
     void sh1122_clear_y_frame_buffer(oled_descriptor_t* oled_descriptor, uint16_t ystart, uint16_t yend);
@@ -236,6 +236,9 @@ void ssd1363_move_display_start_line(oled_descriptor_t* oled_descriptor, int16_t
     PORT->Group[oled_descriptor->cd_pin_group].OUTSET.reg = oled_descriptor->cd_pin_mask;
     sercom_spi_send_single_byte(oled_descriptor->sercom_pt, (uint8_t)offset);
     PORT->Group[oled_descriptor->cs_pin_group].OUTSET.reg = oled_descriptor->cs_pin_mask;
+    #ifdef OLED_INTERNAL_FRAME_BUFFER
+    ssd1363_mark_frame_buffer_dirty(oled_descriptor, 0, 0, SSD1363_OLED_WIDTH, SSD1363_OLED_HEIGHT);
+    #endif
 }
 
 /*! \fn     ssd1363_is_oled_on(oled_descriptor_t* oled_descriptor)
@@ -440,6 +443,9 @@ void ssd1363_set_screen_invert(oled_descriptor_t* oled_descriptor, BOOL screen_i
         ssd1363_write_single_command_with_data(oled_descriptor, SSD1363_CMD_SET_DISPLAY_OFFSET, 0x60);
     }
     oled_descriptor->screen_inverted = screen_inverted;
+    #ifdef OLED_INTERNAL_FRAME_BUFFER
+    ssd1363_mark_frame_buffer_dirty(oled_descriptor, 0, 0, SSD1363_OLED_WIDTH, SSD1363_OLED_HEIGHT);
+    #endif
 }
 
 /*! \fn     ssd1363_prevent_partial_text_y_draw(oled_descriptor_t* oled_descriptor)
@@ -492,6 +498,11 @@ void ssd1363_fill_screen(oled_descriptor_t* oled_descriptor, uint16_t color)
     }   
     sercom_spi_wait_for_transmit_complete(oled_descriptor->sercom_pt);
     ssd1363_stop_data_sending(oled_descriptor);
+    
+    /* Screen contents don't match our frame buffer anymore */
+    #ifdef OLED_INTERNAL_FRAME_BUFFER
+    ssd1363_mark_frame_buffer_dirty(oled_descriptor, 0, 0, SSD1363_OLED_WIDTH, SSD1363_OLED_HEIGHT);
+    #endif
 }
 
 /*! \fn     ssd1363_clear_current_screen(oled_descriptor_t* oled_descriptor)
@@ -524,6 +535,70 @@ void ssd1363_clear_frame_buffer(oled_descriptor_t* oled_descriptor)
 {
     ssd1363_check_for_flush_and_terminate(oled_descriptor);
     memset((void*)oled_descriptor->frame_buffer, 0x00, sizeof(oled_descriptor->frame_buffer));
+    ssd1363_mark_frame_buffer_dirty(oled_descriptor, 0, 0, SSD1363_OLED_WIDTH, SSD1363_OLED_HEIGHT);
+}
+
+/*! \fn     ssd1363_mark_frame_buffer_dirty(oled_descriptor_t* oled_descriptor, int16_t x, int16_t y, int16_t width, int16_t height)
+*   \brief  Add a region to the frame buffer area that may differ from the screen contents
+*   \param  oled_descriptor     Pointer to a ssd1363 descriptor struct
+*   \param  x                   Region X
+*   \param  y                   Region Y
+*   \param  width               Region width
+*   \param  height              Region height
+*   \note   To be called by anything modifying the frame buffer or writing directly to the screen
+*/
+void ssd1363_mark_frame_buffer_dirty(oled_descriptor_t* oled_descriptor, int16_t x, int16_t y, int16_t width, int16_t height)
+{
+    int32_t xstart = x < 0 ? 0 : x;
+    int32_t ystart = y < 0 ? 0 : y;
+    int32_t xend = (int32_t)x + width;
+    int32_t yend = (int32_t)y + height;
+    
+    /* Clip to screen */
+    if (xend > SSD1363_OLED_WIDTH)
+    {
+        xend = SSD1363_OLED_WIDTH;
+    }
+    if (yend > SSD1363_OLED_HEIGHT)
+    {
+        yend = SSD1363_OLED_HEIGHT;
+    }
+    if ((xend <= xstart) || (yend <= ystart))
+    {
+        return;
+    }
+    
+    /* Convert to display columns */
+    xstart = xstart/SSD1363_OLED_PIX_PER_COL;
+    xend = (xend+SSD1363_OLED_PIX_PER_COL-1)/SSD1363_OLED_PIX_PER_COL;
+    
+    /* Grow the dirty region */
+    if (oled_descriptor->dirty_ystart >= oled_descriptor->dirty_yend)
+    {
+        oled_descriptor->dirty_xstart = (uint16_t)xstart;
+        oled_descriptor->dirty_xend = (uint16_t)xend;
+        oled_descriptor->dirty_ystart = (uint16_t)ystart;
+        oled_descriptor->dirty_yend = (uint16_t)yend;
+    } 
+    else
+    {
+        if (xstart < oled_descriptor->dirty_xstart)
+        {
+            oled_descriptor->dirty_xstart = (uint16_t)xstart;
+        }
+        if (xend > oled_descriptor->dirty_xend)
+        {
+            oled_descriptor->dirty_xend = (uint16_t)xend;
+        }
+        if (ystart < oled_descriptor->dirty_ystart)
+        {
+            oled_descriptor->dirty_ystart = (uint16_t)ystart;
+        }
+        if (yend > oled_descriptor->dirty_yend)
+        {
+            oled_descriptor->dirty_yend = (uint16_t)yend;
+        }
+    }
 }
 
 /*! \fn     ssd1363_check_for_flush_and_terminate(oled_descriptor_t* oled_descriptor)
@@ -615,24 +690,51 @@ void ssd1363_flush_frame_buffer(oled_descriptor_t* oled_descriptor)
     
     if (oled_descriptor->loaded_transition == OLED_TRANS_NONE)
     {
-        /* Set pixel write window */
-        ssd1363_set_row_address(oled_descriptor, 0, SSD1363_OLED_HEIGHT-1);
-        ssd1363_set_column_address(oled_descriptor, 0, (SSD1363_OLED_WIDTH-1)/SSD1363_OLED_PIX_PER_COL);
+        uint16_t xstart = oled_descriptor->dirty_xstart;
+        uint16_t xend = oled_descriptor->dirty_xend;
+        uint16_t ystart = oled_descriptor->dirty_ystart;
+        uint16_t yend = oled_descriptor->dirty_yend;
+        
+        /* Nothing changed since last flush */
+        if (ystart >= yend)
+        {
+            return;
+        }
+        
+        /* Set pixel write window to the dirty region: the display moves to the next row at the window end */
+        ssd1363_set_row_address(oled_descriptor, ystart, yend-1);
+        ssd1363_set_column_address(oled_descriptor, xstart, xend-1);
         
         /* Start filling the SSD1322 RAM */
         ssd1363_write_single_command(oled_descriptor, SSD1363_CMD_WRITE_RAM);
         ssd1363_start_data_sending(oled_descriptor);
         
         /* Send buffer! */
-        #ifdef OLED_DMA_TRANSFER        
-            dma_oled_init_transfer(oled_descriptor->sercom_pt, (void*)&oled_descriptor->frame_buffer[0][0], sizeof(oled_descriptor->frame_buffer), oled_descriptor->dma_trigger_id);
-            oled_descriptor->frame_buffer_flush_in_progress = TRUE;
+        #ifdef OLED_DMA_TRANSFER
+            if ((xstart == 0) && (xend == SSD1363_OLED_WIDTH/SSD1363_OLED_PIX_PER_COL))
+            {
+                /* Full width rows are contiguous in our frame buffer: single transfer we don't need to wait for */
+                dma_oled_init_transfer(oled_descriptor->sercom_pt, (void*)&oled_descriptor->frame_buffer_16b[ystart][0], (yend-ystart)*sizeof(oled_descriptor->frame_buffer_16b[0]), oled_descriptor->dma_trigger_id);
+                oled_descriptor->frame_buffer_flush_in_progress = TRUE;
+            }
+            else
+            {
+                /* One transfer per dirty row */
+                for (uint16_t y = ystart; y < yend; y++)
+                {
+                    dma_oled_init_transfer(oled_descriptor->sercom_pt, (void*)&oled_descriptor->frame_buffer_16b[y][xstart], (xend-xstart)*sizeof(oled_descriptor->frame_buffer_16b[0][0]), oled_descriptor->dma_trigger_id);
+                    while(dma_oled_check_and_clear_dma_transfer_flag() == FALSE);
+                }
+                sercom_spi_wait_for_transmit_complete(oled_descriptor->sercom_pt);
+                ssd1363_stop_data_sending(oled_descriptor);
+            }
         #else
-            for (uint32_t y = 0; y < SSD1363_OLED_HEIGHT; y++) 
+            for (uint32_t y = ystart; y < yend; y++) 
             {
-                for (uint32_t x = 0; x < SSD1363_OLED_WIDTH/2; x++) 
+                for (uint32_t x = xstart; x < xend; x++) 
                 {
-                    sercom_spi_send_single_byte_without_receive_wait(oled_descriptor->sercom_pt, oled_descriptor->frame_buffer[y][x]);
+                    sercom_spi_send_single_byte_without_receive_wait(oled_descriptor->sercom_pt, (uint8_t)oled_descriptor->frame_buffer_16b[y][x]);
+                    sercom_spi_send_single_byte_without_receive_wait(oled_descriptor->sercom_pt, (uint8_t)(oled_descriptor->frame_buffer_16b[y][x] >> 8));
                 }
             }
             sercom_spi_wait_for_transmit_complete(oled_descriptor->sercom_pt);
@@ -752,6 +854,10 @@ void ssd1363_flush_frame_buffer(oled_descriptor_t* oled_descriptor)
         }
     }
     
+    /* Screen now matches our frame buffer */
+    oled_descriptor->dirty_ystart = 0;
+    oled_descriptor->dirty_yend = 0;
+    
     /* Reset transition */
     oled_descriptor->loaded_transition = OLED_TRANS_NONE;
 }
@@ -884,6 +990,9 @@ void ssd1363_init_display(oled_descriptor_t* oled_descriptor, BOOL leave_interna
     ssd1363_stop_data_sending(oled_descriptor);
 
     #ifdef OLED_INTERNAL_FRAME_BUFFER
+    /* Display RAM was just cleared */
+    ssd1363_mark_frame_buffer_dirty(oled_descriptor, 0, 0, SSD1363_OLED_WIDTH, SSD1363_OLED_HEIGHT);
+    
     if (leave_internal_logic_and_reflush_frame_buffer == FALSE)
     {
         /* Clear frame buffer if needed */
@@ -931,6 +1040,7 @@ void ssd1363_draw_vertical_line(oled_descriptor_t* oled_descriptor, int16_t x, i
     color &= 0x0F;
     
     #ifdef OLED_INTERNAL_FRAME_BUFFER
+    ssd1363_mark_frame_buffer_dirty(oled_descriptor, x, ystart, 1, yend-ystart+1);
     if (write_to_buffer != FALSE)
     {
         uint16_t pixels_4_color = (color) | (color << 4) | (color << 8) | (color << 12);
@@ -1005,6 +1115,7 @@ void ssd1363_draw_rectangle(oled_descriptor_t* oled_descriptor, int16_t x, int16
     uint16_t pixels_4_color = (color) | (color << 4) | (color << 8) | (color << 12);
 
     #ifdef OLED_INTERNAL_FRAME_BUFFER
+    ssd1363_mark_frame_buffer_dirty(oled_descriptor, x, y, width, height);
     if (write_to_buffer != FALSE)
     {
         uint16_t pixel_lfilling[4] = {0xFFFF, 0xF0FF, 0x00FF, 0x00F0};
@@ -1236,6 +1347,11 @@ void ssd1363_draw_image_from_bitstream(oled_descriptor_t* oled_descriptor, int16
         bitstream_bitmap_close(bitstream);
         return;
     }
+    
+    #ifdef OLED_INTERNAL_FRAME_BUFFER
+    /* Either our frame buffer or the screen is going to be modified */
+    ssd1363_mark_frame_buffer_dirty(oled_descriptor, x, y, bitstream->width, bitstream->height);
+    #endif
 
     /* Use different drawing methods if it's a full screen picture and if we are 4 pixels aligned */
     if ((x == 0) && (y == 0) && (bitstream->width == SSD1363_OLED_WIDTH) && (bitstream->height == SSD1363_OLED_HEIGHT) && (oled_descriptor->max_disp_y == SSD1363_OLED_HEIGHT) && (write_to_buffer == FALSE))
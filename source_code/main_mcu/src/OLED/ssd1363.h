@@ -125,6 +125,10 @@ typedef struct
         uint16_t frame_buffer_16b[SSD1363_OLED_HEIGHT][SSD1363_OLED_WIDTH/(16/SSD1363_OLED_BPP)];
     };
     BOOL frame_buffer_flush_in_progress;
+    uint16_t dirty_xstart;                              // First display column (4 pixels) that may differ from the screen
+    uint16_t dirty_xend;                                // Last display column that may differ from the screen (exclusive)
+    uint16_t dirty_ystart;                              // First frame buffer row that may differ from the screen
+    uint16_t dirty_yend;                                // Last frame buffer row that may differ from the screen (exclusive)
     #endif
 } oled_descriptor_t;
 
@@ -192,6 +196,7 @@ void ssd1363_oled_on(oled_descriptor_t* oled_descriptor);
 
 /* Depending on enabled features */
 #ifdef OLED_INTERNAL_FRAME_BUFFER
+void ssd1363_mark_frame_buffer_dirty(oled_descriptor_t* oled_descriptor, int16_t x, int16_t y, int16_t width, int16_t height);
 void ssd1363_flush_frame_buffer_window(oled_descriptor_t* oled_descriptor, uint16_t start_x, uint16_t start_y, uint16_t end_x, uint16_t end_y);
 void ssd1363_check_for_flush_and_terminate(oled_descriptor_t* oled_descriptor);
 void ssd1363_flush_frame_buffer(oled_descriptor_t* oled_descriptor);
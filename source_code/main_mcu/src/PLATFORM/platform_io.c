@@ -27,6 +27,7 @@
 #include "driver_timer.h"
 #include "platform_io.h"
 #include "driver_i2c.h"
+#include "main.h"
 /* OLED stepup-power source */
 oled_stepup_pwr_source_te platform_io_oled_stepup_power_source = OLED_STEPUP_SOURCE_NONE;
 /* Set when a conversion result is ready */
@@ -74,6 +75,9 @@ void AUXMCU_SERCOM_HANDLER(void)
 {
     platform_io_set_no_comms();
     platform_io_disable_rx_usart_rx_interrupt();
+    #ifndef BOOTLOADER
+    main_post_event(MAIN_EVENT_AUX_COMMS);
+    #endif
 }
 
 /*! \fn     platform_io_keep_power_on(void)
@@ -130,6 +134,9 @@ void ADC_Handler(void)
     /* Set conv ready bool and clear interrupt */
     platform_io_vbat_conv_ready = TRUE;
     ADC->INTFLAG.reg = ADC_INTFLAG_RESRDY;
+    #ifndef BOOTLOADER
+    main_post_event(MAIN_EVENT_ADC);
+    #endif
 }
 
 /*! \fn     platform_io_is_vbat_conversion_result_ready(void)
@@ -29,6 +29,8 @@
 #include "driver_timer.h"
 #include "platform_io.h"
 #include "main.h"
+#include "dma.h"
+#include <string.h>
 
 /** Current detection state, see enum, released by default */
 volatile det_ret_type_te card_return = RETURN_REL;
@@ -36,6 +38,10 @@ volatile det_ret_type_te card_return = RETURN_REL;
 volatile uint16_t card_detect_counter = 0;
 /* Smartcard powered state */
 volatile BOOL card_powered = FALSE;
+/* Image of the smartcard memory read since power up, secret zones are never kept */
+uint8_t smartcard_lowlevel_card_image[SMARTCARD_BYTE_LENGTH];
+/* Number of valid bytes in the smartcard image, starting from the first one */
+volatile uint16_t smartcard_lowlevel_card_image_length = 0;
 
 
 /*! \fn     smartcard_lowlevel_hpulse_delay(void)
@@ -58,6 +64,15 @@ static inline void smartcard_lowlevel_tchp_delay(void)
     timer_delay_ms(4);
 }
 
+/*! \fn     smartcard_lowlevel_clear_card_image(void)
+*   \brief  Invalidate and clear our smartcard memory image, to be called before the card contents or access rights may change
+*/
+static void smartcard_lowlevel_clear_card_image(void)
+{
+    smartcard_lowlevel_card_image_length = 0;
+    memset(smartcard_lowlevel_card_image, 0, sizeof(smartcard_lowlevel_card_image));
+}
+
 /*! \fn     smartcard_lowlevel_clock_pulse(void)
 *   \brief  Send a 4us H->L clock pulse (datasheet: min 3.3us)
 */
@@ -143,6 +158,9 @@ void smartcard_lowlevel_blow_fuse(card_fuse_type_te fuse_name)
     {
         i = 0;
     }
+    
+    /* Card contents will change */
+    smartcard_lowlevel_clear_card_image();
 
     /* Switch to bit banging */
     platform_io_smc_switch_to_bb();
@@ -211,6 +229,9 @@ void smartcard_lowlevel_detect(void)
             {
                 card_return = RETURN_JDETECT;
                 card_detect_counter++;
+                #ifndef BOOTLOADER
+                main_post_event(MAIN_EVENT_SMARTCARD);
+                #endif
             }
         }
         else if (card_detect_counter != 0xFFFF)
@@ -227,6 +248,7 @@ void smartcard_lowlevel_detect(void)
             if (card_powered != FALSE)
             {
                 card_powered = FALSE;
+                smartcard_lowlevel_clear_card_image();
                 platform_io_smc_remove_function();
                 logic_security_clear_security_bools();
                 #ifdef SPECIAL_DEVELOPER_CARD_FEATURE
@@ -238,6 +260,9 @@ void smartcard_lowlevel_detect(void)
         if (card_return == RETURN_DET)
         {
             card_return = RETURN_JRELEASED;
+            #ifndef BOOTLOADER
+            main_post_event(MAIN_EVENT_SMARTCARD);
+            #endif
         }
         else if (card_return != RETURN_JRELEASED)
         {
@@ -257,12 +282,14 @@ card_detect_return_te smartcard_lowlevel_first_detect_function(void)
     uint16_t temp_uint;
 
     /* Switch on / switch off / switch on, as in some rare cases the cards doesn't initialize correctly */
+    smartcard_lowlevel_clear_card_image();
     platform_io_smc_inserted_function();
     timer_delay_ms(300);
     card_powered = TRUE;
     
-    /* Seems to be required for correct init */
+    /* Seems to be required for correct init: don't keep what we read */
     smartcard_highlevel_read_fab_zone((uint8_t*)&data_buffer);
+    smartcard_lowlevel_clear_card_image();
 
     /* Check smart card FZ */
     smartcard_highlevel_read_fab_zone((uint8_t*)&data_buffer);
@@ -310,6 +337,9 @@ void smartcard_lowlevel_erase_application_zone1_nzone2(BOOL zone1_nzone2)
     {
         i = 688;
     }
+    
+    /* Card contents will change */
+    smartcard_lowlevel_clear_card_image();
 
     /* Switch to bit banging */
     platform_io_smc_switch_to_bb();
@@ -367,6 +397,9 @@ pin_check_return_te smartcard_lowlevel_validate_code(volatile uint16_t* code)
     pin_check_return_te return_val = RETURN_PIN_NOK_0;
     BOOL temp_bool;
     uint16_t i;
+    
+    /* Access rights & attempts counter will change */
+    smartcard_lowlevel_clear_card_image();
 
     /* Switch to bit banging */
     platform_io_smc_switch_to_bb();
@@ -490,6 +523,9 @@ void smartcard_lowlevel_write_smc(uint16_t start_index_bit, uint16_t nb_bits, ui
     uint16_t current_written_bit = 0;
     uint16_t masked_bit_to_write = 0;
     uint16_t i;
+    
+    /* Card contents will change */
+    smartcard_lowlevel_clear_card_image();
 
     /* Switch to bit banging */
     platform_io_smc_switch_to_bb();
@@ -571,37 +607,127 @@ void smartcard_lowlevel_set_pgmrst_signals(void)
     smartcard_lowlevel_hpulse_delay();
 }
 
-/*! \fn     smartcard_lowlevel_read_smc(uint16_t nb_bytes_total_read, uint16_t start_record_index, uint8_t* data_to_receive)
-*   \brief  Read bytes from the smart card
+/*! \fn     smartcard_lowlevel_fill_card_image(uint16_t nb_bytes_total_read)
+*   \brief  Read the first bytes of the smart card into our image
 *   \param  nb_bytes_total_read     The number of bytes to be read
-*   \param  start_record_index      The index at which we start recording the answer
-*   \param  data_to_receive        Pointer to the buffer
-*   \return The buffer
 */
-uint8_t* smartcard_lowlevel_read_smc(uint16_t nb_bytes_total_read, uint16_t start_record_index, uint8_t* data_to_receive)
+static void smartcard_lowlevel_fill_card_image(uint16_t nb_bytes_total_read)
 {
-    uint8_t* return_val = data_to_receive;
-    uint16_t i;
-
     /* Set PGM / RST signals for operation */
     smartcard_lowlevel_clear_pgmrst_signals();
 
-    for(i = 0; i < nb_bytes_total_read; i++)
+#ifndef BOOTLOADER
+    /* Flush a possible stale received byte */
+    while ((SMARTCARD_SERCOM->SPI.INTFLAG.reg & SERCOM_SPI_INTFLAG_RXC) != 0)
     {
-        /* Start transmission */
-        uint8_t data_byte = sercom_spi_send_single_byte(SMARTCARD_SERCOM, 0x00);
+        (void)SMARTCARD_SERCOM->SPI.DATA.reg;
+    }
 
-        /* Store data in buffer or discard it*/
-        if (i >= start_record_index)
+    /* Let the DMA clock the bytes in, wait for completion */
+    BOOL dma_transfer_timeout = FALSE;
+    dma_smartcard_init_transfer(SMARTCARD_SERCOM, smartcard_lowlevel_card_image, nb_bytes_total_read);
+    timer_start_timer(TIMER_SMARTCARD_TIMEOUT, CARD_DMA_READ_TIMEOUT);
+    while (dma_smartcard_check_and_clear_dma_transfer_flag() == FALSE)
+    {
+        if (timer_has_timer_expired(TIMER_SMARTCARD_TIMEOUT, TRUE) == TIMER_EXPIRED)
         {
-            *(data_to_receive++) = data_byte;
+            dma_transfer_timeout = TRUE;
+            break;
         }
     }
+    
+    /* DMA transfer stuck: stop it, reset the card address counter and read the bytes ourselves */
+    if (dma_transfer_timeout != FALSE)
+    {
+        dma_smartcard_disable_transfer();
+        smartcard_lowlevel_set_pgmrst_signals();
+        smartcard_lowlevel_clear_pgmrst_signals();
+        while ((SMARTCARD_SERCOM->SPI.INTFLAG.reg & SERCOM_SPI_INTFLAG_RXC) != 0)
+        {
+            (void)SMARTCARD_SERCOM->SPI.DATA.reg;
+        }
+        for (uint16_t i = 0; i < nb_bytes_total_read; i++)
+        {
+            smartcard_lowlevel_card_image[i] = sercom_spi_send_single_byte(SMARTCARD_SERCOM, 0x00);
+        }
+    }
+#else
+    for (uint16_t i = 0; i < nb_bytes_total_read; i++)
+    {
+        smartcard_lowlevel_card_image[i] = sercom_spi_send_single_byte(SMARTCARD_SERCOM, 0x00);
+    }
+#endif
 
     /* Set PGM / RST signals to standby mode */
     smartcard_lowlevel_set_pgmrst_signals();
+    
+    /* Bytes after the ones we just read are still valid */
+    if (nb_bytes_total_read > smartcard_lowlevel_card_image_length)
+    {
+        smartcard_lowlevel_card_image_length = nb_bytes_total_read;
+    }
+}
 
-    return return_val;
+/*! \fn     smartcard_lowlevel_get_card_image_bytes(uint16_t nb_bytes_total_read, uint16_t start_record_index)
+*   \brief  Make sure the requested bytes are in our image, reading the card if required
+*   \param  nb_bytes_total_read     The number of bytes to be read, clamped to the card size
+*   \param  start_record_index      The index at which we start recording the answer
+*   \return Number of bytes to be used, starting at smartcard_lowlevel_card_image[start_record_index]
+*   \note   smartcard_lowlevel_clear_card_secret_zones() must be called once done with the bytes
+*/
+static uint16_t smartcard_lowlevel_get_card_image_bytes(uint16_t nb_bytes_total_read, uint16_t start_record_index)
+{
+    if (nb_bytes_total_read > SMARTCARD_BYTE_LENGTH)
+    {
+        nb_bytes_total_read = SMARTCARD_BYTE_LENGTH;
+    }
+    if (start_record_index >= nb_bytes_total_read)
+    {
+        return 0;
+    }
+    
+    /* Secret zones are never kept in our image: always fetch them from the card */
+    BOOL is_secret_zone = FALSE;
+    if (((start_record_index < SMARTCARD_SC_BYTE_END) && (nb_bytes_total_read > SMARTCARD_SC_BYTE_START)) || ((start_record_index < SMARTCARD_AZ_BYTE_END) && (nb_bytes_total_read > SMARTCARD_AZ_BYTE_START)))
+    {
+        is_secret_zone = TRUE;
+    }
+    
+    /* Read the card if needed */
+    if ((is_secret_zone != FALSE) || (nb_bytes_total_read > smartcard_lowlevel_card_image_length))
+    {
+        smartcard_lowlevel_fill_card_image(nb_bytes_total_read);
+    }
+    
+    return nb_bytes_total_read - start_record_index;
+}
+
+/*! \fn     smartcard_lowlevel_clear_card_secret_zones(void)
+*   \brief  Clear the security code and application zones from our smartcard image
+*/
+static void smartcard_lowlevel_clear_card_secret_zones(void)
+{
+    memset(&smartcard_lowlevel_card_image[SMARTCARD_SC_BYTE_START], 0, SMARTCARD_SC_BYTE_END - SMARTCARD_SC_BYTE_START);
+    memset(&smartcard_lowlevel_card_image[SMARTCARD_AZ_BYTE_START], 0, SMARTCARD_AZ_BYTE_END - SMARTCARD_AZ_BYTE_START);
+}
+
+/*! \fn     smartcard_lowlevel_read_smc(uint16_t nb_bytes_total_read, uint16_t start_record_index, uint8_t* data_to_receive)
+*   \brief  Read bytes from the smart card
+*   \param  nb_bytes_total_read     The number of bytes to be read
+*   \param  start_record_index      The index at which we start recording the answer
+*   \param  data_to_receive        Pointer to the buffer
+*   \return The buffer
+*   \note   Non secret bytes are served from our image of the card memory when possible
+*/
+uint8_t* smartcard_lowlevel_read_smc(uint16_t nb_bytes_total_read, uint16_t start_record_index, uint8_t* data_to_receive)
+{
+    uint16_t nb_bytes_to_copy = smartcard_lowlevel_get_card_image_bytes(nb_bytes_total_read, start_record_index);
+    
+    /* Copy bytes then clear secret ones */
+    memcpy(data_to_receive, &smartcard_lowlevel_card_image[start_record_index], nb_bytes_to_copy);
+    smartcard_lowlevel_clear_card_secret_zones();
+
+    return data_to_receive;
 }
 
 /*! \fn     smartcard_lowlevel_check_for_const_val_in_smc_array(uint16_t nb_bytes_total_read, uint16_t start_record_index, uint8_t value)
@@ -613,33 +739,23 @@ uint8_t* smartcard_lowlevel_read_smc(uint16_t nb_bytes_total_read, uint16_t star
 */
 RET_TYPE smartcard_lowlevel_check_for_const_val_in_smc_array(uint16_t nb_bytes_total_read, uint16_t start_record_index, uint8_t value)
 {
-    uint16_t i;
-
-    /* Set PGM / RST signals for operation */
-    smartcard_lowlevel_clear_pgmrst_signals();
-
-    for(i = 0; i < nb_bytes_total_read; i++)
+    uint16_t nb_bytes_to_check = smartcard_lowlevel_get_card_image_bytes(nb_bytes_total_read, start_record_index);
+    RET_TYPE return_val = RETURN_OK;
+    
+    /* Perform check */
+    for (uint16_t i = 0; i < nb_bytes_to_check; i++)
     {
-        /* Start transmission */
-        uint8_t data_byte = sercom_spi_send_single_byte(SMARTCARD_SERCOM, 0x00);
-
-        /* Store data in buffer or discard it*/
-        if (i >= start_record_index)
+        if (smartcard_lowlevel_card_image[start_record_index + i] != value)
         {
-            /* Perform check */
-            if (data_byte != value)
-            {
-                smartcard_lowlevel_set_pgmrst_signals();
-                return RETURN_NOK;
-            } 
+            return_val = RETURN_NOK;
+            break;
         }
     }
-
-    /* Set PGM / RST signals to standby mode */
-    smartcard_lowlevel_set_pgmrst_signals();
-
-    /* If we got there it means the comparison was OK */
-    return RETURN_OK;
+    
+    /* Clear secret bytes */
+    smartcard_lowlevel_clear_card_secret_zones();
+    
+    return return_val;
 }
 
 /*! \fn     smartcard_low_level_is_smc_absent(void)
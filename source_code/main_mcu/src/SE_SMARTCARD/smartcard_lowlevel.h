@@ -32,6 +32,7 @@ typedef enum    {MAN_FUSE = 0, EC2EN_FUSE = 1, ISSUER_FUSE = 2} card_fuse_type_t
 /* Defines */
 #define CARD_DELAY_FOR_PULLUP_SWITCH    150
 #define CARD_DELAY_FOR_DETECTION        350
+#define CARD_DMA_READ_TIMEOUT           50
 
 // Prototypes
 RET_TYPE smartcard_lowlevel_check_for_const_val_in_smc_array(uint16_t nb_bytes_total_read, uint16_t start_record_index, uint8_t value);
@@ -66,5 +67,10 @@ void smartcard_lowlevel_detect(void);
 #define SMARTCARD_MTP_LOGIN_OFFSET  (SMARTCARD_AZ2_BIT_RESERVED + AES_KEY_LENGTH)
 #define SMARTCARD_ISSUER_ZONE_LGTH  8
 #define SMARTCARD_CPZ_LENGTH        8
+#define SMARTCARD_BYTE_LENGTH       (1568/8)
+#define SMARTCARD_SC_BYTE_START     (80/8)
+#define SMARTCARD_SC_BYTE_END       (96/8)
+#define SMARTCARD_AZ_BYTE_START     (SMARTCARD_AZ1_BIT_START/8)
+#define SMARTCARD_AZ_BYTE_END       (1280/8)
 
 #endif /* SMARTCARD_H_ */
@@ -48,6 +48,9 @@ volatile timerEntry_t context_timers[TOTAL_NUMBER_OF_TIMERS];
 volatile BOOL timer_systick_expired = TRUE;
 /* System tick */
 volatile uint32_t sysTick;
+/* Deadline at which the ms tick posts a timer event to the main loop */
+volatile uint32_t timer_event_deadline;
+volatile BOOL timer_event_deadline_armed = FALSE;
 /* timestamp set at the last "set date" message */
 uint32_t timer_last_set_timestamp = 0;
 /* Default value for 32K oscillator calibration */
@@ -155,6 +158,7 @@ void TC3_Handler(void)
         
         /* Set to be logged off flag */
         logic_user_set_user_to_be_logged_off_flag();
+        main_post_event(MAIN_EVENT_TIMER);
     }
     #endif    
 }
@@ -610,39 +614,181 @@ void driver_timer_set_rtc_timestamp(uint16_t year, uint16_t month, uint16_t day,
 
 /*!	\fn		timer_ms_tick(void)
 *	\brief	Function called by interrupt every ms
+*   \note   Timers store absolute deadlines, expiry is evaluated when they are polled
 */
 void timer_ms_tick(void)
 {
-    uint32_t i;
     sysTick++;
     
-    // Loop through the timers
-    for (i = 0; i < TOTAL_NUMBER_OF_TIMERS; i++)
+    #ifndef BOOTLOADER
+    /* Wake up the main loop when the next timer expires */
+    if ((timer_event_deadline_armed != FALSE) && ((int32_t)(sysTick - timer_event_deadline) >= 0))
+    {
+        timer_event_deadline_armed = FALSE;
+        main_post_event(MAIN_EVENT_TIMER);
+    }
+    
+    /* Periodic wakeup for what the main loop still polls */
+    if ((sysTick % MAIN_LOOP_PERIODIC_EVENT_MS) == 0)
+    {
+        main_post_event(MAIN_EVENT_PERIODIC);
+    }
+    #endif
+    
+    #ifdef EMULATOR_BUILD
+    timer_emulator_fake_rtc_cnt++;
+    #endif
+}
+
+/*!	\fn		timer_update_timer_entry(volatile timerEntry_t* entry)
+*	\brief	Set the expired flag of a timer whose deadline was reached
+*   \param  entry   Pointer to the timer entry
+*/
+static void timer_update_timer_entry(volatile timerEntry_t* entry)
+{
+    cpu_irq_enter_critical();
+    
+    // Signed difference to cope with sysTick wrapping
+    if ((entry->armed != FALSE) && ((int32_t)(sysTick - entry->deadline) >= 0))
+    {
+        entry->armed = FALSE;
+        entry->flag = TIMER_EXPIRED;
+    }
+    
+    cpu_irq_leave_critical();
+}
+
+/*!	\fn		timer_get_timer_entry_remaining_ms(volatile timerEntry_t* entry)
+*	\brief	Get the number of ms before a timer expires
+*   \param  entry   Pointer to the timer entry
+*   \return Remaining ms, 0 if not armed or expired
+*/
+static uint32_t timer_get_timer_entry_remaining_ms(volatile timerEntry_t* entry)
+{
+    timer_update_timer_entry(entry);
+    
+    if (entry->armed == FALSE)
+    {
+        return 0;
+    }
+    else
+    {
+        return entry->deadline - sysTick;
+    }
+}
+
+/*!	\fn		timer_arm_timer_entry(volatile timerEntry_t* entry, uint32_t val)
+*	\brief	Arm a timer entry
+*   \param  entry   Pointer to the timer entry
+*   \param  val     Delay in ms
+*/
+static void timer_arm_timer_entry(volatile timerEntry_t* entry, uint32_t val)
+{
+    // Same behavior as the previous countdown implementation: only rearm if the remaining time differs
+    if (timer_get_timer_entry_remaining_ms(entry) != val)
     {
-        if (context_timers[i].timer_val != 0)
+        cpu_irq_enter_critical();
+        
+        entry->deadline = sysTick + val;
+        if (val == 0)
         {
-            if (context_timers[i].timer_val-- == 1)
-            {
-                context_timers[i].flag = TIMER_EXPIRED;
-            }
+            entry->armed = FALSE;
+            entry->flag = TIMER_EXPIRED;
         }
+        else
+        {
+            entry->armed = TRUE;
+            entry->flag = TIMER_RUNNING;
+        }
+        
+        cpu_irq_leave_critical();
     }
+}
+
+/*!	\fn		timer_has_timer_entry_expired(volatile timerEntry_t* entry, BOOL clear)
+*	\brief	Know if a timer expired and clear the flag if so
+*   \param  entry   Pointer to the timer entry
+*   \param  clear   Boolean to say if we clear the flag
+*   \return TIMER_EXPIRED or TIMER_RUNNING (see enum)
+*/
+static timer_flag_te timer_has_timer_entry_expired(volatile timerEntry_t* entry, BOOL clear)
+{
+    #ifdef EMULATOR_HEADLESS_BUILD
+    emu_timer_poll();
+    #endif
+    
+    timer_update_timer_entry(entry);
+    
+    if (entry->flag == TIMER_EXPIRED)
+    {
+        if (clear == TRUE)
+        {
+            entry->flag = TIMER_RUNNING;
+        }
+        return TIMER_EXPIRED;
+    }
+    else
+    {
+        return TIMER_RUNNING;
+    }
+}
+
+/*!	\fn		timer_get_ms_to_next_deadline(void)
+*	\brief	Get the number of ms until the next timer deadline
+*   \return Number of ms, 0 if a deadline was already reached, TIMER_NO_DEADLINE if no timer is armed
+*   \note   The 1ms tick isn't stopped: it also scans the inputs, and doesn't run in standby
+*/
+static uint32_t timer_get_ms_to_next_deadline(void)
+{
+    uint32_t next_deadline = TIMER_NO_DEADLINE;
+    
+    cpu_irq_enter_critical();
+    uint32_t current_systick = sysTick;
     
-    // Loop through the allocated timers
-    for (i = 0; i < NUMBER_OF_ALLOCATABLE_TIMERS; i++)
+    for (uint16_t i = 0; i < TOTAL_NUMBER_OF_TIMERS + NUMBER_OF_ALLOCATABLE_TIMERS; i++)
     {
-        if (context_allocatable_timers[i].timer_val != 0)
+        volatile timerEntry_t* entry = (i < TOTAL_NUMBER_OF_TIMERS)? &context_timers[i] : &context_allocatable_timers[i - TOTAL_NUMBER_OF_TIMERS].timer;
+        
+        if (entry->armed != FALSE)
         {
-            if (context_allocatable_timers[i].timer_val-- == 1)
+            int32_t remaining = (int32_t)(entry->deadline - current_systick);
+            
+            if (remaining <= 0)
+            {
+                next_deadline = 0;
+                break;
+            }
+            else if ((uint32_t)remaining < next_deadline)
             {
-                context_allocatable_timers[i].flag = TIMER_EXPIRED;
+                next_deadline = (uint32_t)remaining;
             }
         }
     }
     
-    #ifdef EMULATOR_BUILD
-    timer_emulator_fake_rtc_cnt++;
-    #endif
+    cpu_irq_leave_critical();
+    return next_deadline;
+}
+
+/*!	\fn		timer_arm_next_deadline_event(void)
+*	\brief	Arm the ms tick to post a timer event to the main loop when the earliest armed timer expires
+*/
+void timer_arm_next_deadline_event(void)
+{
+    uint32_t ms_to_next_deadline = timer_get_ms_to_next_deadline();
+    
+    cpu_irq_enter_critical();
+    
+    if (ms_to_next_deadline == TIMER_NO_DEADLINE)
+    {
+        timer_event_deadline_armed = FALSE;
+    }
+    else
+    {
+        timer_event_deadline = sysTick + ms_to_next_deadline;
+        timer_event_deadline_armed = TRUE;
+    }
+    
+    cpu_irq_leave_critical();
 }
 
 #ifndef EMULATOR_BUILD
@@ -714,6 +860,9 @@ BOOL timer_get_mcu_systick(uint32_t* value)
 */
 uint32_t timer_get_systick(void)
 {
+    #ifdef EMULATOR_HEADLESS_BUILD
+    emu_timer_poll();
+    #endif
     return sysTick;
 }
 
@@ -725,19 +874,7 @@ uint32_t timer_get_systick(void)
 */
 timer_flag_te timer_has_timer_expired(timer_id_te uid, BOOL clear)
 {
-    // Compare & write is done in one cycle
-    if (context_timers[uid].flag == TIMER_EXPIRED)
-    {
-        if (clear == TRUE)
-        {
-            context_timers[uid].flag = TIMER_RUNNING;
-        }
-        return TIMER_EXPIRED;
-    }
-    else
-    {
-        return TIMER_RUNNING;
-    }
+    return timer_has_timer_entry_expired(&context_timers[uid], clear);
 }
 
 /*! \fn     timer_has_allocated_timer_expired(uint16_t uid, BOOL clear)
@@ -754,19 +891,7 @@ timer_flag_te timer_has_allocated_timer_expired(uint16_t uid, BOOL clear)
         main_reboot();
     }
     
-    // Compare & write is done in one cycle
-    if (context_allocatable_timers[uid].flag == TIMER_EXPIRED)
-    {
-        if (clear == TRUE)
-        {
-            context_allocatable_timers[uid].flag = TIMER_RUNNING;
-        }
-        return TIMER_EXPIRED;
-    }
-    else
-    {
-        return TIMER_RUNNING;
-    }
+    return timer_has_timer_entry_expired(&context_allocatable_timers[uid].timer, clear);
 }
 
 /*! \fn     timer_rearm_allocated_timer(uint16_t uid, BOOL clear)
@@ -782,23 +907,7 @@ void timer_rearm_allocated_timer(uint16_t uid, uint32_t val)
         main_reboot();
     }
     
-    // Compare is done in one cycle
-    if (context_allocatable_timers[uid].timer_val != val)
-    {
-        cpu_irq_enter_critical();
-        
-        context_allocatable_timers[uid].timer_val = val;
-        if (val == 0)
-        {
-            context_allocatable_timers[uid].flag = TIMER_EXPIRED;
-        }
-        else
-        {
-            context_allocatable_timers[uid].flag = TIMER_RUNNING;
-        }
-        
-        cpu_irq_leave_critical();
-    }
+    timer_arm_timer_entry(&context_allocatable_timers[uid].timer, val);
 }
 
 /*! \fn     timer_get_and_start_timer(uint32_t val)
@@ -815,23 +924,7 @@ uint16_t timer_get_and_start_timer(uint32_t val)
         /* Check for allocation */
         if (context_allocatable_timers[i].allocated == FALSE)
         {
-            // Compare is done in one cycle
-            if (context_allocatable_timers[i].timer_val != val)
-            {
-                cpu_irq_enter_critical();
-                
-                context_allocatable_timers[i].timer_val = val;
-                if (val == 0)
-                {
-                    context_allocatable_timers[i].flag = TIMER_EXPIRED;
-                }
-                else
-                {
-                    context_allocatable_timers[i].flag = TIMER_RUNNING;
-                }
-                
-                cpu_irq_leave_critical();
-            }
+            timer_arm_timer_entry(&context_allocatable_timers[i].timer, val);
             
             /* Set allocated flag, return uid */
             context_allocatable_timers[i].allocated = TRUE;
@@ -856,8 +949,9 @@ void timer_deallocate_timer(uint16_t timer_id)
         main_reboot();
     }
     
-    // Reset flag
+    // Reset flag, disarm so that it isn't reported as a deadline
     context_allocatable_timers[timer_id].allocated = FALSE;
+    context_allocatable_timers[timer_id].timer.armed = FALSE;
 }
 
 /*!	\fn		timer_start_timer(timer_id_te uid, uint32_t val)
@@ -867,23 +961,7 @@ void timer_deallocate_timer(uint16_t timer_id)
 */
 void timer_start_timer(timer_id_te uid, uint32_t val)
 {    
-    // Compare is done in one cycle
-    if (context_timers[uid].timer_val != val)
-    {
-        cpu_irq_enter_critical();
-        
-        context_timers[uid].timer_val = val;
-        if (val == 0)
-        {
-            context_timers[uid].flag = TIMER_EXPIRED;
-        }
-        else
-        {
-            context_timers[uid].flag = TIMER_RUNNING;
-        }
-        
-        cpu_irq_leave_critical();
-    }
+    timer_arm_timer_entry(&context_timers[uid], val);
 }
 
 /*!	\fn		timer_get_timer_val(timer_id_te uid)
@@ -893,7 +971,7 @@ void timer_start_timer(timer_id_te uid, uint32_t val)
 */
 uint32_t timer_get_timer_val(timer_id_te uid)
 {
-    return context_timers[uid].timer_val;
+    return timer_get_timer_entry_remaining_ms(&context_timers[uid]);
 }
 
 /*!	\fn		timer_delay_ms(uint32_t ms)
@@ -31,14 +31,14 @@
 /* Structs */
 typedef struct
 {
-    uint32_t timer_val;
+    uint32_t deadline;      // sysTick value at which the timer expires
     uint32_t flag;
+    BOOL armed;             // deadline not reached yet
 } timerEntry_t;
 
 typedef struct
 {
-    uint32_t timer_val;
-    uint32_t flag;
+    timerEntry_t timer;
     BOOL allocated;
 } allocatedTimerEntry_t;
 
@@ -66,11 +66,20 @@ typedef enum {  TIMER_WAITING_FUNCT = 0,
                 TIMER_AUX_MCU_PING = 9,
                 TIMER_ACC_WATCHDOG = 10,
                 TIMER_I2C_TIMEOUT = 11,
+                TIMER_SMARTCARD_TIMEOUT = 12,
                 TOTAL_NUMBER_OF_TIMERS} timer_id_te;
 typedef enum {TIMER_EXPIRED = 0, TIMER_RUNNING = 1} timer_flag_te;
+
+/* Defines */
+#define TIMER_NO_DEADLINE           UINT32_MAX
     
 /* Macros */
-#ifdef EMULATOR_BUILD
+#if defined(EMULATOR_HEADLESS_BUILD)
+#include "emulator.h"
+#define DELAYUS(us)                 emu_delay_us(us)
+#define DELAYMS(ms)                 emu_delay_us((ms)*1000)
+#define DELAYMS_8M(ms)              emu_delay_us((ms)*1000)
+#elif defined(EMULATOR_BUILD)
 #include <unistd.h>
 #define DELAYUS(us)                 usleep(us)
 #define DELAYMS(ms)                 usleep((ms)*1000)
@@ -112,6 +121,7 @@ void timer_start_timer(timer_id_te uid, uint32_t val);
 uint64_t driver_timer_get_rtc_timestamp_uint64t(void);
 uint32_t driver_timer_get_rtc_timestamp_uint32t(void);
 void timer_arm_inactivity_timer(uint16_t nb_minutes);
+void timer_arm_next_deadline_event(void);
 void timer_wait_for_aux_tx_flood_protection(void);
 uint16_t timer_get_and_start_timer(uint32_t val);
 void timer_deallocate_timer(uint16_t timer_id);
@@ -596,6 +596,7 @@ void debug_battery_recondition(void)
                     }
                 }
             }
+            oled_mark_frame_buffer_dirty(&plat_oled_descriptor, 0, 0, OLED_WIDTH, OLED_HEIGHT);
             oled_flush_frame_buffer(&plat_oled_descriptor);
         #else
             for (uint16_t i = GUI_ANIMATION_FFRAME_ID; i < GUI_ANIMATION_NBFRAMES; i++)
@@ -53,6 +53,14 @@ BOOL main_adc_watchdog_fired = FALSE;
 BOOL main_acc_watchdog_fired = FALSE;
 /* Know if debugger is present */
 BOOL debugger_present = FALSE;
+/* Events posted by interrupts, all set at boot so that the main loop runs its first iteration */
+volatile uint32_t main_pending_events = MAIN_ALL_EVENTS_MASK;
+/* Main loop statistics, for debug */
+main_loop_stats_t main_loop_stats;
+#ifndef EMULATOR_BUILD
+/* Last known number of bytes remaining for the aux MCU RX DMA transfer */
+uint16_t main_last_aux_rx_remaining_bytes = 0;
+#endif
 #ifndef EMULATOR_BUILD
 /* Start of stack as defined by linker */
 extern uint32_t _estack;
@@ -765,7 +773,112 @@ void main_standby_sleep(void)
     
         /* Clear wheel detection */
         inputs_clear_detections();
+        
+        /* Let the main loop deal with everything that happened while sleeping */
+        cpu_irq_enter_critical();
+        main_pending_events = MAIN_ALL_EVENTS_MASK;
+        cpu_irq_leave_critical();
+    }
+#endif
+}
+
+/*! \fn     main_post_event(main_event_te event)
+*   \brief  Post an event for the main loop, may be called by interrupt
+*   \param  event   The event
+*/
+void main_post_event(main_event_te event)
+{
+    cpu_irq_enter_critical();
+    main_pending_events |= (1UL << event);
+    cpu_irq_leave_critical();
+}
+
+/*! \fn     main_get_and_clear_pending_events(void)
+*   \brief  Fetch and clear the events posted since the last call
+*   \return Bitmask of main_event_te
+*/
+uint32_t main_get_and_clear_pending_events(void)
+{
+    cpu_irq_enter_critical();
+    uint32_t pending_events = main_pending_events;
+    main_pending_events = 0;
+    cpu_irq_leave_critical();
+    
+    /* Update stats */
+    for (uint16_t i = 0; i < MAIN_NUMBER_OF_EVENTS; i++)
+    {
+        if ((pending_events & (1UL << i)) != 0)
+        {
+            main_loop_stats.event_wakeup_counters[i]++;
+        }
+    }
+    
+#ifdef EMULATOR_BUILD
+    /* Emulated peripherals are polled, not interrupt driven */
+    pending_events = MAIN_ALL_EVENTS_MASK;
+#endif
+    return pending_events;
+}
+
+/*! \fn     main_get_loop_stats(main_loop_stats_t* stats_pt)
+*   \brief  Get main loop statistics
+*   \param  stats_pt    Where to store the statistics
+*/
+void main_get_loop_stats(main_loop_stats_t* stats_pt)
+{
+    memcpy(stats_pt, &main_loop_stats, sizeof(main_loop_stats));
+}
+
+/*! \fn     main_aux_rx_progressed(void)
+*   \brief  Check if the aux MCU RX DMA received bytes since the last call
+*   \return TRUE if bytes were received
+*   \note   The aux MCU RX DMA doesn't interrupt us until the end of the transfer
+*/
+static BOOL main_aux_rx_progressed(void)
+{
+#ifndef EMULATOR_BUILD
+    uint16_t aux_rx_remaining_bytes = dma_aux_mcu_get_remaining_bytes_for_rx_transfer();
+    if (aux_rx_remaining_bytes != main_last_aux_rx_remaining_bytes)
+    {
+        main_last_aux_rx_remaining_bytes = aux_rx_remaining_bytes;
+        return TRUE;
+    }
+#endif
+    return FALSE;
+}
+
+/*! \fn     main_idle_sleep(void)
+*   \brief  Sleep until the next interrupt if no event is pending
+*   \note   Normal sleep: clocks, DMA and the 1ms tick keep running
+*/
+void main_idle_sleep(void)
+{
+#ifndef EMULATOR_BUILD
+    if (debugger_present != FALSE)
+    {
+        return;
     }
+    
+    /* Check for a partially received aux MCU packet */
+    if (main_aux_rx_progressed() != FALSE)
+    {
+        main_post_event(MAIN_EVENT_AUX_COMMS);
+        return;
+    }
+    
+    /* Get a timer event when the next timer expires */
+    timer_arm_next_deadline_event();
+    
+    /* Errata 10416 doesn't apply to normal sleep, pending interrupts wake us up even when masked */
+    cpu_irq_enter_critical();
+    if (main_pending_events == 0)
+    {
+        main_loop_stats.nb_idle_entries++;
+        SCB->SCR = 0;
+        __DSB();
+        __WFI();
+    }
+    cpu_irq_leave_critical();
 #endif
 }
 
@@ -833,9 +946,31 @@ int main(void)
         gui_dispatcher_get_back_to_current_screen();
     }
     
+    /* Run one more iteration after the last one that had events, as the main loop sets flags for itself */
+    BOOL run_trailing_iteration = TRUE;
+    
     /* Infinite loop */
     while(TRUE)
     {
+        /* Fetch events posted by interrupts */
+        uint32_t pending_events = main_get_and_clear_pending_events();
+        
+        /* Nothing happened: sleep until the next interrupt */
+        if (pending_events == 0)
+        {
+            if (run_trailing_iteration == FALSE)
+            {
+                main_idle_sleep();
+                continue;
+            }
+            run_trailing_iteration = FALSE;
+        }
+        else
+        {
+            run_trailing_iteration = TRUE;
+        }
+        main_loop_stats.nb_loop_iterations++;
+        
         /* Power routine */
         logic_power_routine();
         
@@ -903,7 +1038,15 @@ int main(void)
             /* Set next screen */
             gui_dispatcher_set_current_screen(GUI_SCREEN_MAIN_MENU, TRUE, GUI_INTO_MENU_TRANSITION);
             gui_dispatcher_get_back_to_current_screen();
+            nodemgmt_trigger_db_ext_changed_actions();
             nodemgmt_scan_node_usage();
+            dbflash_flush_cache(&dbflash_descriptor);
+        }
+        
+        /* Outside of management mode, database changes are written back once the current operation is done */
+        if (logic_security_is_management_mode_set() == FALSE)
+        {
+            dbflash_flush_cache(&dbflash_descriptor);
         }
         
         /* Do not do anything if we're uploading new graphics contents */
@@ -1067,8 +1210,16 @@ int main(void)
             virtual_wheel_action = WHEEL_ACTION_NONE;      
         }
         
-        /* Communications */
-        if (gui_dispatcher_get_current_screen() != GUI_SCREEN_FW_FILE_UPDATE)
+        /* Communications: also check for a partially received packet, as the loop may be kept busy by other events */
+        if (main_aux_rx_progressed() != FALSE)
+        {
+            pending_events |= (1UL << MAIN_EVENT_AUX_COMMS);
+        }
+        if ((pending_events & (1UL << MAIN_EVENT_AUX_COMMS)) == 0)
+        {
+            /* Nothing received */
+        }
+        else if (gui_dispatcher_get_current_screen() != GUI_SCREEN_FW_FILE_UPDATE)
         {
             comms_aux_mcu_routine(MSG_NO_RESTRICT);
         }
@@ -1093,7 +1244,11 @@ int main(void)
         /* Accelerometer routine */
         BOOL is_screen_on_copy = oled_is_oled_on(&plat_oled_descriptor);
         BOOL is_screen_saver_on_copy = gui_dispatcher_is_screen_saver_running();
-        acc_detection_te accelerometer_routine_return = logic_accelerometer_routine();
+        acc_detection_te accelerometer_routine_return = ACC_DET_NOTHING;
+        if ((pending_events & (1UL << MAIN_EVENT_ACC)) != 0)
+        {
+            accelerometer_routine_return = logic_accelerometer_routine();
+        }
         if (accelerometer_routine_return == ACC_FAILING)
         {
             /* Accelerometer failing */
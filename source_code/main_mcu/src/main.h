@@ -29,13 +29,39 @@
 #include "oled_wrapper.h"
 #include "acc_wrapper.h"
 
+/* Enums */
+// Events posted by interrupts to wake up the main loop
+typedef enum {  MAIN_EVENT_TIMER = 0,           // a timer deadline was reached
+                MAIN_EVENT_AUX_COMMS = 1,       // data received from aux MCU
+                MAIN_EVENT_ACC = 2,             // accelerometer data received
+                MAIN_EVENT_INPUTS = 3,          // wheel moved or clicked
+                MAIN_EVENT_SMARTCARD = 4,       // smartcard inserted or removed
+                MAIN_EVENT_ADC = 5,             // battery conversion result ready
+                MAIN_EVENT_PERIODIC = 6,        // periodic wakeup, for everything that is still polled
+                MAIN_NUMBER_OF_EVENTS} main_event_te;
+
+/* Defines */
+#define MAIN_ALL_EVENTS_MASK    ((1UL << MAIN_NUMBER_OF_EVENTS) - 1)
+
+/* Structs */
+typedef struct
+{
+    uint32_t nb_loop_iterations;
+    uint32_t nb_idle_entries;
+    uint32_t event_wakeup_counters[MAIN_NUMBER_OF_EVENTS];
+} main_loop_stats_t;
+
 
 /* Prototypes */
 void main_create_virtual_wheel_movement(void);
+void main_get_loop_stats(main_loop_stats_t* stats_pt);
+uint32_t main_get_and_clear_pending_events(void);
+void main_post_event(main_event_te event);
 uint32_t main_check_stack_usage(void);
 void main_init_stack_tracking(void);
 void main_platform_init(void);
 void main_standby_sleep(void);
+void main_idle_sleep(void);
 void main_reboot(void);
 
 /* Global vars to access descriptors */
@@ -446,6 +446,7 @@ typedef struct
 #define SCREEN_TIMEOUT_MS_BAT_PWRD  7654
 #define AUX_FLOOD_TIMEOUT_MS        1
 #define SLEEP_AFTER_AUX_WAKEUP_MS   1234
+#define MAIN_LOOP_PERIODIC_EVENT_MS 20
 
 /********************/
 /* Voltage cutout   */
@@ -522,6 +523,14 @@ typedef struct
 #ifndef BOOTLOADER
     #define OLED_INTERNAL_FRAME_BUFFER
 #endif
+/* Cache glyph headers & bitmaps for text rendering */
+#ifndef BOOTLOADER
+    #define OLED_GLYPH_CACHE
+#endif
+/* Use a write-back RAM page cache in front of the database flash */
+#ifndef BOOTLOADER
+    #define DBFLASH_PAGE_CACHE
+#endif
 /* allow printf for the screen */
 //#define OLED_PRINTF_ENABLED
 /* Allow debug USB commands */
@@ -656,6 +665,8 @@ typedef struct
 #define DMA_DESCID_TX_OLED          4
 #define DMA_DESCID_RX_ACC           5
 #define DMA_DESCID_TX_COMMS         6
+#define DMA_DESCID_RX_SMC           7
+#define DMA_DESCID_TX_SMC           8
 
 /* External interrupts numbers */
 #if IS_V1_PLAT_IN_RANGE_1_TO_2
@@ -705,6 +716,8 @@ typedef struct
     #define ACC_DMA_SERCOM_TXTRIG           0x04
     #define AUX_MCU_SERCOM_RXTRIG           0x09
     #define AUX_MCU_SERCOM_TXTRIG           0x0A
+    #define SMARTCARD_DMA_SERCOM_RXTRIG     0x0B
+    #define SMARTCARD_DMA_SERCOM_TXTRIG     0x0C
 #elif IS_V1_PLAT_IN_RANGE_3_TO_7
     #define DATAFLASH_DMA_SERCOM_RXTRIG     0x07
     #define DATAFLASH_DMA_SERCOM_TXTRIG     0x08
@@ -714,6 +727,8 @@ typedef struct
     #define ACC_DMA_SERCOM_TXTRIG           0x02
     #define AUX_MCU_SERCOM_RXTRIG           0x0B
     #define AUX_MCU_SERCOM_TXTRIG           0x0C
+    #define SMARTCARD_DMA_SERCOM_RXTRIG     0x05
+    #define SMARTCARD_DMA_SERCOM_TXTRIG     0x06
 #elif defined(V2_PLAT_V1_SETUP)
     #define DATAFLASH_DMA_SERCOM_RXTRIG     0x05
     #define DATAFLASH_DMA_SERCOM_TXTRIG     0x06